@@ -5,11 +5,10 @@
 
 #include "aboutdialog.h"
 #include "ui_aboutdialog.h"
-#include "helperutils.h"
+#include "hashcatrunner.h"
 #include "settingsmanager.h"
 #include <QMessageBox>
 #include <QFileInfo>
-#include <QFutureWatcher>
 
 AboutDialog::AboutDialog(QWidget *parent)
     : QDialog(parent)
@@ -39,20 +38,14 @@ void AboutDialog::updateVersionLabel()
     if (!settings.getKey<QString>("hashcatPath").isEmpty()) {
         ui->label_hc_version_text->setText(fileInfo.fileName());
 
-        QFutureWatcher<HashcatResult> *watcher = new QFutureWatcher<HashcatResult>(this);
-        connect(watcher, &QFutureWatcher<HashcatResult>::finished, this, [this, watcher]() {
-            const HashcatResult &result = watcher->result();
-
+        HashcatRunner *runner = HashcatRunner::run(QStringList() << "--version", this);
+        connect(runner, &HashcatRunner::finished, this, [this](const HashcatResult &result) {
             if (result.exitStatus != QProcess::NormalExit || result.exitCode != 0) {
                 ui->label_hc_version->setText(tr("Error: %1").arg(result.standardError.simplified()));
             } else {
                 ui->label_hc_version->setText(result.standardOutput.simplified());
             }
-
-            watcher->deleteLater();
         });
-
-        watcher->setFuture(HelperUtils::executeHashcat(QStringList() << "--version"));
     }
 
     ui->label_hc_gui_version->setText(QApplication::applicationVersion());
@@ -0,0 +1,439 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "attackspec.h"
+#include "helperutils.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <tuple>
+
+namespace {
+
+// Attack modes in the order of the attack combobox, older profiles stored the position
+constexpr std::array<quint32, 6> legacyAttackModes = {
+    AttackSpec::Straight, AttackSpec::Combination, AttackSpec::BruteForce,
+    AttackSpec::HybridWordMask, AttackSpec::HybridMaskWord, AttackSpec::Association,
+};
+
+// Profiles written before the spec existed are keyed by widget names
+QJsonValue value(const QJsonObject &json, const QString &key, const QString &legacyKey)
+{
+    return json.contains(key) ? json.value(key) : json.value(legacyKey);
+}
+
+QJsonObject optionToJson(const AttackSpec::Option &option)
+{
+    return QJsonObject { { "enabled", option.enabled }, { "value", option.value } };
+}
+
+AttackSpec::Option optionFromJson(const QJsonObject &json, const QString &key, int index,
+                                  const QString &legacyEnabled, const QString &legacyValue)
+{
+    const QJsonValue entry = json.value(key);
+    if (entry.isArray() || entry.isObject()) {
+        const QJsonObject option = entry.isArray() ? entry.toArray().at(index).toObject() : entry.toObject();
+        return { option.value("enabled").toBool(), option.value("value").toString() };
+    }
+    return { json.value(legacyEnabled).toBool(), json.value(legacyValue).toString() };
+}
+
+} // namespace
+
+bool AttackSpec::usesWordlists() const
+{
+    return attackMode != BruteForce;
+}
+
+bool AttackSpec::usesRules() const
+{
+    return attackMode == Straight || attackMode == Association;
+}
+
+bool AttackSpec::usesMask() const
+{
+    return attackMode == BruteForce || attackMode == HybridWordMask || attackMode == HybridMaskWord;
+}
+
+QStringList AttackSpec::checkedWordlists() const
+{
+    QStringList paths;
+    for (const Wordlist &wordlist : wordlists) {
+        if (wordlist.checked) {
+            paths << wordlist.path;
+        }
+    }
+    return paths;
+}
+
+QStringList AttackSpec::enabledRulesFiles() const
+{
+    QStringList files;
+    if (usesRules() && !generateRules) {
+        for (const Option &rulesFile : rulesFiles) {
+            if (rulesFile.enabled && !rulesFile.value.isEmpty()) {
+                files << rulesFile.value;
+            }
+        }
+    }
+    return files;
+}
+
+QStringList AttackSpec::customCharsetValues() const
+{
+    QStringList values;
+    for (const Option &charset : customCharsets) {
+        values << (charset.enabled ? charset.value : QString());
+    }
+    return values;
+}
+
+QStringList AttackSpec::arguments(const ArgumentOptions &options) const
+{
+    using Parameter = HelperUtils::Parameter;
+
+    const bool useShort = options.useShortParameters;
+    QStringList arguments;
+    QString maskBeforeWordlists;
+    QString maskAfterWordlists;
+
+    arguments << HelperUtils::getParameter(Parameter::HashType, useShort) << QString::number(hashMode);
+    arguments << HelperUtils::getParameter(Parameter::AttackMode, useShort) << QString::number(attackMode);
+
+    if (remove) {
+        arguments << HelperUtils::getParameter(Parameter::Remove, useShort);
+    }
+
+    // Preprocessing already removed the usernames
+    if (ignoreUsername && options.preprocessedHashFile.isEmpty()) {
+        arguments << HelperUtils::getParameter(Parameter::Username, useShort);
+    }
+
+    switch (attackMode) {
+    case Straight:
+    case Association:
+        if (!generateRules) {
+            for (const QString &rulesFile : enabledRulesFiles()) {
+                arguments << HelperUtils::getParameter(Parameter::RulesFile, useShort) << rulesFile;
+            }
+        } else {
+            arguments << HelperUtils::getParameter(Parameter::GenerateRules, useShort) << QString::number(generatedRules);
+        }
+        break;
+    case BruteForce:
+    case HybridMaskWord:
+        maskBeforeWordlists = mask;
+        break;
+    case HybridWordMask:
+        maskAfterWordlists = mask;
+        break;
+    }
+
+    if (speedOnly) {
+        arguments << HelperUtils::getParameter(Parameter::SpeedOnly, useShort);
+    }
+
+    if (overrideWorkloadProfile) {
+        arguments << HelperUtils::getParameter(Parameter::WorkloadProfile, useShort) << QString::number(workloadProfile);
+    }
+
+    if (optimizedKernel) {
+        arguments << HelperUtils::getParameter(Parameter::OptimizedKernel, useShort);
+    }
+
+    if (usesMask()) {
+        static const std::array<Parameter, 4> charsetParameters = {
+            Parameter::CustomCharset1, Parameter::CustomCharset2, Parameter::CustomCharset3, Parameter::CustomCharset4,
+        };
+        for (size_t i = 0; i < customCharsets.size(); ++i) {
+            if (customCharsets[i].enabled && !customCharsets[i].value.isEmpty()) {
+                arguments << HelperUtils::getParameter(charsetParameters[i], useShort) << customCharsets[i].value;
+            }
+        }
+    }
+
+    if (hexCharset) {
+        arguments << HelperUtils::getParameter(Parameter::HexCharset, useShort);
+    }
+
+    if (hexSalt) {
+        arguments << HelperUtils::getParameter(Parameter::HexSalt, useShort);
+    }
+
+    if (outfile.enabled && !outfile.value.isEmpty()) {
+        QString path = outfile.value;
+        path.replace("<unixtime>", QString::number(options.unixTime));
+        path.replace("<hash>", QFileInfo(hashFile).fileName(), Qt::CaseInsensitive);
+        arguments << HelperUtils::getParameter(Parameter::Outfile, useShort) << path;
+    }
+
+    if (outfileFormat != "1,2") {
+        arguments << HelperUtils::getParameter(Parameter::OutfileFormat, useShort) << outfileFormat;
+    }
+
+    if (!cpuAffinity.isEmpty()) {
+        arguments << HelperUtils::getParameter(Parameter::CpuAffinity, useShort) << cpuAffinity;
+    }
+
+    if (!devices.isEmpty() && devices != "0") {
+        // ';' only groups devices for keyspace slicing, hashcat expects a plain list
+        arguments << HelperUtils::getParameter(Parameter::BackendDevices, useShort) << QString(devices).replace(';', ',');
+    }
+
+    if (segmentSize != 32) {
+        arguments << HelperUtils::getParameter(Parameter::SegmentSize, useShort) << QString::number(segmentSize);
+    }
+
+    if (!options.session.isEmpty()) {
+        arguments << HelperUtils::getParameter(Parameter::Session, useShort) << options.session;
+    }
+
+    if (!skip.isEmpty()) {
+        arguments << HelperUtils::getParameter(Parameter::Skip, useShort) << skip;
+    }
+
+    if (!limit.isEmpty()) {
+        arguments << HelperUtils::getParameter(Parameter::Limit, useShort) << limit;
+    }
+
+    if (options.withHashFile && !options.preprocessedHashFile.isEmpty()) {
+        arguments << options.preprocessedHashFile;
+    } else if (options.withHashFile && !hashFile.isEmpty()) {
+        arguments << hashFile;
+    }
+
+    if (!maskBeforeWordlists.isEmpty()) {
+        arguments << maskBeforeWordlists;
+    }
+
+    if (usesWordlists()) {
+        arguments << checkedWordlists();
+    }
+
+    if (!maskAfterWordlists.isEmpty()) {
+        arguments << maskAfterWordlists;
+    }
+
+    return arguments;
+}
+
+QStringList AttackSpec::keyspaceArguments(bool useShortParameters) const
+{
+    using Parameter = HelperUtils::Parameter;
+
+    ArgumentOptions options;
+    options.useShortParameters = useShortParameters;
+    options.withHashFile = false;
+
+    QStringList arguments = this->arguments(options);
+    arguments = HelperUtils::removeParameter(arguments, Parameter::Outfile, true);
+    arguments = HelperUtils::removeParameter(arguments, Parameter::OutfileFormat, true);
+    arguments = HelperUtils::removeParameter(arguments, Parameter::BackendDevices, true);
+    arguments = HelperUtils::removeParameter(arguments, Parameter::CpuAffinity, true);
+    arguments = HelperUtils::removeParameter(arguments, Parameter::Skip, true);
+    arguments = HelperUtils::removeParameter(arguments, Parameter::Limit, true);
+    arguments = HelperUtils::removeParameter(arguments, Parameter::Remove, false);
+    arguments = HelperUtils::removeParameter(arguments, Parameter::Username, false);
+    arguments = HelperUtils::removeParameter(arguments, Parameter::SpeedOnly, false);
+
+    return arguments;
+}
+
+QJsonObject AttackSpec::toJson() const
+{
+    QJsonObject json;
+
+    json["hashMode"] = static_cast<qint64>(hashMode);
+    json["attackMode"] = static_cast<qint64>(attackMode);
+    json["hashFile"] = hashFile;
+    json["ignoreUsername"] = ignoreUsername;
+    json["remove"] = remove;
+    json["preprocessHashes"] = preprocessHashes;
+    json["hashesPerRun"] = hashesPerRun;
+
+    QJsonArray wordlistArray;
+    for (const Wordlist &wordlist : wordlists) {
+        wordlistArray.append(QJsonObject { { "path", wordlist.path }, { "checked", wordlist.checked } });
+    }
+    json["wordlists"] = wordlistArray;
+
+    QJsonArray rulesFileArray;
+    for (const Option &rulesFile : rulesFiles) {
+        rulesFileArray.append(optionToJson(rulesFile));
+    }
+    json["rulesFiles"] = rulesFileArray;
+    json["generateRules"] = generateRules;
+    json["generatedRules"] = generatedRules;
+
+    json["mask"] = mask;
+    QJsonArray charsetArray;
+    for (const Option &charset : customCharsets) {
+        charsetArray.append(optionToJson(charset));
+    }
+    json["customCharsets"] = charsetArray;
+    json["hexCharset"] = hexCharset;
+    json["hexSalt"] = hexSalt;
+
+    json["outfile"] = optionToJson(outfile);
+    json["outfileFormat"] = outfileFormat;
+
+    json["cpuAffinity"] = cpuAffinity;
+    json["devices"] = devices;
+    json["segmentSize"] = segmentSize;
+    json["skip"] = skip;
+    json["limit"] = limit;
+    json["sliceKeyspace"] = sliceKeyspace;
+
+    json["optimizedKernel"] = optimizedKernel;
+    json["speedOnly"] = speedOnly;
+    json["overrideWorkloadProfile"] = overrideWorkloadProfile;
+    json["workloadProfile"] = workloadProfile;
+
+    return json;
+}
+
+AttackSpec AttackSpec::fromJson(const QJsonObject &json)
+{
+    AttackSpec spec;
+
+    spec.hashMode = static_cast<quint32>(json.value("hashMode").toInteger(spec.hashMode));
+    if (json.contains("attackMode")) {
+        spec.attackMode = static_cast<quint32>(json.value("attackMode").toInteger(spec.attackMode));
+    } else {
+        const int index = json.value("comboBox_attack").toInt(0);
+        spec.attackMode = legacyAttackModes.at(static_cast<size_t>(qBound(0, index, static_cast<int>(legacyAttackModes.size()) - 1)));
+    }
+
+    spec.hashFile = value(json, "hashFile", "lineEdit_hashfile").toString();
+    spec.ignoreUsername = value(json, "ignoreUsername", "checkBox_ignoreusername").toBool();
+    spec.remove = value(json, "remove", "checkBox_remove").toBool();
+    spec.preprocessHashes = value(json, "preprocessHashes", "checkBox_preprocess_hashes").toBool();
+    spec.hashesPerRun = value(json, "hashesPerRun", "spinBox_hashes_per_run").toInt(spec.hashesPerRun);
+
+    // The wordlist view was a list widget and a list view before
+    QJsonValue wordlistArray = json.value("wordlists");
+    for (const QString &legacyKey : { QString("tableView_wordlist"), QString("listView_wordlist"), QString("listWidget_wordlist") }) {
+        if (wordlistArray.isUndefined()) {
+            wordlistArray = json.value(legacyKey);
+        }
+    }
+    for (const QJsonValue &entry : wordlistArray.toArray()) {
+        const QJsonObject wordlist = entry.toObject();
+        spec.wordlists.append({ wordlist.contains("path") ? wordlist.value("path").toString() : wordlist.value("text").toString(),
+                                wordlist.value("checked").toBool(true) });
+    }
+
+    // There were three rules files before, empty ones are dropped
+    const QJsonArray rulesFileArray = json.value("rulesFiles").toArray();
+    const int rulesFileCount = json.contains("rulesFiles") ? rulesFileArray.size() : 3;
+    for (int i = 0; i < rulesFileCount; ++i) {
+        const Option rulesFile = optionFromJson(json, "rulesFiles", i,
+                                                QString("checkBox_rulesfile_%1").arg(i + 1), QString("lineEdit_open_rulesfile_%1").arg(i + 1));
+        if (!rulesFile.value.isEmpty()) {
+            spec.rulesFiles.append(rulesFile);
+        }
+    }
+    spec.generateRules = value(json, "generateRules", "radioButton_generate_rules").toBool();
+    spec.generatedRules = value(json, "generatedRules", "spinBox_generate_rules").toInt(spec.generatedRules);
+
+    spec.mask = value(json, "mask", "lineEdit_mask").toString();
+    for (size_t i = 0; i < spec.customCharsets.size(); ++i) {
+        spec.customCharsets[i] = optionFromJson(json, "customCharsets", static_cast<int>(i),
+                                                QString("checkBox_custom_charset%1").arg(i + 1), QString("lineEdit_custom_charset%1").arg(i + 1));
+    }
+    spec.hexCharset = value(json, "hexCharset", "checkBox_hex_hash").toBool();
+    spec.hexSalt = value(json, "hexSalt", "checkBox_hex_salt").toBool();
+
+    spec.outfile = optionFromJson(json, "outfile", 0, "checkBox_outfile", "lineEdit_outfile");
+    spec.outfileFormat = value(json, "outfileFormat", "lineEdit_outfile_format").toString(spec.outfileFormat);
+
+    spec.cpuAffinity = value(json, "cpuAffinity", "lineEdit_cpu_affinity").toString();
+    spec.devices = value(json, "devices", "lineEdit_devices").toString(spec.devices);
+    spec.segmentSize = value(json, "segmentSize", "spinBox_segment").toInt(spec.segmentSize);
+    spec.skip = value(json, "skip", "lineEdit_skip").toString();
+    spec.limit = value(json, "limit", "lineEdit_limit").toString();
+    spec.sliceKeyspace = value(json, "sliceKeyspace", "checkBox_slice_keyspace").toBool();
+
+    spec.optimizedKernel = value(json, "optimizedKernel", "checkBox_optimized_kernel").toBool();
+    spec.speedOnly = value(json, "speedOnly", "checkBox_speed_only").toBool();
+    spec.overrideWorkloadProfile = value(json, "overrideWorkloadProfile", "checkBox_override_workload_profile").toBool();
+    if (json.contains("workloadProfile")) {
+        spec.workloadProfile = json.value("workloadProfile").toInt(spec.workloadProfile);
+    } else if (json.contains("comboBox_workload_profile")) {
+        spec.workloadProfile = json.value("comboBox_workload_profile").toInt() + 1;
+    }
+
+    return spec;
+}
+
+// Read a profile file, the attack is stored under profileKey
+bool AttackSpec::readProfile(const QString &file, QJsonObject *profile, QString *error)
+{
+    QFile f(file);
+    if (!f.open(QIODevice::ReadOnly)) {
+        if (error) {
+            *error = QCoreApplication::translate("AttackSpec", "Could not open %1 for reading.").arg(file);
+        }
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(f.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+        if (error) {
+            *error = QCoreApplication::translate("AttackSpec", "The file is not a valid JSON file.");
+        }
+        return false;
+    }
+
+    if (!doc.object().contains(profileKey)) {
+        if (error) {
+            *error = QCoreApplication::translate("AttackSpec", "The file does not contain a profile for \"%1\".").arg(profileKey);
+        }
+        return false;
+    }
+
+    *profile = doc.object().value(profileKey).toObject();
+    return true;
+}
+
+bool AttackSpec::writeProfile(const QString &file, const QJsonObject &profile, QString *error)
+{
+    QJsonObject root;
+    root[profileKey] = profile;
+
+    QSaveFile f(file);
+    if (!f.open(QIODevice::WriteOnly)) {
+        if (error) {
+            *error = QCoreApplication::translate("AttackSpec", "Could not open %1 for writing.").arg(file);
+        }
+        return false;
+    }
+
+    f.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    if (!f.commit()) {
+        if (error) {
+            *error = QCoreApplication::translate("AttackSpec", "Could not write %1.").arg(file);
+        }
+        return false;
+    }
+    return true;
+}
+
+bool AttackSpec::operator==(const AttackSpec &other) const
+{
+    const auto fields = [](const AttackSpec &spec) {
+        return std::tie(spec.hashMode, spec.attackMode, spec.hashFile, spec.ignoreUsername, spec.remove,
+                        spec.preprocessHashes, spec.hashesPerRun, spec.wordlists, spec.rulesFiles, spec.generateRules,
+                        spec.generatedRules, spec.mask, spec.customCharsets, spec.hexCharset, spec.hexSalt, spec.outfile,
+                        spec.outfileFormat, spec.cpuAffinity, spec.devices, spec.segmentSize, spec.skip, spec.limit,
+                        spec.sliceKeyspace, spec.optimizedKernel, spec.speedOnly, spec.overrideWorkloadProfile,
+                        spec.workloadProfile);
+    };
+    return fields(*this) == fields(other);
+}
@@ -0,0 +1,121 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef ATTACKSPEC_H
+#define ATTACKSPEC_H
+
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <array>
+
+// Everything that describes an attack, without any widgets. The hashcat arguments and profiles are
+// derived from it, so the queue and the command line use it without a main window.
+struct AttackSpec
+{
+    // Supported attack modes
+    enum AttackMode
+    {
+        Straight       = 0,
+        Combination    = 1,
+        BruteForce     = 3,
+        HybridWordMask = 6,
+        HybridMaskWord = 7,
+        Association    = 9
+    };
+
+    // A value that is only passed on if it is enabled, e.g. a rules file
+    struct Option {
+        bool enabled = false;
+        QString value;
+
+        bool operator==(const Option &other) const { return enabled == other.enabled && value == other.value; }
+        bool operator!=(const Option &other) const { return !(*this == other); }
+    };
+
+    struct Wordlist {
+        QString path;
+        bool checked = true;
+
+        bool operator==(const Wordlist &other) const { return path == other.path && checked == other.checked; }
+        bool operator!=(const Wordlist &other) const { return !(*this == other); }
+    };
+
+    struct ArgumentOptions {
+        bool useShortParameters = false;
+        bool withHashFile = true;
+        // Replaces the hash file, it has no usernames left
+        QString preprocessedHashFile;
+        // Replaces <unixtime> in the outfile
+        qint64 unixTime = 0;
+        // Name of the run, hashcat names its .restore file after it
+        QString session;
+    };
+
+    // Profiles are stored under the name of the window that wrote the first ones
+    static constexpr const char *profileKey = "MainWindow";
+
+    quint32 hashMode = 0;
+    quint32 attackMode = Straight;
+    QString hashFile;
+    bool ignoreUsername = false;
+    bool remove = false;
+    bool preprocessHashes = false;
+    int hashesPerRun = 0;
+
+    QList<Wordlist> wordlists;
+
+    // Stacked in this order, every rule of a file is combined with every rule of the others
+    QList<Option> rulesFiles;
+    bool generateRules = false;
+    int generatedRules = 1;
+
+    QString mask;
+    std::array<Option, 4> customCharsets;
+    bool hexCharset = false;
+    bool hexSalt = false;
+
+    Option outfile;
+    QString outfileFormat = "1,2";
+
+    QString cpuAffinity;
+    QString devices = "0";
+    int segmentSize = 32;
+    QString skip;
+    QString limit;
+    bool sliceKeyspace = false;
+
+    bool optimizedKernel = false;
+    bool speedOnly = false;
+    bool overrideWorkloadProfile = false;
+    int workloadProfile = 1;
+
+    // Which parts of the spec the attack mode uses
+    bool usesWordlists() const;
+    bool usesRules() const;
+    bool usesMask() const;
+
+    QStringList checkedWordlists() const;
+    QStringList enabledRulesFiles() const;
+    // Always four entries, disabled charsets are empty
+    QStringList customCharsetValues() const;
+
+    QStringList arguments(const ArgumentOptions &options = ArgumentOptions()) const;
+    // Arguments for "hashcat --keyspace", which takes no hash file and ignores output and device options
+    QStringList keyspaceArguments(bool useShortParameters = false) const;
+
+    QJsonObject toJson() const;
+    // Also reads profiles that were keyed by widget names, except for the hash mode
+    static AttackSpec fromJson(const QJsonObject &json);
+
+    static bool readProfile(const QString &file, QJsonObject *profile, QString *error = nullptr);
+    static bool writeProfile(const QString &file, const QJsonObject &profile, QString *error = nullptr);
+
+    bool operator==(const AttackSpec &other) const;
+    bool operator!=(const AttackSpec &other) const { return !(*this == other); }
+};
+
+#endif // ATTACKSPEC_H
@@ -0,0 +1,231 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "batchrunner.h"
+#include "attackspec.h"
+#include "settingsmanager.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QProcess>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QTextStream>
+#include <cstring>
+
+namespace {
+
+QTextStream &out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+QTextStream &err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+QString tr(const char *text)
+{
+    return QCoreApplication::translate("BatchRunner", text);
+}
+
+} // namespace
+
+bool BatchRunner::requested(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--batch") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int BatchRunner::exec()
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription(tr("Runs exported profiles with hashcat, one after another."));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addOption({ "batch", tr("Run without a window.") });
+    parser.addOption({ "dry-run", tr("Print the hashcat commands instead of running them.") });
+    parser.addOption({ "keep-going", tr("Run the remaining profiles after one failed.") });
+    parser.addOption({ "hashcat", tr("hashcat binary, instead of the one from the settings."), tr("path") });
+    parser.addOption({ "summary", tr("Write a JSON summary of all jobs, \"-\" for stdout."), tr("file") });
+    parser.addPositionalArgument("profiles", tr("Profiles exported from the main window."), tr("profile..."));
+    parser.process(*QCoreApplication::instance());
+
+    BatchOptions options;
+    options.profiles = parser.positionalArguments();
+    options.hashcatPath = parser.value("hashcat");
+    options.dryRun = parser.isSet("dry-run");
+    options.keepGoing = parser.isSet("keep-going");
+    options.summaryFile = parser.value("summary");
+
+    if (options.profiles.isEmpty()) {
+        err() << tr("No profile given.") << Qt::endl << parser.helpText();
+        return UsageError;
+    }
+
+    return run(options);
+}
+
+int BatchRunner::run(const BatchOptions &options)
+{
+    const QString hashcatPath = options.hashcatPath.isEmpty() ? SettingsManager::instance().getKey<QString>("hashcatPath")
+                                                              : options.hashcatPath;
+    if (hashcatPath.isEmpty() && !options.dryRun) {
+        err() << tr("No hashcat binary configured, pass --hashcat.") << Qt::endl;
+        return UsageError;
+    }
+
+    QJsonArray jobs;
+    int exitCode = Success;
+    bool stopped = false;
+
+    for (const QString &profile : options.profiles) {
+        if (stopped) {
+            jobs.append(QJsonObject { { "profile", profile }, { "status", "skipped" } });
+            continue;
+        }
+
+        const QJsonObject job = runProfile(profile, hashcatPath, options);
+        jobs.append(job);
+
+        const QString status = job.value("status").toString();
+        if (status == "invalid") {
+            exitCode = ProfileError;
+        } else if (status == "failed" && exitCode == Success) {
+            exitCode = JobFailed;
+        }
+        stopped = exitCode != Success && !options.keepGoing;
+    }
+
+    if (!options.summaryFile.isEmpty()) {
+        const QJsonObject summary = {
+            { "hashcat", hashcatPath },
+            { "dryRun", options.dryRun },
+            { "exitCode", exitCode },
+            { "jobs", jobs },
+        };
+        const QByteArray json = QJsonDocument(summary).toJson(QJsonDocument::Indented);
+
+        if (options.summaryFile == "-") {
+            out() << json;
+            out().flush();
+        } else {
+            QSaveFile file(options.summaryFile);
+            if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size() || !file.commit()) {
+                err() << tr("Could not write the summary to %1.").arg(options.summaryFile) << Qt::endl;
+            }
+        }
+    }
+
+    return exitCode;
+}
+
+QJsonObject BatchRunner::runProfile(const QString &profile, const QString &hashcatPath, const BatchOptions &options)
+{
+    QJsonObject job { { "profile", profile } };
+
+    QJsonObject json;
+    QString error;
+    if (!AttackSpec::readProfile(profile, &json, &error)) {
+        err() << profile << ": " << error << Qt::endl;
+        job["status"] = "invalid";
+        job["error"] = error;
+        return job;
+    }
+
+    // The hash mode of older profiles can only be looked up in the hash mode list of the window
+    if (!json.contains("hashMode")) {
+        error = tr("The profile does not store the hash mode, export it again.");
+        err() << profile << ": " << error << Qt::endl;
+        job["status"] = "invalid";
+        job["error"] = error;
+        return job;
+    }
+
+    // Preprocessing and keyspace slicing need the window, the profile runs as a single plain attack
+    const AttackSpec spec = AttackSpec::fromJson(json);
+    AttackSpec::ArgumentOptions argumentOptions;
+    argumentOptions.useShortParameters = SettingsManager::instance().getKey<bool>("useShortParameters");
+    argumentOptions.unixTime = QDateTime::currentSecsSinceEpoch();
+    const QStringList arguments = spec.arguments(argumentOptions);
+
+    const QString command = commandLine(hashcatPath.isEmpty() ? QString("hashcat") : hashcatPath, arguments);
+    job["arguments"] = QJsonArray::fromStringList(arguments);
+    job["command"] = command;
+
+    if (options.dryRun) {
+        out() << command << Qt::endl;
+        job["status"] = "printed";
+        return job;
+    }
+
+    // hashcat writes its status straight to the terminal, relative paths are resolved in its directory like in the window
+    QProcess process;
+    process.setProcessChannelMode(QProcess::ForwardedChannels);
+    process.setProgram(hashcatPath);
+    process.setArguments(arguments);
+    process.setWorkingDirectory(QFileInfo(hashcatPath).absolutePath());
+
+    err() << tr("Running %1").arg(profile) << Qt::endl;
+
+    QElapsedTimer timer;
+    timer.start();
+    process.start();
+    if (!process.waitForStarted(-1)) {
+        error = tr("Could not start %1: %2").arg(hashcatPath, process.errorString());
+        err() << profile << ": " << error << Qt::endl;
+        job["status"] = "failed";
+        job["error"] = error;
+        return job;
+    }
+    // hashcat falls back to reading candidates from stdin, never let it wait for input
+    process.closeWriteChannel();
+    process.waitForFinished(-1);
+
+    job["durationMs"] = timer.elapsed();
+    job["exitCode"] = process.exitCode();
+
+    // 0: all hashes cracked, 1: keyspace exhausted, everything else was aborted or failed
+    if (process.exitStatus() == QProcess::CrashExit) {
+        job["status"] = "failed";
+        job["error"] = tr("hashcat crashed");
+    } else if (process.exitCode() == 0) {
+        job["status"] = "cracked";
+    } else if (process.exitCode() == 1) {
+        job["status"] = "exhausted";
+    } else {
+        job["status"] = "failed";
+        job["error"] = tr("hashcat exited with code %1").arg(process.exitCode());
+    }
+
+    return job;
+}
+
+// A line that can be pasted into a shell
+QString BatchRunner::commandLine(const QString &program, const QStringList &arguments)
+{
+    static const QRegularExpression plain("^[A-Za-z0-9_@%+=:,./-]+$");
+
+    QStringList quoted;
+    for (const QString &argument : QStringList(program) + arguments) {
+        if (plain.match(argument).hasMatch()) {
+            quoted << argument;
+        } else {
+            quoted << "'" + QString(argument).replace("'", "'\\''") + "'";
+        }
+    }
+    return quoted.join(' ');
+}
@@ -0,0 +1,49 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+
+struct BatchOptions {
+    QStringList profiles;
+    // Overrides the hashcat binary from the settings
+    QString hashcatPath;
+    // Print the commands instead of running them
+    bool dryRun = false;
+    // Run the remaining profiles after one failed
+    bool keepGoing = false;
+    // JSON summary of all jobs, "-" writes it to stdout
+    QString summaryFile;
+};
+
+// Runs exported profiles one after another without any widgets, for machines without a display
+class BatchRunner
+{
+public:
+    enum ExitCode
+    {
+        Success      = 0,
+        JobFailed    = 1,
+        UsageError   = 2,
+        ProfileError = 3,
+    };
+
+    // True if the command line asks for batch mode, checked before any application object exists
+    static bool requested(int argc, char *argv[]);
+
+    // Parses the command line of the running QCoreApplication and runs the batch
+    static int exec();
+    static int run(const BatchOptions &options);
+
+private:
+    static QJsonObject runProfile(const QString &profile, const QString &hashcatPath, const BatchOptions &options);
+    static QString commandLine(const QString &program, const QStringList &arguments);
+};
+
+#endif // BATCHRUNNER_H
@@ -0,0 +1,321 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "benchmarkcache.h"
+#include "helperutils.h"
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocale>
+#include <QPalette>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+BenchmarkCache::BenchmarkCache(QObject *parent)
+    : QAbstractTableModel(parent)
+    , runner(new HashcatRunner(this))
+{
+    runner->setCaptureLimit(64 * 1024);
+
+    connect(runner, &HashcatRunner::standardOutputLine, this, &BenchmarkCache::outputLineReceived);
+    connect(runner, &HashcatRunner::finished, this, &BenchmarkCache::benchmarkFinished);
+
+    load();
+}
+
+int BenchmarkCache::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : entries.size();
+}
+
+int BenchmarkCache::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant BenchmarkCache::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= entries.size()) {
+        return QVariant();
+    }
+
+    const Entry &e = entries.at(index.row());
+
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case ColumnMode:
+            return modeNames.contains(e.mode) ? QString("%1 | %2").arg(e.mode).arg(modeNames.value(e.mode)) : QString::number(e.mode);
+        case ColumnDevice:
+            return QString("#%1").arg(e.device);
+        case ColumnSpeed:
+            return HelperUtils::formatSpeed(e.speed);
+        case ColumnVersion:
+            return e.version;
+        case ColumnMeasured:
+            return QLocale().toString(e.measured, QLocale::ShortFormat);
+        }
+    } else if (role == Qt::UserRole) {
+        // Raw values for sorting
+        switch (index.column()) {
+        case ColumnMode:
+            return e.mode;
+        case ColumnDevice:
+            return e.device;
+        case ColumnSpeed:
+            return e.speed;
+        case ColumnVersion:
+            return e.version;
+        case ColumnMeasured:
+            return e.measured;
+        }
+    } else if (role == Qt::ForegroundRole && e.version != currentVersion) {
+        // Results of other hashcat versions are kept but not used
+        return QPalette().brush(QPalette::Disabled, QPalette::Text);
+    }
+
+    return QVariant();
+}
+
+QVariant BenchmarkCache::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    switch (section) {
+    case ColumnMode:
+        return tr("Hash mode");
+    case ColumnDevice:
+        return tr("Device");
+    case ColumnSpeed:
+        return tr("Speed");
+    case ColumnVersion:
+        return tr("hashcat");
+    case ColumnMeasured:
+        return tr("Measured");
+    }
+
+    return QVariant();
+}
+
+void BenchmarkCache::setVersion(const QString &version)
+{
+    if (currentVersion == version) {
+        return;
+    }
+
+    currentVersion = version;
+    if (!entries.isEmpty()) {
+        emit dataChanged(index(0, 0), index(entries.size() - 1, ColumnCount - 1));
+    }
+    emit speedsChanged();
+}
+
+QString BenchmarkCache::version() const
+{
+    return currentVersion;
+}
+
+void BenchmarkCache::setModeNames(const QHash<quint32, QString> &names)
+{
+    modeNames = names;
+    if (!entries.isEmpty()) {
+        emit dataChanged(index(0, ColumnMode), index(entries.size() - 1, ColumnMode));
+    }
+}
+
+void BenchmarkCache::benchmark(const QList<quint32> &modes, const QString &devices)
+{
+    for (quint32 mode : modes) {
+        if (!pending.contains(mode) && !(runner->isRunning() && mode == currentMode)) {
+            pending << mode;
+        }
+    }
+    pendingDevices = devices;
+
+    runNext();
+}
+
+void BenchmarkCache::cancel()
+{
+    pending.clear();
+    if (runner->isRunning()) {
+        cancelled = true;
+        runner->cancel();
+    }
+}
+
+bool BenchmarkCache::isRunning() const
+{
+    return runner->isRunning();
+}
+
+int BenchmarkCache::pendingCount() const
+{
+    return pending.size();
+}
+
+qint64 BenchmarkCache::speed(quint32 mode, int device) const
+{
+    qint64 total = 0;
+    for (const Entry &e : entries) {
+        if (e.mode == mode && e.version == currentVersion && (device < 0 || e.device == device)) {
+            total += e.speed;
+        }
+    }
+    return total;
+}
+
+void BenchmarkCache::removeAll()
+{
+    beginResetModel();
+    entries.clear();
+    endResetModel();
+
+    save();
+    emit speedsChanged();
+}
+
+void BenchmarkCache::runNext()
+{
+    if (runner->isRunning() || pending.isEmpty()) {
+        return;
+    }
+
+    currentMode = pending.takeFirst();
+    receivedResult = false;
+    cancelled = false;
+
+    QStringList args;
+    args << "-b" << HelperUtils::getParameter(HelperUtils::Parameter::HashType) << QString::number(currentMode) << "--machine-readable";
+    if (!pendingDevices.isEmpty()) {
+        args << HelperUtils::getParameter(HelperUtils::Parameter::BackendDevices) << pendingDevices;
+    }
+
+    emit benchmarkStarted(currentMode);
+    runner->start(args);
+}
+
+// Machine readable lines look like "device:mode:...:speed"
+void BenchmarkCache::outputLineReceived(const QByteArray &line)
+{
+    const QList<QByteArray> fields = line.trimmed().split(':');
+    if (fields.size() < 3) {
+        return;
+    }
+
+    bool deviceOk = false, modeOk = false, speedOk = false;
+    const int device = fields.first().toInt(&deviceOk);
+    const quint32 mode = fields.at(1).toUInt(&modeOk);
+    const double speed = fields.last().toDouble(&speedOk);
+
+    if (deviceOk && modeOk && speedOk && speed > 0) {
+        receivedResult = true;
+        store(device, mode, qRound64(speed));
+    }
+}
+
+void BenchmarkCache::store(int device, quint32 mode, qint64 speed)
+{
+    Entry e;
+    e.version = currentVersion;
+    e.device = device;
+    e.mode = mode;
+    e.speed = speed;
+    e.measured = QDateTime::currentDateTime();
+
+    for (int row = 0; row < entries.size(); ++row) {
+        const Entry &existing = entries.at(row);
+        if (existing.version == e.version && existing.device == e.device && existing.mode == e.mode) {
+            entries[row] = e;
+            emit dataChanged(index(row, 0), index(row, ColumnCount - 1));
+            return;
+        }
+    }
+
+    beginInsertRows(QModelIndex(), entries.size(), entries.size());
+    entries.append(e);
+    endInsertRows();
+}
+
+void BenchmarkCache::benchmarkFinished(const HashcatResult &result)
+{
+    if (receivedResult) {
+        save();
+        emit speedsChanged();
+    } else if (!cancelled) {
+        emit failed(currentMode, result.standardError.trimmed().section('\n', -1));
+    }
+
+    runNext();
+    if (!runner->isRunning()) {
+        emit idle();
+    }
+}
+
+// Path to the persisted benchmark JSON
+QString BenchmarkCache::cacheFile()
+{
+    const QString dirPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dirPath);
+    return QDir(dirPath).filePath("benchmarks.json");
+}
+
+void BenchmarkCache::load()
+{
+    QFile f(cacheFile());
+    if (!f.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QJsonDocument doc = QJsonDocument::fromJson(f.readAll());
+    if (!doc.isObject()) {
+        return;
+    }
+
+    const QJsonArray list = doc.object().value("benchmarks").toArray();
+    for (const QJsonValue &v : list) {
+        const QJsonObject obj = v.toObject();
+        Entry e;
+        e.version = obj.value("version").toString();
+        e.device = obj.value("device").toInt();
+        e.mode = static_cast<quint32>(obj.value("mode").toInteger());
+        e.speed = obj.value("speed").toInteger();
+        e.measured = QDateTime::fromString(obj.value("measured").toString(), Qt::ISODate);
+
+        if (e.speed > 0) {
+            entries.append(e);
+        }
+    }
+}
+
+void BenchmarkCache::save() const
+{
+    QJsonArray list;
+    for (const Entry &e : entries) {
+        QJsonObject obj;
+        obj["version"] = e.version;
+        obj["device"] = e.device;
+        obj["mode"] = static_cast<qint64>(e.mode);
+        obj["speed"] = e.speed;
+        obj["measured"] = e.measured.toString(Qt::ISODate);
+        list.append(obj);
+    }
+
+    QJsonObject root;
+    root["benchmarks"] = list;
+
+    QSaveFile f(cacheFile());
+    if (!f.open(QIODevice::WriteOnly)) {
+        qWarning("Could not write benchmarks to %s", qPrintable(f.fileName()));
+        return;
+    }
+    f.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    if (!f.commit()) {
+        qWarning("Could not write benchmarks to %s", qPrintable(f.fileName()));
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef BENCHMARKCACHE_H
+#define BENCHMARKCACHE_H
+
+#include <QAbstractTableModel>
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include "hashcatrunner.h"
+
+// Benchmark results of "hashcat -b", per hashcat version, device and hash mode
+class BenchmarkCache : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column
+    {
+        ColumnMode,
+        ColumnDevice,
+        ColumnSpeed,
+        ColumnVersion,
+        ColumnMeasured,
+        ColumnCount
+    };
+
+    struct Entry {
+        QString version;
+        int device = 0;
+        quint32 mode = 0;
+        qint64 speed = 0;
+        QDateTime measured;
+    };
+
+    explicit BenchmarkCache(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    // Only results of this hashcat version are returned by speed()
+    void setVersion(const QString &version);
+    QString version() const;
+    void setModeNames(const QHash<quint32, QString> &names);
+
+    // Queue benchmarks, devices is passed to hashcat as -d if set
+    void benchmark(const QList<quint32> &modes, const QString &devices = QString());
+    void cancel();
+    bool isRunning() const;
+    int pendingCount() const;
+
+    // Speed of a device in H/s, or of all devices if device is -1. 0 if unknown.
+    qint64 speed(quint32 mode, int device = -1) const;
+    void removeAll();
+
+signals:
+    void benchmarkStarted(quint32 mode);
+    void failed(quint32 mode, const QString &error);
+    void speedsChanged();
+    // All queued benchmarks are done or cancelled
+    void idle();
+
+private slots:
+    void outputLineReceived(const QByteArray &line);
+    void benchmarkFinished(const HashcatResult &result);
+
+private:
+    QList<Entry> entries;
+    QHash<quint32, QString> modeNames;
+    QString currentVersion;
+
+    HashcatRunner *runner;
+    QList<quint32> pending;
+    QString pendingDevices;
+    quint32 currentMode = 0;
+    bool receivedResult = false;
+    bool cancelled = false;
+
+    void runNext();
+    void store(int device, quint32 mode, qint64 speed);
+
+    static QString cacheFile();
+    void load();
+    void save() const;
+};
+
+#endif // BENCHMARKCACHE_H
@@ -0,0 +1,118 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "benchmarkdialog.h"
+#include "ui_benchmarkdialog.h"
+#include <QMessageBox>
+#include <QSortFilterProxyModel>
+
+BenchmarkDialog::BenchmarkDialog(BenchmarkCache *cache, const QString &devices, QWidget *parent)
+    : QDialog(parent)
+    , ui(new Ui::BenchmarkDialog)
+    , cache(cache)
+    , devices(devices)
+{
+    ui->setupUi(this);
+
+    // Sort by the raw values, not by the formatted text
+    QSortFilterProxyModel *proxy = new QSortFilterProxyModel(this);
+    proxy->setSourceModel(cache);
+    proxy->setSortRole(Qt::UserRole);
+    ui->tableView_benchmarks->setModel(proxy);
+    ui->tableView_benchmarks->sortByColumn(BenchmarkCache::ColumnMode, Qt::AscendingOrder);
+    ui->tableView_benchmarks->resizeColumnsToContents();
+
+    connect(ui->pushButton_run, &QPushButton::clicked, this, &BenchmarkDialog::runClicked);
+    connect(ui->lineEdit_modes, &QLineEdit::returnPressed, this, &BenchmarkDialog::runClicked);
+    connect(ui->pushButton_cancel, &QPushButton::clicked, cache, &BenchmarkCache::cancel);
+    connect(ui->pushButton_clear, &QPushButton::clicked, this, &BenchmarkDialog::clearClicked);
+    connect(ui->pushButton_close, &QPushButton::clicked, this, &BenchmarkDialog::close);
+    connect(cache, &BenchmarkCache::benchmarkStarted, this, &BenchmarkDialog::benchmarkStarted);
+    connect(cache, &BenchmarkCache::failed, this, &BenchmarkDialog::benchmarkFailed);
+    connect(cache, &BenchmarkCache::speedsChanged, this, &BenchmarkDialog::speedsChanged);
+    connect(cache, &BenchmarkCache::idle, this, &BenchmarkDialog::idle);
+
+    updateButtons();
+}
+
+BenchmarkDialog::~BenchmarkDialog()
+{
+    delete ui;
+}
+
+void BenchmarkDialog::setModes(const QList<quint32> &modes)
+{
+    QStringList list;
+    for (quint32 mode : modes) {
+        list << QString::number(mode);
+    }
+    ui->lineEdit_modes->setText(list.join(","));
+}
+
+void BenchmarkDialog::runClicked()
+{
+    QList<quint32> modes;
+    const QStringList list = ui->lineEdit_modes->text().split(',', Qt::SkipEmptyParts);
+
+    for (const QString &value : list) {
+        bool ok = false;
+        quint32 mode = value.trimmed().toUInt(&ok);
+        if (!ok) {
+            QMessageBox::information(this, tr("Benchmarks"), tr("\"%1\" is not a hash mode.").arg(value.trimmed()));
+            return;
+        }
+        modes << mode;
+    }
+
+    if (!modes.isEmpty()) {
+        failures = false;
+        cache->benchmark(modes, devices);
+        updateButtons();
+    }
+}
+
+void BenchmarkDialog::clearClicked()
+{
+    QMessageBox::StandardButton answer = QMessageBox::question(this, tr("Benchmarks"), tr("Remove all stored benchmark results?"));
+    if (answer == QMessageBox::Yes) {
+        cache->removeAll();
+    }
+}
+
+void BenchmarkDialog::benchmarkStarted(quint32 mode)
+{
+    const int pending = cache->pendingCount();
+    if (pending > 0) {
+        ui->label_status->setText(tr("Benchmarking hash mode %1, %2 more queued...").arg(mode).arg(pending));
+    } else {
+        ui->label_status->setText(tr("Benchmarking hash mode %1...").arg(mode));
+    }
+    updateButtons();
+}
+
+void BenchmarkDialog::benchmarkFailed(quint32 mode, const QString &error)
+{
+    // The remaining modes are still benchmarked
+    failures = true;
+    ui->label_status->setText(tr("Benchmark of hash mode %1 failed: %2").arg(mode).arg(error));
+}
+
+void BenchmarkDialog::speedsChanged()
+{
+    ui->tableView_benchmarks->resizeColumnsToContents();
+}
+
+void BenchmarkDialog::idle()
+{
+    if (!failures) {
+        ui->label_status->setText(tr("Done"));
+    }
+    updateButtons();
+}
+
+void BenchmarkDialog::updateButtons()
+{
+    ui->pushButton_cancel->setEnabled(cache->isRunning() || cache->pendingCount() > 0);
+}
@@ -0,0 +1,44 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef BENCHMARKDIALOG_H
+#define BENCHMARKDIALOG_H
+
+#include <QDialog>
+#include "benchmarkcache.h"
+
+namespace Ui {
+    class BenchmarkDialog;
+}
+
+class BenchmarkDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    // devices is passed to hashcat as -d, empty for all devices
+    explicit BenchmarkDialog(BenchmarkCache *cache, const QString &devices, QWidget *parent = nullptr);
+    ~BenchmarkDialog();
+
+    void setModes(const QList<quint32> &modes);
+
+private slots:
+    void runClicked();
+    void clearClicked();
+    void benchmarkStarted(quint32 mode);
+    void benchmarkFailed(quint32 mode, const QString &error);
+    void speedsChanged();
+    void idle();
+
+private:
+    Ui::BenchmarkDialog *ui;
+    BenchmarkCache *cache;
+    QString devices;
+    bool failures = false;
+
+    void updateButtons();
+};
+
+#endif // BENCHMARKDIALOG_H
@@ -0,0 +1,213 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "crackedresultmodel.h"
+#include <QDateTime>
+#include <QLocale>
+#include <algorithm>
+
+// Crack rates are counted over this window
+static constexpr qint64 rateWindow = 60 * 1000;
+
+CrackedResultModel::CrackedResultModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+    setFormat("1,2");
+}
+
+int CrackedResultModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(starts.size());
+}
+
+int CrackedResultModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : fields.size();
+}
+
+QVariant CrackedResultModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole || section >= fields.size()) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    switch (fields.at(section)) {
+    case FieldHash:
+        return tr("Hash");
+    case FieldPlain:
+        return tr("Plain");
+    case FieldHexPlain:
+        return tr("Hex plain");
+    case FieldCrackPos:
+        return tr("Position");
+    case FieldTimestampAbsolute:
+        return tr("Cracked");
+    case FieldTimestampRelative:
+        return tr("Seconds");
+    }
+
+    return QVariant();
+}
+
+QVariant CrackedResultModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount() || index.column() >= fields.size()) {
+        return QVariant();
+    }
+
+    if (role == Qt::ToolTipRole) {
+        return QString::fromUtf8(line(index.row()));
+    }
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    const QByteArray field = split(index.row()).value(index.column());
+    if (fields.at(index.column()) == FieldTimestampAbsolute) {
+        bool ok = false;
+        const qint64 seconds = field.toLongLong(&ok);
+        if (ok) {
+            return QLocale().toString(QDateTime::fromSecsSinceEpoch(seconds), QLocale::ShortFormat);
+        }
+    }
+
+    return QString::fromUtf8(field);
+}
+
+void CrackedResultModel::setFormat(const QString &format)
+{
+    QList<int> parsed;
+    const QStringList values = format.split(',', Qt::SkipEmptyParts);
+    for (const QString &value : values) {
+        const int field = value.trimmed().toInt();
+        if (field >= FieldHash && field <= FieldTimestampRelative && !parsed.contains(field)) {
+            parsed << field;
+        }
+    }
+    if (parsed.isEmpty()) {
+        parsed = { FieldHash, FieldPlain };
+    }
+    // hashcat writes the fields in ascending order, whatever order --outfile-format lists them in
+    std::sort(parsed.begin(), parsed.end());
+
+    beginResetModel();
+    fields = parsed;
+    text.clear();
+    starts.clear();
+    arrivals.clear();
+    endResetModel();
+}
+
+void CrackedResultModel::appendLines(const QByteArray &lines, bool appended)
+{
+    std::vector<qsizetype> added;
+    qsizetype begin = 0;
+
+    while (begin < lines.size()) {
+        qsizetype end = lines.indexOf('\n', begin);
+        if (end < 0) {
+            end = lines.size();
+        }
+        // Empty lines are not results
+        if (end > begin && !(end == begin + 1 && lines.at(begin) == '\r')) {
+            added.push_back(text.size() + begin);
+        }
+        begin = end + 1;
+    }
+
+    if (added.empty()) {
+        return;
+    }
+
+    // Every line in text ends with a line break, even if the last one was cut
+    const int first = rowCount();
+    beginInsertRows(QModelIndex(), first, first + static_cast<int>(added.size()) - 1);
+    text.append(lines);
+    if (!text.endsWith('\n')) {
+        text.append('\n');
+    }
+    starts.insert(starts.end(), added.begin(), added.end());
+    endInsertRows();
+
+    if (appended) {
+        arrivals.emplace_back(QDateTime::currentMSecsSinceEpoch(), added.size());
+    }
+}
+
+void CrackedResultModel::clear()
+{
+    beginResetModel();
+    text.clear();
+    starts.clear();
+    arrivals.clear();
+    endResetModel();
+}
+
+QByteArray CrackedResultModel::line(int row) const
+{
+    if (row < 0 || row >= rowCount()) {
+        return QByteArray();
+    }
+
+    const qsizetype begin = starts[row];
+    qsizetype end = text.indexOf('\n', begin);
+    if (end > begin && text.at(end - 1) == '\r') {
+        --end;
+    }
+    return text.mid(begin, end - begin);
+}
+
+quint64 CrackedResultModel::cracksPerMinute() const
+{
+    const qint64 since = QDateTime::currentMSecsSinceEpoch() - rateWindow;
+    while (!arrivals.empty() && arrivals.front().first < since) {
+        arrivals.pop_front();
+    }
+
+    quint64 count = 0;
+    for (const auto &arrival : arrivals) {
+        count += arrival.second;
+    }
+    return count;
+}
+
+// Only the hash may contain the separator, hashcat writes such plains as $HEX[...]. The fields in front
+// of the hash are split off from the left, the ones after it from the right.
+QList<QByteArray> CrackedResultModel::split(int row) const
+{
+    const QByteArray l = line(row);
+    const int count = fields.size();
+    const int hashIndex = fields.indexOf(FieldHash);
+    const int leftCount = hashIndex >= 0 ? hashIndex : count - 1;
+    const int rightCount = count - 1 - leftCount;
+
+    QList<QByteArray> result;
+    result.reserve(count);
+
+    qsizetype begin = 0;
+    for (int i = 0; i < leftCount; ++i) {
+        const qsizetype colon = l.indexOf(':', begin);
+        if (colon < 0) {
+            break;
+        }
+        result << l.mid(begin, colon - begin);
+        begin = colon + 1;
+    }
+
+    QList<QByteArray> right;
+    qsizetype end = l.size();
+    for (int i = 0; i < rightCount; ++i) {
+        const qsizetype colon = end > begin ? l.lastIndexOf(':', end - 1) : -1;
+        if (colon < begin) {
+            break;
+        }
+        right.prepend(l.mid(colon + 1, end - colon - 1));
+        end = colon;
+    }
+
+    result << l.mid(begin, end - begin);
+    result << right;
+    return result;
+}
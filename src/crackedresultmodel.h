@@ -0,0 +1,62 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef CRACKEDRESULTMODEL_H
+#define CRACKEDRESULTMODEL_H
+
+#include <QAbstractTableModel>
+#include <QByteArray>
+#include <QList>
+#include <deque>
+#include <utility>
+#include <vector>
+
+// Lines of a hashcat outfile, split into the fields of its --outfile-format. The text is kept in
+// one buffer and split when a row is shown, so millions of rows cost little more than the file.
+class CrackedResultModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Field
+    {
+        FieldHash = 1,
+        FieldPlain = 2,
+        FieldHexPlain = 3,
+        FieldCrackPos = 4,
+        FieldTimestampAbsolute = 5,
+        FieldTimestampRelative = 6
+    };
+
+    explicit CrackedResultModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    // Parses the text of --outfile-format, unknown fields are ignored. Removes all rows.
+    void setFormat(const QString &format);
+    // Complete lines, appended ones count towards the crack rate
+    void appendLines(const QByteArray &lines, bool appended);
+    void clear();
+
+    // Whole line of a row, as hashcat wrote it
+    QByteArray line(int row) const;
+    // Lines appended within the last minute
+    quint64 cracksPerMinute() const;
+
+private:
+    QList<int> fields;
+    QByteArray text;
+    // Start of every line in text, the line ends one byte before the next start
+    std::vector<qsizetype> starts;
+    // Arrival time in ms and number of lines
+    mutable std::deque<std::pair<qint64, quint64>> arrivals;
+
+    QList<QByteArray> split(int row) const;
+};
+
+#endif // CRACKEDRESULTMODEL_H
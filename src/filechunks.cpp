@@ -0,0 +1,15 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "filechunks.h"
+
+QList<FileChunks::Chunk> FileChunks::split(const QString &file, qint64 fileSize, qint64 chunkSize, qint64 begin)
+{
+    QList<Chunk> chunks;
+    for (qint64 first = begin; first < fileSize || chunks.isEmpty(); first += chunkSize) {
+        chunks.append({ file, first, qMin(first + chunkSize, fileSize), fileSize });
+    }
+    return chunks;
+}
@@ -0,0 +1,89 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef FILECHUNKS_H
+#define FILECHUNKS_H
+
+#include <QFile>
+#include <QList>
+#include <QString>
+#include <cstring>
+#include <type_traits>
+
+// Splits line based files into chunks that are processed in parallel
+class FileChunks
+{
+public:
+    struct Chunk {
+        QString file;
+        qint64 begin = 0;
+        qint64 end = 0;
+        qint64 fileSize = 0;
+    };
+
+    static constexpr qint64 defaultChunkSize = 32 * 1024 * 1024;
+    // Lines longer than this are cut at the end of the mapping
+    static constexpr qint64 maxLineLength = 1024 * 1024;
+
+    // Empty files still get one chunk. Chunks start at begin, which has to be the start of a line.
+    static QList<Chunk> split(const QString &file, qint64 fileSize, qint64 chunkSize = defaultChunkSize, qint64 begin = 0);
+
+    // Calls function(const char *line, qsizetype length) for every line that starts in the chunk, including
+    // empty ones. Line breaks are not passed. A function that takes a third qint64 argument also receives
+    // the offset of the line in the file. Returns false if the file could not be mapped.
+    template <typename Function>
+    static bool forEachLine(const Chunk &chunk, Function function)
+    {
+        if (chunk.fileSize == 0) {
+            return true;
+        }
+
+        QFile f(chunk.file);
+        if (!f.open(QIODevice::ReadOnly)) {
+            return false;
+        }
+
+        // One byte before the chunk tells if a line starts right at its beginning
+        const qint64 mapBegin = chunk.begin > 0 ? chunk.begin - 1 : 0;
+        const qint64 mapEnd = qMin(chunk.end + maxLineLength, chunk.fileSize);
+        const uchar *map = f.map(mapBegin, mapEnd - mapBegin);
+        if (!map) {
+            return false;
+        }
+
+        const char *data = reinterpret_cast<const char *>(map);
+        const char *dataEnd = data + (mapEnd - mapBegin);
+        const char *limit = data + (chunk.end - mapBegin);
+        const char *p = data;
+
+        if (chunk.begin > 0) {
+            // The line that started in the previous chunk belongs to it
+            const char *newline = static_cast<const char *>(std::memchr(p, '\n', dataEnd - p));
+            p = newline ? newline + 1 : dataEnd;
+        }
+
+        while (p < limit) {
+            const char *newline = static_cast<const char *>(std::memchr(p, '\n', dataEnd - p));
+            const char *lineEnd = newline ? newline : dataEnd;
+
+            qsizetype length = lineEnd - p;
+            if (length > 0 && p[length - 1] == '\r') {
+                --length;
+            }
+
+            if constexpr (std::is_invocable_v<Function, const char *, qsizetype, qint64>) {
+                function(p, length, mapBegin + (p - data));
+            } else {
+                function(p, length);
+            }
+            p = lineEnd + 1;
+        }
+
+        f.unmap(const_cast<uchar *>(map));
+        return true;
+    }
+};
+
+#endif // FILECHUNKS_H
@@ -0,0 +1,162 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "fileviewerdialog.h"
+#include "ui_fileviewerdialog.h"
+#include <QDir>
+#include <QFontDatabase>
+#include <QHeaderView>
+#include <QLocale>
+#include <QMessageBox>
+#include <climits>
+
+FileViewerDialog::FileViewerDialog(const QString &file, QWidget *parent)
+    : QDialog(parent)
+    , ui(new Ui::FileViewerDialog)
+    , model(new FileViewModel(this))
+{
+    ui->setupUi(this);
+    setWindowTitle(tr("View %1").arg(QDir::toNativeSeparators(file)));
+
+    // Fixed row heights, the view never measures lines it does not show
+    ui->tableView_lines->setModel(model);
+    ui->tableView_lines->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    ui->tableView_lines->verticalHeader()->setDefaultSectionSize(ui->tableView_lines->fontMetrics().height() + 6);
+    ui->tableView_lines->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    ui->splitter->setSizes({ 400, 120 });
+
+    connect(model, &FileViewModel::indexProgress, this, &FileViewerDialog::indexProgress);
+    connect(model, &FileViewModel::indexed, this, &FileViewerDialog::indexed);
+    connect(model, &FileViewModel::failed, this, [this](const QString &error) {
+        ui->label_status->setText(error);
+    });
+    connect(&searchWatcher, &QFutureWatcher<FileSearchHit>::resultsReadyAt, this, &FileViewerDialog::hitsFound);
+    connect(&searchWatcher, &QFutureWatcher<FileSearchHit>::finished, this, &FileViewerDialog::searchFinished);
+    connect(ui->pushButton_search, &QPushButton::clicked, this, &FileViewerDialog::searchClicked);
+    connect(ui->lineEdit_search, &QLineEdit::returnPressed, this, &FileViewerDialog::searchClicked);
+    connect(ui->lineEdit_search, &QLineEdit::textChanged, this, &FileViewerDialog::updateButtons);
+    connect(ui->pushButton_cancel, &QPushButton::clicked, &searchWatcher, &QFutureWatcher<FileSearchHit>::cancel);
+    connect(ui->listWidget_hits, &QListWidget::itemActivated, this, &FileViewerDialog::hitActivated);
+    connect(ui->spinBox_goto, &QSpinBox::editingFinished, this, [this] { gotoLine(ui->spinBox_goto->value()); });
+    connect(ui->pushButton_close, &QPushButton::clicked, this, &FileViewerDialog::close);
+
+    QString error;
+    if (!model->open(file, &error)) {
+        ui->label_status->setText(error);
+    } else {
+        ui->label_status->setText(tr("Indexing lines..."));
+    }
+}
+
+FileViewerDialog::~FileViewerDialog()
+{
+    searchWatcher.cancel();
+    searchWatcher.waitForFinished();
+    delete ui;
+}
+
+void FileViewerDialog::searchClicked()
+{
+    if (!model->isIndexed() || searchWatcher.isRunning() || ui->lineEdit_search->text().isEmpty()) {
+        return;
+    }
+
+    FileSearchOptions options;
+    options.pattern = ui->lineEdit_search->text();
+    options.regularExpression = ui->checkBox_regex->isChecked();
+    options.caseSensitive = ui->checkBox_case->isChecked();
+
+    if (options.regularExpression && !QRegularExpression(options.pattern).isValid()) {
+        QMessageBox::information(this, tr("Search"), tr("Invalid regular expression: %1").arg(QRegularExpression(options.pattern).errorString()));
+        return;
+    }
+
+    hits = 0;
+    ui->listWidget_hits->clear();
+    ui->label_status->setText(tr("Searching..."));
+    searchWatcher.setFuture(model->search(options));
+    updateButtons();
+}
+
+// Hits of different chunks arrive in any order, the list stays sorted by line
+void FileViewerDialog::hitsFound(int begin, int end)
+{
+    QLocale locale;
+
+    for (int i = begin; i < end; ++i) {
+        const FileSearchHit hit = searchWatcher.resultAt(i);
+
+        int low = 0;
+        int high = ui->listWidget_hits->count();
+        while (low < high) {
+            const int middle = (low + high) / 2;
+            if (ui->listWidget_hits->item(middle)->data(Qt::UserRole).toULongLong() < hit.line) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+
+        auto *item = new QListWidgetItem(QString("%1: %2").arg(locale.toString(hit.line + 1), hit.text));
+        item->setData(Qt::UserRole, hit.line);
+        ui->listWidget_hits->insertItem(low, item);
+        ++hits;
+    }
+
+    ui->label_status->setText(tr("Searching... %1 matches").arg(locale.toString(hits)));
+}
+
+void FileViewerDialog::searchFinished()
+{
+    QLocale locale;
+    const int maxHits = FileSearchOptions().maxHits;
+
+    if (searchWatcher.isCanceled()) {
+        ui->label_status->setText(tr("Search canceled, %1 matches").arg(locale.toString(hits)));
+    } else if (hits >= maxHits) {
+        ui->label_status->setText(tr("Showing the first %1 matches").arg(locale.toString(maxHits)));
+    } else {
+        ui->label_status->setText(tr("%1 matches").arg(locale.toString(hits)));
+    }
+    updateButtons();
+}
+
+void FileViewerDialog::hitActivated()
+{
+    QListWidgetItem *item = ui->listWidget_hits->currentItem();
+    if (item) {
+        const quint64 line = item->data(Qt::UserRole).toULongLong();
+        gotoLine(static_cast<int>(qMin<quint64>(line + 1, INT_MAX)));
+    }
+}
+
+void FileViewerDialog::gotoLine(int line)
+{
+    const QModelIndex index = model->index(line - 1, 0);
+    if (index.isValid()) {
+        ui->tableView_lines->scrollTo(index, QAbstractItemView::PositionAtCenter);
+        ui->tableView_lines->selectRow(index.row());
+    }
+}
+
+void FileViewerDialog::indexProgress(int percent)
+{
+    ui->label_status->setText(tr("Indexing lines... %1%").arg(percent));
+}
+
+void FileViewerDialog::indexed()
+{
+    QLocale locale;
+    ui->label_status->setText(tr("%1 lines, %2").arg(locale.toString(model->lineCount()), locale.formattedDataSize(model->fileSize())));
+    ui->spinBox_goto->setMaximum(qMax(1, model->rowCount()));
+    updateButtons();
+}
+
+void FileViewerDialog::updateButtons()
+{
+    const bool searching = searchWatcher.isRunning();
+    ui->pushButton_search->setEnabled(model->isIndexed() && !searching && !ui->lineEdit_search->text().isEmpty());
+    ui->pushButton_cancel->setEnabled(searching);
+}
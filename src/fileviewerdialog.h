@@ -0,0 +1,44 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef FILEVIEWERDIALOG_H
+#define FILEVIEWERDIALOG_H
+
+#include <QDialog>
+#include <QFutureWatcher>
+#include "fileviewmodel.h"
+
+namespace Ui {
+    class FileViewerDialog;
+}
+
+// Read-only view of wordlists, hash files and outfiles of any size, with search
+class FileViewerDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit FileViewerDialog(const QString &file, QWidget *parent = nullptr);
+    ~FileViewerDialog();
+
+private slots:
+    void searchClicked();
+    void hitsFound(int begin, int end);
+    void searchFinished();
+    void hitActivated();
+    void gotoLine(int line);
+    void indexProgress(int percent);
+    void indexed();
+
+private:
+    Ui::FileViewerDialog *ui;
+    FileViewModel *model;
+    QFutureWatcher<FileSearchHit> searchWatcher;
+    int hits = 0;
+
+    void updateButtons();
+};
+
+#endif // FILEVIEWERDIALOG_H
@@ -0,0 +1,307 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "fileviewmodel.h"
+#include "filechunks.h"
+#include <QByteArrayMatcher>
+#include <QFileInfo>
+#include <QtConcurrent>
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstring>
+
+namespace {
+
+FileViewModel::IndexChunk indexChunk(const FileChunks::Chunk &chunk)
+{
+    FileViewModel::IndexChunk result;
+    result.begin = chunk.begin;
+    result.end = chunk.end;
+
+    result.failed = !FileChunks::forEachLine(chunk, [&result](const char *, qsizetype, qint64 offset) {
+        if (result.lines % FileViewModel::stride == 0) {
+            result.offsets.push_back(offset);
+        }
+        ++result.lines;
+    });
+
+    return result;
+}
+
+} // namespace
+
+FileViewModel::FileViewModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+FileViewModel::~FileViewModel()
+{
+    if (watcher) {
+        watcher->cancel();
+        watcher->waitForFinished();
+    }
+}
+
+// Views take an int, lines past that are only reachable through the search
+int FileViewModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(qMin<quint64>(lineCount(), INT_MAX));
+}
+
+int FileViewModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : 1;
+}
+
+QVariant FileViewModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    if (orientation == Qt::Vertical) {
+        return section + 1;
+    }
+    return QFileInfo(mappedFile.fileName()).fileName();
+}
+
+QVariant FileViewModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole || static_cast<quint64>(index.row()) >= lineCount()) {
+        return QVariant();
+    }
+
+    return QString::fromUtf8(line(static_cast<quint64>(index.row())));
+}
+
+bool FileViewModel::open(const QString &file, QString *error)
+{
+    beginResetModel();
+
+    if (watcher) {
+        watcher->cancel();
+        watcher->deleteLater();
+        watcher = nullptr;
+    }
+    if (mapping) {
+        mappedFile.unmap(const_cast<uchar *>(mapping));
+        mapping = nullptr;
+    }
+    mappedFile.close();
+    chunks.clear();
+    complete = false;
+    size = 0;
+
+    mappedFile.setFileName(file);
+    bool ok = mappedFile.open(QIODevice::ReadOnly);
+    if (ok) {
+        size = mappedFile.size();
+        // Only the pages that are looked at are read, the size of the file does not matter
+        mapping = size > 0 ? mappedFile.map(0, size) : nullptr;
+        ok = size == 0 || mapping;
+    }
+
+    endResetModel();
+
+    if (!ok) {
+        if (error) {
+            *error = tr("Could not open %1: %2").arg(file, mappedFile.errorString());
+        }
+        mappedFile.close();
+        size = 0;
+        return false;
+    }
+
+    watcher = new QFutureWatcher<IndexChunk>(this);
+    connect(watcher, &QFutureWatcher<IndexChunk>::resultsReadyAt, this, &FileViewModel::chunksIndexed);
+    connect(watcher, &QFutureWatcher<IndexChunk>::progressValueChanged, this, &FileViewModel::indexProgress);
+    connect(watcher, &QFutureWatcher<IndexChunk>::finished, this, [this, w = watcher] {
+        if (w != watcher || w->isCanceled()) {
+            return;
+        }
+        complete = true;
+        emit indexed();
+    });
+    watcher->setFuture(QtConcurrent::run(&FileViewModel::buildIndex, file, size));
+
+    return true;
+}
+
+QString FileViewModel::file() const
+{
+    return mappedFile.fileName();
+}
+
+qint64 FileViewModel::fileSize() const
+{
+    return size;
+}
+
+bool FileViewModel::isIndexed() const
+{
+    return complete;
+}
+
+quint64 FileViewModel::lineCount() const
+{
+    return chunks.empty() ? 0 : chunks.back().firstLine + chunks.back().lines;
+}
+
+QByteArray FileViewModel::line(quint64 line) const
+{
+    const qint64 begin = lineOffset(line);
+    if (begin < 0) {
+        return QByteArray();
+    }
+
+    const char *text = reinterpret_cast<const char *>(mapping) + begin;
+    const qint64 available = qMin<qint64>(size - begin, maxDisplayLength);
+    const char *newline = static_cast<const char *>(std::memchr(text, '\n', static_cast<size_t>(available)));
+
+    qsizetype length = newline ? newline - text : available;
+    if (length > 0 && text[length - 1] == '\r') {
+        --length;
+    }
+    return QByteArray(text, length);
+}
+
+QFuture<FileSearchHit> FileViewModel::search(const FileSearchOptions &options) const
+{
+    return QtConcurrent::run(&FileViewModel::searchChunks, mappedFile.fileName(), size, chunks, options);
+}
+
+void FileViewModel::chunksIndexed(int begin, int end)
+{
+    if (watcher->isCanceled()) {
+        return;
+    }
+    const quint64 before = lineCount();
+
+    for (int i = begin; i < end; ++i) {
+        IndexChunk chunk = watcher->resultAt(i);
+        if (chunk.failed) {
+            watcher->cancel();
+            emit failed(tr("Could not read %1.").arg(mappedFile.fileName()));
+            return;
+        }
+        chunks.push_back(std::move(chunk));
+    }
+
+    // Rows only ever grow at the end, the view keeps its position
+    const int first = static_cast<int>(qMin<quint64>(before, INT_MAX));
+    const int last = rowCount() - 1;
+    if (last >= first) {
+        beginInsertRows(QModelIndex(), first, last);
+        endInsertRows();
+    }
+}
+
+// The closest indexed line before it, then at most stride - 1 lines forward
+qint64 FileViewModel::lineOffset(quint64 line) const
+{
+    if (!mapping || line >= lineCount()) {
+        return -1;
+    }
+
+    auto it = std::upper_bound(chunks.begin(), chunks.end(), line, [](quint64 value, const IndexChunk &chunk) {
+        return value < chunk.firstLine;
+    });
+    const IndexChunk &chunk = *(it - 1);
+    const quint64 local = line - chunk.firstLine;
+
+    const char *text = reinterpret_cast<const char *>(mapping);
+    qint64 offset = chunk.offsets[local / stride];
+    for (quint64 skip = local % stride; skip > 0; --skip) {
+        const char *newline = static_cast<const char *>(std::memchr(text + offset, '\n', static_cast<size_t>(size - offset)));
+        if (!newline) {
+            return -1;
+        }
+        offset = newline + 1 - text;
+    }
+    return offset;
+}
+
+void FileViewModel::buildIndex(QPromise<IndexChunk> &promise, const QString &file, qint64 size)
+{
+    const QList<FileChunks::Chunk> fileChunks = FileChunks::split(file, size);
+    promise.setProgressRange(0, 100);
+    int done = 0;
+
+    // Ordered, a chunk can only be numbered once all before it are counted
+    QtConcurrent::blockingMappedReduced<quint64>(
+        fileChunks,
+        [&promise](const FileChunks::Chunk &chunk) {
+            return promise.isCanceled() ? FileViewModel::IndexChunk() : indexChunk(chunk);
+        },
+        [&promise, &done, &fileChunks](quint64 &total, const FileViewModel::IndexChunk &chunk) {
+            if (promise.isCanceled()) {
+                return;
+            }
+            FileViewModel::IndexChunk numbered = chunk;
+            numbered.firstLine = total;
+            total += chunk.lines;
+            promise.addResult(std::move(numbered));
+            promise.setProgressValue(static_cast<int>(100 * ++done / fileChunks.size()));
+        },
+        QtConcurrent::OrderedReduce);
+}
+
+void FileViewModel::searchChunks(QPromise<FileSearchHit> &promise, const QString &file, qint64 size,
+                                 const std::vector<IndexChunk> &chunks, const FileSearchOptions &options)
+{
+    const QRegularExpression regex(options.pattern, options.caseSensitive ? QRegularExpression::NoPatternOption
+                                                                          : QRegularExpression::CaseInsensitiveOption);
+    const QByteArray needle = options.caseSensitive ? options.pattern.toUtf8() : options.pattern.toUtf8().toLower();
+    const QByteArrayMatcher matcher(needle);
+    std::atomic<int> hits = 0;
+    int done = 0;
+
+    promise.setProgressRange(0, static_cast<int>(chunks.size()));
+
+    // Every chunk reports its hits at once, so results stream in while the rest is searched
+    QtConcurrent::blockingMappedReduced<int>(
+        chunks,
+        [&](const IndexChunk &chunk) {
+            QList<FileSearchHit> found;
+            if (promise.isCanceled() || hits >= options.maxHits) {
+                return found;
+            }
+
+            quint64 line = chunk.firstLine;
+            QByteArray lower;
+
+            FileChunks::forEachLine(FileChunks::Chunk { file, chunk.begin, chunk.end, size }, [&](const char *text, qsizetype length) {
+                const quint64 current = line++;
+                if (hits + found.size() >= options.maxHits) {
+                    return;
+                }
+
+                bool match = false;
+                if (options.regularExpression) {
+                    match = regex.match(QString::fromUtf8(text, length)).hasMatch();
+                } else if (options.caseSensitive) {
+                    match = matcher.indexIn(text, length) >= 0;
+                } else {
+                    lower = QByteArray(text, length).toLower();
+                    match = matcher.indexIn(lower) >= 0;
+                }
+
+                if (match) {
+                    found.append({ current, QString::fromUtf8(text, qMin(length, maxDisplayLength)) });
+                }
+            });
+
+            hits += static_cast<int>(found.size());
+            return found;
+        },
+        [&promise, &done](int &, const QList<FileSearchHit> &found) {
+            for (const FileSearchHit &hit : found) {
+                promise.addResult(hit);
+            }
+            promise.setProgressValue(++done);
+        },
+        QtConcurrent::UnorderedReduce);
+}
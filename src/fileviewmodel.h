@@ -0,0 +1,91 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef FILEVIEWMODEL_H
+#define FILEVIEWMODEL_H
+
+#include <QAbstractTableModel>
+#include <QFile>
+#include <QFutureWatcher>
+#include <QList>
+#include <QPromise>
+#include <QRegularExpression>
+#include <vector>
+
+struct FileSearchHit {
+    quint64 line = 0;
+    QString text;
+};
+
+struct FileSearchOptions {
+    QString pattern;
+    bool regularExpression = false;
+    bool caseSensitive = false;
+    // Searching stops after this many hits
+    int maxHits = 10000;
+};
+
+// Read-only lines of a file of any size. The file is mapped, a sparse index of line offsets is
+// built in the background and rows are added as the index grows.
+class FileViewModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    // Every line that starts in a chunk of the file, with the offset of every strideth of them
+    struct IndexChunk {
+        qint64 begin = 0;
+        qint64 end = 0;
+        quint64 firstLine = 0;
+        quint64 lines = 0;
+        std::vector<qint64> offsets;
+        bool failed = false;
+    };
+
+    static constexpr quint64 stride = 256;
+    // Longer lines are cut for display
+    static constexpr qsizetype maxDisplayLength = 4096;
+
+    explicit FileViewModel(QObject *parent = nullptr);
+    ~FileViewModel();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    // Returns false and sets error if the file can't be mapped
+    bool open(const QString &file, QString *error = nullptr);
+    QString file() const;
+    qint64 fileSize() const;
+    bool isIndexed() const;
+    quint64 lineCount() const;
+    QByteArray line(quint64 line) const;
+
+    // Searches the indexed file on all cores, hits arrive in batches and unordered
+    QFuture<FileSearchHit> search(const FileSearchOptions &options) const;
+
+signals:
+    void indexProgress(int percent);
+    void indexed();
+    void failed(const QString &error);
+
+private:
+    QFile mappedFile;
+    const uchar *mapping = nullptr;
+    qint64 size = 0;
+    std::vector<IndexChunk> chunks;
+    QFutureWatcher<IndexChunk> *watcher = nullptr;
+    bool complete = false;
+
+    void chunksIndexed(int begin, int end);
+    qint64 lineOffset(quint64 line) const;
+
+    static void buildIndex(QPromise<IndexChunk> &promise, const QString &file, qint64 size);
+    static void searchChunks(QPromise<FileSearchHit> &promise, const QString &file, qint64 size,
+                             const std::vector<IndexChunk> &chunks, const FileSearchOptions &options);
+};
+
+#endif // FILEVIEWMODEL_H
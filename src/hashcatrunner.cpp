@@ -0,0 +1,252 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "hashcatrunner.h"
+#include "settingsmanager.h"
+#include <QFileInfo>
+
+// Lines longer than this are delivered in pieces instead of growing the buffer
+static constexpr qsizetype maxLineLength = 64 * 1024;
+
+// Grace period between terminate() and kill() when cancelling
+static constexpr int killTimeoutMs = 3000;
+
+HashcatRunner::HashcatRunner(QObject *parent)
+    : QObject(parent)
+    , process(new QProcess(this))
+{
+    timeoutTimer.setSingleShot(true);
+    killTimer.setSingleShot(true);
+
+    connect(process, &QProcess::readyReadStandardOutput, this, &HashcatRunner::readStandardOutput);
+    connect(process, &QProcess::readyReadStandardError, this, &HashcatRunner::readStandardError);
+    connect(process, &QProcess::finished, this, &HashcatRunner::processFinished);
+    connect(process, &QProcess::errorOccurred, this, &HashcatRunner::processErrorOccurred);
+    connect(process, &QProcess::started, this, &HashcatRunner::started);
+
+    connect(&timeoutTimer, &QTimer::timeout, this, [this]() {
+        failure = "hashcat timed out";
+        process->kill();
+    });
+    connect(&killTimer, &QTimer::timeout, process, &QProcess::kill);
+}
+
+HashcatRunner::~HashcatRunner()
+{
+    if (process->state() != QProcess::NotRunning) {
+        process->disconnect(this);
+        process->kill();
+        process->waitForFinished(1000);
+    }
+}
+
+void HashcatRunner::setQuiet(bool quiet)
+{
+    this->quiet = quiet;
+}
+
+void HashcatRunner::setTimeout(int timeoutMs)
+{
+    timeoutTimer.setInterval(timeoutMs);
+}
+
+void HashcatRunner::setCaptureLimit(qsizetype bytes)
+{
+    captureLimit = bytes;
+}
+
+bool HashcatRunner::isRunning() const
+{
+    return process->state() != QProcess::NotRunning;
+}
+
+qint64 HashcatRunner::processId() const
+{
+    return process->processId();
+}
+
+qint64 HashcatRunner::bytesReceived() const
+{
+    return bytes;
+}
+
+/**
+ * Starts hashcat in the background. Output is delivered line by line through
+ * standardOutputLine()/standardErrorLine() while the process is running, no
+ * thread is blocked waiting for it. finished() is emitted exactly once, also
+ * when the process could not be started.
+ *
+ * Usage Example:
+ *
+ * HashcatRunner *runner = HashcatRunner::run(QStringList() << "--help", this);
+ * connect(runner, &HashcatRunner::finished, this, [this](const HashcatResult &result) {
+ *     // process contents of "result"
+ * });
+ */
+bool HashcatRunner::start(const QStringList &args)
+{
+    if (isRunning()) {
+        return false;
+    }
+
+    const auto &settings = SettingsManager::instance();
+    const QString hashcatPath = settings.getKey<QString>("hashcatPath");
+
+    bytes = 0;
+    truncated = false;
+    failure.clear();
+    stdoutPending.clear();
+    stderrPending.clear();
+    stdoutCaptured.clear();
+    stderrCaptured.clear();
+
+    if (hashcatPath.isEmpty()) {
+        failure = "hashcatPath not configured";
+        // Deliver asynchronously so callers can connect after start()
+        QMetaObject::invokeMethod(this, [this]() { finish(QProcess::CrashExit, -1); }, Qt::QueuedConnection);
+        return false;
+    }
+
+    QStringList cmdArgs = args;
+
+    // Run in quiet mode when reading output
+    if (quiet) {
+        cmdArgs << "--quiet";
+    }
+
+    process->setProgram(hashcatPath);
+    process->setArguments(cmdArgs);
+    process->setWorkingDirectory(QFileInfo(hashcatPath).absolutePath());
+
+    elapsedTimer.start();
+    process->start();
+
+    // hashcat falls back to reading candidates from stdin, never let it wait for input
+    process->closeWriteChannel();
+
+    if (timeoutTimer.interval() > 0) {
+        timeoutTimer.start();
+    }
+
+    return true;
+}
+
+void HashcatRunner::cancel()
+{
+    if (!isRunning()) {
+        return;
+    }
+
+    failure = "hashcat was cancelled";
+
+#if defined(Q_OS_WIN)
+    // Console applications don't react to WM_CLOSE
+    process->kill();
+#else
+    // Give hashcat the chance to write its restore file
+    process->terminate();
+    killTimer.start(killTimeoutMs);
+#endif
+}
+
+void HashcatRunner::readStandardOutput()
+{
+    handleData(process->readAllStandardOutput(), stdoutPending, stdoutCaptured, true);
+}
+
+void HashcatRunner::readStandardError()
+{
+    handleData(process->readAllStandardError(), stderrPending, stderrCaptured, false);
+}
+
+void HashcatRunner::handleData(const QByteArray &data, QByteArray &pending, QByteArray &captured, bool isStdout)
+{
+    if (data.isEmpty()) {
+        return;
+    }
+
+    bytes += data.size();
+
+    // Keep at most captureLimit bytes for the final result
+    if (captured.size() + data.size() > captureLimit) {
+        truncated = true;
+    }
+    if (captured.size() < captureLimit) {
+        captured.append(data.left(captureLimit - captured.size()));
+    }
+
+    pending.append(data);
+
+    qsizetype from = 0;
+    qsizetype pos;
+    while ((pos = pending.indexOf('\n', from)) >= 0) {
+        QByteArray line = pending.mid(from, pos - from);
+        if (line.endsWith('\r')) {
+            line.chop(1);
+        }
+        emit isStdout ? standardOutputLine(line) : standardErrorLine(line);
+        from = pos + 1;
+    }
+    pending.remove(0, from);
+
+    // A line that never ends must not grow without bound
+    if (pending.size() > maxLineLength) {
+        emit isStdout ? standardOutputLine(pending) : standardErrorLine(pending);
+        pending.clear();
+    }
+
+    emit progress(bytes, elapsedTimer.elapsed());
+}
+
+void HashcatRunner::processFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    // Pick up anything that arrived together with the exit notification
+    readStandardOutput();
+    readStandardError();
+
+    if (!stdoutPending.isEmpty()) {
+        emit standardOutputLine(stdoutPending);
+        stdoutPending.clear();
+    }
+    if (!stderrPending.isEmpty()) {
+        emit standardErrorLine(stderrPending);
+        stderrPending.clear();
+    }
+
+    finish(exitStatus, exitCode);
+}
+
+void HashcatRunner::processErrorOccurred(QProcess::ProcessError error)
+{
+    // All other errors are followed by finished()
+    if (error == QProcess::FailedToStart) {
+        failure = "Failed to start hashcat";
+        finish(QProcess::CrashExit, -1);
+    }
+}
+
+void HashcatRunner::finish(QProcess::ExitStatus exitStatus, int exitCode)
+{
+    timeoutTimer.stop();
+    killTimer.stop();
+
+    HashcatResult result;
+    result.exitStatus = exitStatus;
+    result.exitCode = exitCode;
+    result.standardOutput = QString::fromUtf8(stdoutCaptured);
+    result.standardError = failure.isEmpty() ? QString::fromUtf8(stderrCaptured) : failure;
+    result.truncated = truncated;
+
+    emit finished(result);
+}
+
+HashcatRunner *HashcatRunner::run(const QStringList &args, QObject *parent, int timeoutMs)
+{
+    HashcatRunner *runner = new HashcatRunner(parent);
+    connect(runner, &HashcatRunner::finished, runner, &QObject::deleteLater);
+    runner->setTimeout(timeoutMs);
+    runner->start(args);
+    return runner;
+}
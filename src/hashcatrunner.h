@@ -0,0 +1,85 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef HASHCATRUNNER_H
+#define HASHCATRUNNER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QProcess>
+#include <QTimer>
+#include <QElapsedTimer>
+
+struct HashcatResult {
+    QProcess::ExitStatus exitStatus = QProcess::CrashExit;
+    int exitCode = -1;
+    QString standardOutput;
+    QString standardError;
+    // Output exceeded the capture limit and was cut off
+    bool truncated = false;
+};
+
+class HashcatRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit HashcatRunner(QObject *parent = nullptr);
+    ~HashcatRunner();
+
+    // Append --quiet to the arguments (default: true)
+    void setQuiet(bool quiet);
+    // Kill the process after timeoutMs, 0 disables the timeout (default)
+    void setTimeout(int timeoutMs);
+    // Maximum number of bytes per channel kept for the final HashcatResult
+    void setCaptureLimit(qsizetype bytes);
+
+    bool start(const QStringList &args);
+    void cancel();
+
+    bool isRunning() const;
+    qint64 processId() const;
+    qint64 bytesReceived() const;
+
+    // Start a runner that deletes itself after emitting finished()
+    static HashcatRunner *run(const QStringList &args, QObject *parent, int timeoutMs = 0);
+
+signals:
+    void started();
+    void standardOutputLine(const QByteArray &line);
+    void standardErrorLine(const QByteArray &line);
+    void progress(qint64 bytesReceived, qint64 elapsedMs);
+    void finished(const HashcatResult &result);
+
+private slots:
+    void readStandardOutput();
+    void readStandardError();
+    void processFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void processErrorOccurred(QProcess::ProcessError error);
+
+private:
+    QProcess *process;
+    QTimer timeoutTimer;
+    QTimer killTimer;
+    QElapsedTimer elapsedTimer;
+
+    bool quiet = true;
+    qsizetype captureLimit = 1024 * 1024;
+    qint64 bytes = 0;
+    QString failure;
+    bool truncated = false;
+
+    QByteArray stdoutPending;
+    QByteArray stderrPending;
+    QByteArray stdoutCaptured;
+    QByteArray stderrCaptured;
+
+    void handleData(const QByteArray &data, QByteArray &pending, QByteArray &captured, bool isStdout);
+    void finish(QProcess::ExitStatus exitStatus, int exitCode);
+};
+
+#endif // HASHCATRUNNER_H
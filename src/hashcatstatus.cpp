@@ -0,0 +1,114 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "hashcatstatus.h"
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QStringList>
+
+qint64 HashcatStatus::totalSpeed() const
+{
+    qint64 speed = 0;
+    for (const HashcatDeviceStatus &device : devices) {
+        speed += device.speed;
+    }
+    return speed;
+}
+
+double HashcatStatus::progressPercent() const
+{
+    if (progressTotal == 0) {
+        return 0.0;
+    }
+    return 100.0 * static_cast<double>(progressDone) / static_cast<double>(progressTotal);
+}
+
+// Status names as used by hashcat (status.c)
+QString HashcatStatus::statusText() const
+{
+    static const QStringList names = {
+        "Initializing",
+        "Autotuning",
+        "Selftest",
+        "Running",
+        "Paused",
+        "Exhausted",
+        "Cracked",
+        "Aborted",
+        "Quit",
+        "Bypass",
+        "Aborted (Checkpoint)",
+        "Aborted (Runtime)",
+        "Running (Checkpoint Quit requested)",
+        "Error",
+        "Aborted (Finish)",
+        "Running (Quit after attack requested)",
+        "Autodetect",
+    };
+
+    if (status < 0 || status >= names.size()) {
+        return "Unknown";
+    }
+    return names.at(status);
+}
+
+/*
+ * Example (shortened):
+ *
+ * { "session": "hashcat", "status": 3, "target": "hashes.txt", "progress": [123, 14344384],
+ *   "recovered_hashes": [0, 1], "rejected": 0, "time_start": 1700000000, "estimated_stop": 1700000100,
+ *   "devices": [ { "device_id": 1, "device_name": "...", "device_type": "GPU", "speed": 1234, "temp": 50, "util": 99 } ] }
+ */
+bool HashcatStatus::fromJson(const QByteArray &line, HashcatStatus &status)
+{
+    // Cheap pre-check, most other output lines are cracked hashes or messages
+    if (!line.startsWith('{')) {
+        return false;
+    }
+
+    QJsonParseError err;
+    QJsonDocument doc = QJsonDocument::fromJson(line, &err);
+    if (err.error != QJsonParseError::NoError || !doc.isObject()) {
+        return false;
+    }
+
+    const QJsonObject obj = doc.object();
+    if (!obj.contains("status") || !obj.contains("progress")) {
+        return false;
+    }
+
+    status = HashcatStatus();
+    status.session = obj.value("session").toString();
+    status.status = obj.value("status").toInt(-1);
+    status.target = obj.value("target").toString();
+
+    const QJsonArray progress = obj.value("progress").toArray();
+    status.progressDone = progress.at(0).toInteger();
+    status.progressTotal = progress.at(1).toInteger();
+
+    const QJsonArray recovered = obj.value("recovered_hashes").toArray();
+    status.recoveredDone = recovered.at(0).toInteger();
+    status.recoveredTotal = recovered.at(1).toInteger();
+
+    status.rejected = obj.value("rejected").toInteger();
+    status.timeStart = obj.value("time_start").toInteger();
+    status.estimatedStop = obj.value("estimated_stop").toInteger();
+
+    const QJsonArray devices = obj.value("devices").toArray();
+    for (const QJsonValue &value : devices) {
+        const QJsonObject d = value.toObject();
+        HashcatDeviceStatus device;
+        device.id = d.value("device_id").toInt();
+        device.name = d.value("device_name").toString();
+        device.type = d.value("device_type").toString();
+        device.speed = d.value("speed").toInteger();
+        device.temperature = d.value("temp").toInt(-1);
+        device.utilization = d.value("util").toInt(-1);
+        status.devices.append(device);
+    }
+
+    return true;
+}
@@ -0,0 +1,45 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef HASHCATSTATUS_H
+#define HASHCATSTATUS_H
+
+#include <QString>
+#include <QList>
+#include <QByteArray>
+
+struct HashcatDeviceStatus {
+    int id = 0;
+    QString name;
+    QString type;
+    qint64 speed = 0;
+    // -1 if hashcat doesn't report a value for this device
+    int temperature = -1;
+    int utilization = -1;
+};
+
+// One status update as printed by hashcat with --status-json
+struct HashcatStatus {
+    QString session;
+    int status = -1;
+    QString target;
+    quint64 progressDone = 0;
+    quint64 progressTotal = 0;
+    quint64 recoveredDone = 0;
+    quint64 recoveredTotal = 0;
+    quint64 rejected = 0;
+    qint64 timeStart = 0;
+    qint64 estimatedStop = 0;
+    QList<HashcatDeviceStatus> devices;
+
+    qint64 totalSpeed() const;
+    double progressPercent() const;
+    QString statusText() const;
+
+    // Returns false if the line is not a status object
+    static bool fromJson(const QByteArray &line, HashcatStatus &status);
+};
+
+#endif // HASHCATSTATUS_H
@@ -0,0 +1,328 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "hashfileanalyzer.h"
+#include "hyperloglog.h"
+#include <QFileInfo>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+// Up to this size duplicates are counted exactly, 8 bytes per line are kept for that
+static constexpr qint64 exactLimit = 256 * 1024 * 1024;
+static constexpr int maxSamples = 10;
+static constexpr int maxSampleLength = 100;
+
+struct HashFileAnalyzer::ChunkResult {
+    // All lines including empty ones, for line numbers
+    quint64 physicalLines = 0;
+    quint64 lines = 0;
+    quint64 malformed = 0;
+    quint64 cracked = 0;
+    // Line numbers are relative to the chunk until they are reduced
+    QList<QPair<quint64, QString>> samples;
+    std::vector<quint64> fingerprints;
+    HyperLogLog distinct;
+    bool failed = false;
+};
+
+QString HashFileAnalyzer::Request::key() const
+{
+    return QString("%1|%2|%3|%4|%5|%6|%7|%8").arg(file).arg(size).arg(lastModified).arg(signature.toString()).arg(ignoreUsername)
+        .arg(potfile).arg(potfileSize).arg(potfileModified);
+}
+
+// Splits off the username and validates the rest, returns false for malformed lines
+static bool checkLine(const char *data, qsizetype length, const HashSignature &signature, bool ignoreUsername,
+                      const char **hash, qsizetype *hashLength)
+{
+    *hash = data;
+    *hashLength = length;
+
+    if (ignoreUsername) {
+        const char *colon = static_cast<const char *>(std::memchr(data, ':', static_cast<size_t>(length)));
+        if (!colon) {
+            return false;
+        }
+        *hash = colon + 1;
+        *hashLength = length - (colon + 1 - data);
+    }
+
+    return !signature.isValid() || signature.matches(*hash, *hashLength);
+}
+
+// The potfile has hex fields in lowercase, buffer receives the normalized copy
+static bool isCracked(const char *hash, qsizetype length, const HashSignature &signature, const PotfileIndex &potfile,
+                      QByteArray &buffer)
+{
+    if (potfile.isEmpty()) {
+        return false;
+    }
+    buffer.resize(length);
+    std::memcpy(buffer.data(), hash, static_cast<size_t>(length));
+    signature.normalize(buffer.data(), buffer.size());
+    return potfile.contains(buffer.constData(), buffer.size());
+}
+
+HashFileAnalyzer::HashFileAnalyzer(QObject *parent)
+    : QObject(parent)
+{
+    delayTimer.setSingleShot(true);
+    delayTimer.setInterval(500);
+    connect(&delayTimer, &QTimer::timeout, this, &HashFileAnalyzer::run);
+}
+
+HashFileAnalyzer::~HashFileAnalyzer()
+{
+    // Canceled watchers are still running until their workers notice
+    const QList<QFutureWatcher<HashFileAnalysis> *> watchers = findChildren<QFutureWatcher<HashFileAnalysis> *>();
+    for (QFutureWatcher<HashFileAnalysis> *w : watchers) {
+        w->cancel();
+        w->waitForFinished();
+    }
+}
+
+void HashFileAnalyzer::request(const QString &hashFile, const HashSignature &signature, bool ignoreUsername, const QString &potfile)
+{
+    clear();
+
+    Request r;
+    r.file = hashFile;
+    r.signature = signature;
+    r.ignoreUsername = ignoreUsername;
+    r.potfile = potfile;
+
+    const QFileInfo potfileInfo(potfile);
+    if (!potfile.isEmpty() && potfileInfo.isFile()) {
+        r.potfileSize = potfileInfo.size();
+        r.potfileModified = potfileInfo.lastModified().toMSecsSinceEpoch();
+    }
+
+    const QFileInfo info(hashFile);
+    if (info.isFile()) {
+        r.size = info.size();
+        r.lastModified = info.lastModified().toMSecsSinceEpoch();
+    }
+
+    if (hashFile.trimmed().isEmpty()) {
+        last = HashFileAnalysis();
+        lastKey.clear();
+        return;
+    }
+
+    if (r.key() == lastKey) {
+        emit analyzed(last);
+        return;
+    }
+
+    // A single hash is checked right away, the potfile index might take a moment to load
+    if (r.size < 0 && r.potfileSize < 0) {
+        last = analyzeText(r, PotfileIndex());
+        lastKey = r.key();
+        emit analyzed(last);
+        return;
+    }
+
+    pending = r;
+    delayTimer.start();
+}
+
+void HashFileAnalyzer::clear()
+{
+    delayTimer.stop();
+    ++generation;
+
+    if (watcher) {
+        watcher->cancel();
+        watcher = nullptr;
+    }
+}
+
+bool HashFileAnalyzer::isBusy() const
+{
+    return delayTimer.isActive() || watcher != nullptr;
+}
+
+const HashFileAnalysis &HashFileAnalyzer::result() const
+{
+    return last;
+}
+
+void HashFileAnalyzer::run()
+{
+    const quint64 current = ++generation;
+    const QString key = pending.key();
+
+    // A finished watcher deletes itself, results of older requests are dropped
+    auto *w = new QFutureWatcher<HashFileAnalysis>(this);
+    connect(w, &QFutureWatcher<HashFileAnalysis>::progressValueChanged, this, [this, current](int value) {
+        if (current == generation) {
+            emit progress(value);
+        }
+    });
+    connect(w, &QFutureWatcher<HashFileAnalysis>::finished, this, [this, w, current, key] {
+        w->deleteLater();
+        if (watcher == w) {
+            watcher = nullptr;
+        }
+        if (current != generation || w->isCanceled() || w->future().resultCount() == 0) {
+            return;
+        }
+
+        last = w->result();
+        lastKey = last.error.isEmpty() ? key : QString();
+        emit analyzed(last);
+    });
+
+    watcher = w;
+    emit started();
+    w->setFuture(QtConcurrent::run(&HashFileAnalyzer::analyze, pending));
+}
+
+HashFileAnalysis HashFileAnalyzer::analyzeText(const Request &request, const PotfileIndex &potfile)
+{
+    HashFileAnalysis result;
+    result.file = request.file;
+    result.singleHash = true;
+    result.lines = 1;
+    result.validated = request.signature.isValid();
+    result.signature = request.signature.toString();
+
+    const QByteArray text = request.file.trimmed().toUtf8();
+    const char *hash = nullptr;
+    qsizetype hashLength = 0;
+    if (!checkLine(text.constData(), text.size(), request.signature, request.ignoreUsername, &hash, &hashLength)) {
+        result.malformed = 1;
+        result.samples.append({ 1, QString::fromUtf8(text.left(maxSampleLength)) });
+    }
+
+    QByteArray buffer;
+    result.cracked = isCracked(hash, hashLength, request.signature, potfile, buffer) ? 1 : 0;
+
+    return result;
+}
+
+void HashFileAnalyzer::analyze(QPromise<HashFileAnalysis> &promise, const Request &request)
+{
+    HashFileAnalysis analysis;
+    analysis.file = request.file;
+    analysis.validated = request.signature.isValid();
+    analysis.signature = request.signature.toString();
+
+    // Only the lines appended to the potfile since the last analysis are read
+    PotfileIndex potfile;
+    if (request.potfileSize >= 0) {
+        QString error;
+        analysis.potfileChecked = potfile.update(request.potfile, &error);
+        if (!analysis.potfileChecked) {
+            qWarning("%s", qPrintable(error));
+        }
+    }
+
+    if (request.size < 0) {
+        HashFileAnalysis text = analyzeText(request, potfile);
+        text.potfileChecked = analysis.potfileChecked;
+        promise.addResult(text);
+        return;
+    }
+
+    // Every worker analyzes one chunk, lines belong to the chunk they start in
+    const QList<FileChunks::Chunk> chunks = FileChunks::split(request.file, request.size);
+
+    promise.setProgressRange(0, 100);
+    int done = 0;
+
+    // Ordered, so the line numbers of the samples can be made absolute
+    ChunkResult total = QtConcurrent::blockingMappedReduced<ChunkResult>(
+        chunks,
+        [&promise, &request, &potfile](const FileChunks::Chunk &chunk) {
+            return promise.isCanceled() ? ChunkResult() : analyzeChunk(chunk, request, potfile);
+        },
+        [&promise, &done, &chunks](ChunkResult &result, const ChunkResult &chunk) {
+            for (const auto &sample : chunk.samples) {
+                if (result.samples.size() < maxSamples) {
+                    result.samples.append({ result.physicalLines + sample.first, sample.second });
+                }
+            }
+            result.physicalLines += chunk.physicalLines;
+            result.lines += chunk.lines;
+            result.malformed += chunk.malformed;
+            result.cracked += chunk.cracked;
+            result.failed |= chunk.failed;
+
+            // Both are sorted, merging keeps the whole list sorted
+            const auto middle = static_cast<std::ptrdiff_t>(result.fingerprints.size());
+            result.fingerprints.insert(result.fingerprints.end(), chunk.fingerprints.begin(), chunk.fingerprints.end());
+            std::inplace_merge(result.fingerprints.begin(), result.fingerprints.begin() + middle, result.fingerprints.end());
+            result.distinct.merge(chunk.distinct);
+
+            promise.setProgressValue(static_cast<int>(100 * ++done / chunks.size()));
+        },
+        QtConcurrent::OrderedReduce);
+
+    if (promise.isCanceled()) {
+        return;
+    }
+
+    if (total.failed) {
+        analysis.error = tr("Could not read %1.").arg(request.file);
+        promise.addResult(analysis);
+        return;
+    }
+
+    analysis.lines = total.lines;
+    analysis.malformed = total.malformed;
+    analysis.cracked = total.cracked;
+    analysis.samples = total.samples;
+
+    if (request.size <= exactLimit) {
+        for (size_t i = 1; i < total.fingerprints.size(); ++i) {
+            analysis.duplicates += total.fingerprints[i] == total.fingerprints[i - 1] ? 1 : 0;
+        }
+    } else {
+        analysis.duplicates = total.lines - qMin(total.distinct.estimate(), total.lines);
+        analysis.duplicatesEstimated = true;
+    }
+
+    promise.addResult(analysis);
+}
+
+HashFileAnalyzer::ChunkResult HashFileAnalyzer::analyzeChunk(const FileChunks::Chunk &chunk, const Request &request,
+                                                             const PotfileIndex &potfile)
+{
+    ChunkResult result;
+    const bool exact = chunk.fileSize <= exactLimit;
+    QByteArray buffer;
+
+    result.failed = !FileChunks::forEachLine(chunk, [&](const char *line, qsizetype length) {
+        ++result.physicalLines;
+        if (length == 0) {
+            return;
+        }
+        ++result.lines;
+
+        const char *hash = nullptr;
+        qsizetype hashLength = 0;
+        if (!checkLine(line, length, request.signature, request.ignoreUsername, &hash, &hashLength)) {
+            ++result.malformed;
+            if (result.samples.size() < maxSamples) {
+                result.samples.append({ result.physicalLines, QString::fromUtf8(line, qMin<qsizetype>(length, maxSampleLength)) });
+            }
+        }
+        result.cracked += isCracked(hash, hashLength, request.signature, potfile, buffer) ? 1 : 0;
+
+        // Duplicates are judged by the hash alone, like hashcat does with --username
+        const quint64 h = HyperLogLog::hash(hash, hashLength);
+        if (exact) {
+            result.fingerprints.push_back(h);
+        } else {
+            result.distinct.add(h);
+        }
+    });
+
+    std::sort(result.fingerprints.begin(), result.fingerprints.end());
+    return result;
+}
@@ -0,0 +1,93 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef HASHFILEANALYZER_H
+#define HASHFILEANALYZER_H
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QList>
+#include <QPair>
+#include <QPromise>
+#include <QTimer>
+#include "filechunks.h"
+#include "hashsignature.h"
+#include "potfileindex.h"
+
+struct HashFileAnalysis {
+    QString file;
+    // The hash field did not name a file, its text was checked as one hash
+    bool singleHash = false;
+    // Empty lines are not counted, hashcat skips them
+    quint64 lines = 0;
+    quint64 duplicates = 0;
+    // Large files only get a HyperLogLog estimate of the duplicates
+    bool duplicatesEstimated = false;
+    // False if the hash mode has no usable example hash
+    bool validated = false;
+    quint64 malformed = 0;
+    // Lines whose hash is in the potfile, false if there is no potfile to check against
+    bool potfileChecked = false;
+    quint64 cracked = 0;
+    // First malformed lines with their line numbers
+    QList<QPair<quint64, QString>> samples;
+    QString signature;
+    QString error;
+};
+
+// Counts hashes, duplicates and lines that don't match the hash mode on all cores
+class HashFileAnalyzer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit HashFileAnalyzer(QObject *parent = nullptr);
+    ~HashFileAnalyzer();
+
+    // Analyze once the input stops changing, an unchanged file is not read again.
+    // hashFile is checked as a single hash if it does not name a file. Hashes found in potfile
+    // are counted as cracked, a changed potfile counts as a change of the input.
+    void request(const QString &hashFile, const HashSignature &signature, bool ignoreUsername, const QString &potfile = QString());
+    // Drop pending and running requests
+    void clear();
+
+    bool isBusy() const;
+    // Last finished analysis, its file is empty if there is none
+    const HashFileAnalysis &result() const;
+
+signals:
+    void started();
+    void progress(int percent);
+    void analyzed(const HashFileAnalysis &analysis);
+
+private:
+    struct Request {
+        QString file;
+        HashSignature signature;
+        bool ignoreUsername = false;
+        qint64 size = -1;
+        qint64 lastModified = 0;
+        QString potfile;
+        qint64 potfileSize = -1;
+        qint64 potfileModified = 0;
+
+        QString key() const;
+    };
+    struct ChunkResult;
+
+    QTimer delayTimer;
+    QFutureWatcher<HashFileAnalysis> *watcher = nullptr;
+    quint64 generation = 0;
+    Request pending;
+    QString lastKey;
+    HashFileAnalysis last;
+
+    void run();
+    static void analyze(QPromise<HashFileAnalysis> &promise, const Request &request);
+    static HashFileAnalysis analyzeText(const Request &request, const PotfileIndex &potfile);
+    static ChunkResult analyzeChunk(const FileChunks::Chunk &chunk, const Request &request, const PotfileIndex &potfile);
+};
+
+#endif // HASHFILEANALYZER_H
@@ -0,0 +1,276 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "hashmodecatalog.h"
+#include "hashcatrunner.h"
+#include "settingsmanager.h"
+#include "startuptrace.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtConcurrent>
+
+HashModeCatalog::HashModeCatalog(QObject *parent)
+    : QObject(parent)
+{
+    connect(&cacheWatcher, &QFutureWatcher<Cache>::finished, this, &HashModeCatalog::cacheRead);
+}
+
+bool HashModeCatalog::Fingerprint::operator==(const Fingerprint &other) const
+{
+    return path == other.path && size == other.size && lastModified == other.lastModified;
+}
+
+const QMap<quint32, HashMode> &HashModeCatalog::modes() const
+{
+    return hashModes;
+}
+
+QString HashModeCatalog::hashcatVersion() const
+{
+    return version;
+}
+
+bool HashModeCatalog::isRefreshing() const
+{
+    return refreshing;
+}
+
+// Path and file attributes of the currently configured hashcat binary
+HashModeCatalog::Fingerprint HashModeCatalog::currentFingerprint()
+{
+    Fingerprint fp;
+    fp.path = SettingsManager::instance().getKey<QString>("hashcatPath");
+
+    QFileInfo fileInfo(fp.path);
+    if (!fp.path.isEmpty() && fileInfo.exists()) {
+        fp.size = fileInfo.size();
+        fp.lastModified = fileInfo.lastModified().toMSecsSinceEpoch();
+    }
+
+    return fp;
+}
+
+// Path to the cached catalog JSON
+QString HashModeCatalog::cacheFile()
+{
+    const QString dirPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dirPath);
+    return QDir(dirPath).filePath("hash_modes.json");
+}
+
+/*
+ * Both the output of "--example-hashes --machine-readable" and our cache use the
+ * same layout: an object keyed by hash mode id, e.g.
+ *
+ * { "1000": { "name": "NTLM", "category": "Operating System", "example_hash": "...", ... } }
+ */
+QMap<quint32, HashMode> HashModeCatalog::parseModes(const QJsonObject &obj)
+{
+    QMap<quint32, HashMode> modes;
+
+    for (auto it = obj.constBegin(); it != obj.constEnd(); ++it) {
+        bool ok = false;
+        const quint32 id = it.key().toUInt(&ok);
+        if (!ok) {
+            continue;
+        }
+
+        const QJsonObject entry = it.value().toObject();
+        HashMode mode;
+        mode.id = id;
+        mode.name = entry.value("name").toString();
+        mode.category = entry.value("category").toString();
+        mode.exampleHash = entry.value("example_hash").toString();
+        mode.exampleHashFormat = entry.value("example_hash_format").toString("plain");
+        mode.slowHash = entry.value("slow_hash").toBool();
+        mode.salted = entry.value("is_salted").toBool();
+        modes.insert(id, mode);
+    }
+
+    return modes;
+}
+
+QJsonObject HashModeCatalog::modesToJson(const QMap<quint32, HashMode> &modes)
+{
+    QJsonObject obj;
+
+    for (const HashMode &mode : modes) {
+        QJsonObject entry;
+        entry["name"] = mode.name;
+        entry["category"] = mode.category;
+        entry["example_hash"] = mode.exampleHash;
+        entry["example_hash_format"] = mode.exampleHashFormat;
+        entry["slow_hash"] = mode.slowHash;
+        entry["is_salted"] = mode.salted;
+        obj[QString::number(mode.id)] = entry;
+    }
+
+    return obj;
+}
+
+// Runs in a worker thread, the catalog is several hundred KB of JSON
+HashModeCatalog::Cache HashModeCatalog::readCache(const QString &file)
+{
+    StartupTrace::Scope scope("hash mode cache");
+    Cache cache;
+
+    QFile f(file);
+    if (!f.open(QIODevice::ReadOnly)) {
+        return cache;
+    }
+
+    QJsonDocument doc = QJsonDocument::fromJson(f.readAll());
+    if (!doc.isObject()) {
+        return cache;
+    }
+
+    QJsonObject root = doc.object();
+    cache.fingerprint.path = root.value("hashcatPath").toString();
+    cache.fingerprint.size = root.value("size").toInteger(-1);
+    cache.fingerprint.lastModified = root.value("lastModified").toInteger(-1);
+    cache.version = root.value("version").toString();
+    cache.modes = parseModes(root.value("modes").toObject());
+
+    return cache;
+}
+
+void HashModeCatalog::writeCache() const
+{
+    QJsonObject root;
+    root["hashcatPath"] = cachedFingerprint.path;
+    root["size"] = cachedFingerprint.size;
+    root["lastModified"] = cachedFingerprint.lastModified;
+    root["version"] = version;
+    root["modes"] = modesToJson(hashModes);
+
+    QSaveFile f(cacheFile());
+    if (!f.open(QIODevice::WriteOnly)) {
+        qWarning("Could not write hash mode cache to %s", qPrintable(f.fileName()));
+        return;
+    }
+    f.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    if (!f.commit()) {
+        qWarning("Could not write hash mode cache to %s", qPrintable(f.fileName()));
+    }
+}
+
+void HashModeCatalog::load()
+{
+    const Fingerprint current = currentFingerprint();
+    if (current.path.isEmpty()) {
+        return;
+    }
+
+    // The fingerprint is checked once the cache is read
+    if (cacheWatcher.isRunning()) {
+        return;
+    }
+
+    // Warm start: serve the cached catalog without blocking the window
+    if (hashModes.isEmpty()) {
+        cacheWatcher.setFuture(QtConcurrent::run(&HashModeCatalog::readCache, cacheFile()));
+        return;
+    }
+
+    // The binary changed since the cache was written
+    if (!(cachedFingerprint == current)) {
+        refresh();
+    }
+}
+
+void HashModeCatalog::cacheRead()
+{
+    Cache cache = cacheWatcher.result();
+
+    // A query that finished in the meantime is newer than the cache
+    if (hashModes.isEmpty() && !cache.modes.isEmpty()) {
+        cachedFingerprint = cache.fingerprint;
+        version = cache.version;
+        hashModes = std::move(cache.modes);
+        emit updated();
+    }
+
+    // Cold start or the binary changed since the cache was written
+    if (hashModes.isEmpty() || !(cachedFingerprint == currentFingerprint())) {
+        refresh();
+        return;
+    }
+
+    checkVersion();
+}
+
+// A wrapper script or an update that kept the file attributes leaves the fingerprint as it was,
+// the version still tells a stale catalog apart
+void HashModeCatalog::checkVersion()
+{
+    if (refreshing) {
+        return;
+    }
+
+    HashcatRunner *runner = HashcatRunner::run(QStringList() << "--version", this);
+    connect(runner, &HashcatRunner::finished, this, [this](const HashcatResult &result) {
+        if (result.exitStatus == QProcess::NormalExit && result.exitCode == 0 && result.standardOutput.trimmed() != version) {
+            refresh();
+        }
+    });
+}
+
+void HashModeCatalog::refresh()
+{
+    if (refreshing) {
+        return;
+    }
+
+    refreshing = true;
+
+    // Ask for the version first, it is part of the cache key
+    HashcatRunner *runner = HashcatRunner::run(QStringList() << "--version", this);
+    connect(runner, &HashcatRunner::finished, this, [this](const HashcatResult &result) {
+        if (result.exitStatus == QProcess::NormalExit && result.exitCode == 0) {
+            version = result.standardOutput.trimmed();
+        }
+
+        queryModes();
+    });
+}
+
+void HashModeCatalog::queryModes()
+{
+    // Capture the fingerprint of the binary that is actually being queried
+    const Fingerprint queried = currentFingerprint();
+
+    // The catalog is several hundred KB of JSON, it has to be captured completely
+    HashcatRunner *runner = new HashcatRunner(this);
+    runner->setCaptureLimit(16 * 1024 * 1024);
+    connect(runner, &HashcatRunner::finished, runner, &QObject::deleteLater);
+    connect(runner, &HashcatRunner::finished, this, [this, queried](const HashcatResult &result) {
+        refreshing = false;
+
+        // Check if the command failed
+        if (result.exitStatus != QProcess::NormalExit || result.exitCode != 0) {
+            emit failed(tr("Failed to obtain supported hash types.\nError: %1").arg(result.standardError));
+            return;
+        }
+
+        QJsonDocument doc = QJsonDocument::fromJson(result.standardOutput.toUtf8());
+        if (result.truncated || !doc.isObject()) {
+            emit failed(tr("Invalid JSON returned from hashcat."));
+            return;
+        }
+
+        hashModes = parseModes(doc.object());
+        cachedFingerprint = queried;
+        writeCache();
+
+        emit updated();
+    });
+
+    runner->start(QStringList() << "--example-hashes" << "--machine-readable");
+}
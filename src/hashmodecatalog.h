@@ -0,0 +1,80 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef HASHMODECATALOG_H
+#define HASHMODECATALOG_H
+
+#include <QObject>
+#include <QMap>
+#include <QString>
+#include <QJsonObject>
+#include <QFutureWatcher>
+
+struct HashMode {
+    quint32 id = 0;
+    QString name;
+    QString category;
+    QString exampleHash;
+    // "plain", or "hex-encoded" for modes that take binary files
+    QString exampleHashFormat = "plain";
+    bool slowHash = false;
+    bool salted = false;
+};
+
+class HashModeCatalog : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit HashModeCatalog(QObject *parent = nullptr);
+
+    // Load cached modes and query hashcat if the binary changed, both in the background
+    void load();
+    // Query hashcat regardless of the cache state
+    void refresh();
+
+    bool isRefreshing() const;
+    QString hashcatVersion() const;
+    const QMap<quint32, HashMode> &modes() const;
+
+signals:
+    void updated();
+    void failed(const QString &error);
+
+private:
+    // Identifies the hashcat binary the cached catalog was generated with
+    struct Fingerprint {
+        QString path;
+        qint64 size = -1;
+        qint64 lastModified = -1;
+
+        bool operator==(const Fingerprint &other) const;
+    };
+
+    struct Cache {
+        Fingerprint fingerprint;
+        QString version;
+        QMap<quint32, HashMode> modes;
+    };
+
+    QMap<quint32, HashMode> hashModes;
+    QString version;
+    Fingerprint cachedFingerprint;
+    bool refreshing = false;
+    QFutureWatcher<Cache> cacheWatcher;
+
+    static Fingerprint currentFingerprint();
+    static QString cacheFile();
+    static QMap<quint32, HashMode> parseModes(const QJsonObject &obj);
+    static QJsonObject modesToJson(const QMap<quint32, HashMode> &modes);
+    static Cache readCache(const QString &file);
+
+    void cacheRead();
+    void checkVersion();
+    void writeCache() const;
+    void queryModes();
+};
+
+#endif // HASHMODECATALOG_H
@@ -0,0 +1,238 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "hashmodemodel.h"
+#include <QRegularExpression>
+#include <algorithm>
+#include <numeric>
+
+/* ---------- HashModeModel ---------- */
+
+HashModeModel::HashModeModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int HashModeModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : rows.size();
+}
+
+QVariant HashModeModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rows.size()) {
+        return QVariant();
+    }
+
+    const HashMode &mode = rows.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+        return displayText(mode);
+    case Qt::ToolTipRole:
+        return index.row() < recentRows ? tr("%1, recently used").arg(mode.category) : mode.category;
+    case IdRole:
+        return mode.id;
+    case RecentRole:
+        return index.row() < recentRows;
+    }
+    return QVariant();
+}
+
+void HashModeModel::setModes(const QMap<quint32, HashMode> &modes)
+{
+    beginResetModel();
+    order(modes);
+    endResetModel();
+}
+
+void HashModeModel::setRecent(const QList<quint32> &ids)
+{
+    recentIds = ids.mid(0, maxRecent);
+    if (rows.isEmpty()) {
+        return;
+    }
+
+    QMap<quint32, HashMode> modes;
+    for (const HashMode &mode : std::as_const(rows)) {
+        modes.insert(mode.id, mode);
+    }
+
+    emit layoutAboutToBeChanged();
+    const QModelIndexList before = persistentIndexList();
+    order(modes);
+
+    QModelIndexList after;
+    after.reserve(before.size());
+    for (const QModelIndex &index : before) {
+        after << this->index(rowOf(index.data(IdRole).toUInt()));
+    }
+    changePersistentIndexList(before, after);
+    emit layoutChanged();
+}
+
+const QList<quint32> &HashModeModel::recent() const
+{
+    return recentIds;
+}
+
+int HashModeModel::rowOf(quint32 id) const
+{
+    return rowById.value(id, -1);
+}
+
+QString HashModeModel::displayText(const HashMode &mode)
+{
+    return QString::number(mode.id) + " | " + mode.name;
+}
+
+// Recently used modes in the order they were used, then all others by id
+void HashModeModel::order(const QMap<quint32, HashMode> &modes)
+{
+    rows.clear();
+    rowById.clear();
+    rows.reserve(modes.size());
+
+    for (quint32 id : std::as_const(recentIds)) {
+        auto it = modes.constFind(id);
+        if (it != modes.constEnd()) {
+            rowById.insert(id, rows.size());
+            rows << *it;
+        }
+    }
+    recentRows = rows.size();
+
+    for (const HashMode &mode : modes) {
+        if (!rowById.contains(mode.id)) {
+            rowById.insert(mode.id, rows.size());
+            rows << mode;
+        }
+    }
+}
+
+/* ---------- HashModeFilterModel ---------- */
+
+HashModeFilterModel::HashModeFilterModel(QObject *parent)
+    : QSortFilterProxyModel(parent)
+{
+}
+
+void HashModeFilterModel::setSourceModel(QAbstractItemModel *model)
+{
+    if (sourceModel()) {
+        disconnect(sourceModel(), &QAbstractItemModel::modelReset, this, &HashModeFilterModel::buildIndex);
+    }
+
+    QSortFilterProxyModel::setSourceModel(model);
+
+    // Reordering the recently used modes keeps the ids, only a new catalog needs a new index
+    if (model) {
+        connect(model, &QAbstractItemModel::modelReset, this, &HashModeFilterModel::buildIndex);
+    }
+    buildIndex();
+}
+
+void HashModeFilterModel::setQuery(const QString &query)
+{
+    static const QRegularExpression separator("[\\s|]+");
+    const QStringList words = query.toLower().split(separator, Qt::SkipEmptyParts);
+
+    filtering = !words.isEmpty();
+    matches.fill(true, texts.size());
+
+    for (const QString &word : words) {
+        QVector<bool> found(texts.size(), false);
+        for (int entry : candidates(word)) {
+            // Having every trigram of the word does not mean it appears in one piece
+            found[entry] = matches.at(entry) && texts.at(entry).contains(word);
+        }
+        matches = std::move(found);
+    }
+
+    invalidateFilter();
+}
+
+bool HashModeFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    if (!filtering) {
+        return true;
+    }
+
+    const quint32 id = sourceModel()->index(sourceRow, 0, sourceParent).data(HashModeModel::IdRole).toUInt();
+    const int entry = entryById.value(id, -1);
+    return entry >= 0 && matches.at(entry);
+}
+
+void HashModeFilterModel::buildIndex()
+{
+    texts.clear();
+    entryById.clear();
+    trigrams.clear();
+
+    const int count = sourceModel() ? sourceModel()->rowCount() : 0;
+    texts.reserve(count);
+
+    for (int row = 0; row < count; ++row) {
+        const QModelIndex index = sourceModel()->index(row, 0);
+        const quint32 id = index.data(HashModeModel::IdRole).toUInt();
+        // The display text is "id | name", the separator is not searchable
+        const QString text = index.data().toString().toLower().remove(" |");
+
+        const int entry = texts.size();
+        entryById.insert(id, entry);
+        texts << text;
+
+        for (int pos = 0; pos + 3 <= text.size(); ++pos) {
+            QVector<int> &entries = trigrams[trigram(text, pos)];
+            // A trigram can repeat within a name, entries are added in ascending order
+            if (entries.isEmpty() || entries.last() != entry) {
+                entries << entry;
+            }
+        }
+    }
+
+    matches.fill(true, texts.size());
+    filtering = false;
+    invalidateFilter();
+}
+
+// Entries that contain every trigram of the word, all entries for words too short to have one
+QVector<int> HashModeFilterModel::candidates(const QString &word) const
+{
+    QVector<int> result;
+    if (word.size() < 3) {
+        result.resize(texts.size());
+        std::iota(result.begin(), result.end(), 0);
+        return result;
+    }
+
+    QVector<const QVector<int> *> lists;
+    for (int pos = 0; pos + 3 <= word.size(); ++pos) {
+        auto it = trigrams.constFind(trigram(word, pos));
+        if (it == trigrams.constEnd()) {
+            return result;
+        }
+        lists << &*it;
+    }
+
+    // Start with the rarest trigram and drop everything missing from the others
+    std::sort(lists.begin(), lists.end(), [](const QVector<int> *a, const QVector<int> *b) {
+        return a->size() < b->size();
+    });
+    for (int entry : *lists.first()) {
+        const bool inAll = std::all_of(lists.begin() + 1, lists.end(), [entry](const QVector<int> *list) {
+            return std::binary_search(list->begin(), list->end(), entry);
+        });
+        if (inAll) {
+            result << entry;
+        }
+    }
+    return result;
+}
+
+quint64 HashModeFilterModel::trigram(const QString &text, int pos)
+{
+    return (quint64(text.at(pos).unicode()) << 32) | (quint64(text.at(pos + 1).unicode()) << 16) | text.at(pos + 2).unicode();
+}
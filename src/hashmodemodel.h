@@ -0,0 +1,84 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef HASHMODEMODEL_H
+#define HASHMODEMODEL_H
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QList>
+#include <QSortFilterProxyModel>
+#include <QVector>
+#include "hashmodecatalog.h"
+
+// The hash modes of the catalog as "id | name" rows, recently used modes first
+class HashModeModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Role
+    {
+        IdRole = Qt::UserRole,
+        RecentRole,
+    };
+
+    // How many recently used modes are pinned at the top
+    static constexpr int maxRecent = 5;
+
+    explicit HashModeModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    void setModes(const QMap<quint32, HashMode> &modes);
+    // Moves the rows instead of resetting the model, views keep their selection
+    void setRecent(const QList<quint32> &ids);
+    const QList<quint32> &recent() const;
+
+    // -1 if the mode is not in the catalog
+    int rowOf(quint32 id) const;
+    static QString displayText(const HashMode &mode);
+
+private:
+    QList<HashMode> rows;
+    QHash<quint32, int> rowById;
+    QList<quint32> recentIds;
+    int recentRows = 0;
+
+    void order(const QMap<quint32, HashMode> &modes);
+};
+
+// Filters the hash modes by words of the id or name, e.g. "ntlm", "1000" or "kerberos 5 tgs".
+// Every word has to appear somewhere, words of three or more characters are looked up
+// in a trigram index so each keystroke only verifies a handful of candidates.
+class HashModeFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit HashModeFilterModel(QObject *parent = nullptr);
+
+    void setSourceModel(QAbstractItemModel *model) override;
+    void setQuery(const QString &query);
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    // Lower-case "id name" of every mode, indexed by position
+    QVector<QString> texts;
+    QHash<quint32, int> entryById;
+    // Trigram -> ascending positions of the texts containing it
+    QHash<quint64, QVector<int>> trigrams;
+    QVector<bool> matches;
+    bool filtering = false;
+
+    void buildIndex();
+    QVector<int> candidates(const QString &word) const;
+    static quint64 trigram(const QString &text, int pos);
+};
+
+#endif // HASHMODEMODEL_H
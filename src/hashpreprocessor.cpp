@@ -0,0 +1,363 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "hashpreprocessor.h"
+#include "filechunks.h"
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtConcurrent>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+// Progress of the normalize, merge and shard steps out of 1000
+static constexpr int normalizeEnd = 300;
+static constexpr int mergeEnd = 900;
+
+namespace {
+
+struct NormalizedChunk {
+    QByteArray data;
+    quint64 lines = 0;
+    quint64 cracked = 0;
+    bool failed = false;
+};
+
+bool isBlank(char c)
+{
+    return c == ' ' || c == '\t';
+}
+
+NormalizedChunk normalizeChunk(const FileChunks::Chunk &chunk, const HashPreprocessOptions &options, const PotfileIndex &potfile)
+{
+    NormalizedChunk result;
+    result.data.reserve(chunk.end - chunk.begin);
+
+    result.failed = !FileChunks::forEachLine(chunk, [&](const char *line, qsizetype length) {
+        while (length > 0 && isBlank(line[0])) {
+            ++line;
+            --length;
+        }
+        while (length > 0 && isBlank(line[length - 1])) {
+            --length;
+        }
+
+        if (options.stripUsername) {
+            const char *colon = static_cast<const char *>(std::memchr(line, ':', static_cast<size_t>(length)));
+            if (colon) {
+                length -= colon + 1 - line;
+                line = colon + 1;
+            }
+        }
+
+        // hashcat skips empty lines anyway
+        if (length == 0) {
+            return;
+        }
+
+        const qsizetype offset = result.data.size();
+        result.data.append(line, length);
+        options.signature.normalize(result.data.data() + offset, length);
+        ++result.lines;
+
+        if (potfile.contains(result.data.constData() + offset, length)) {
+            result.data.truncate(offset);
+            ++result.cracked;
+            return;
+        }
+        result.data.append('\n');
+    });
+
+    return result;
+}
+
+} // namespace
+
+HashPreprocessResult HashPreprocessor::preprocess(const HashPreprocessOptions &options, const WordlistMerger::Progress &progress)
+{
+    HashPreprocessResult result;
+
+    auto fail = [&result](const QString &error) {
+        result.error = error;
+        return result;
+    };
+
+    const QFileInfo info(options.hashFile);
+    if (!info.isFile()) {
+        return fail(QCoreApplication::translate("HashPreprocessor", "%1 is not a file.").arg(options.hashFile));
+    }
+
+    const QDir dir(outputDirectory());
+    const QString key = fileKey(options.hashFile);
+    const QString manifestFile = dir.filePath(key + ".json");
+    const QJsonObject optionsJson = optionsToJson(options);
+    const qint64 lastModified = info.lastModified().toMSecsSinceEpoch();
+
+    /* ---------- Reuse the last result if neither file nor options changed ---------- */
+
+    QFile manifest(manifestFile);
+    if (manifest.open(QIODevice::ReadOnly)) {
+        const QJsonObject obj = QJsonDocument::fromJson(manifest.readAll()).object();
+        manifest.close();
+
+        if (obj.value("size").toInteger(-1) == info.size() && obj.value("lastModified").toInteger() == lastModified
+            && obj.value("options").toObject() == optionsJson) {
+            const QJsonArray files = obj.value("files").toArray();
+            for (const QJsonValue &file : files) {
+                result.files << dir.filePath(file.toString());
+            }
+
+            const bool complete = !result.files.isEmpty() && std::all_of(result.files.cbegin(), result.files.cend(), [](const QString &file) {
+                return QFileInfo::exists(file);
+            });
+            if (complete) {
+                result.lines = obj.value("lines").toInteger();
+                result.unique = obj.value("unique").toInteger();
+                result.cracked = obj.value("cracked").toInteger();
+                result.cached = true;
+                return result;
+            }
+            result.files.clear();
+        }
+    }
+
+    /* ---------- Normalize on all cores ---------- */
+
+    PotfileIndex potfile;
+    QString potfileError;
+    if (!options.potfile.isEmpty() && !potfile.update(options.potfile, &potfileError)) {
+        return fail(potfileError);
+    }
+
+    // Every run writes into its own directory, queued jobs may still use the files of earlier runs
+    const QString runName = QString("%1-%2").arg(key, QString::number(QDateTime::currentMSecsSinceEpoch(), 36));
+    if (!dir.mkpath(runName)) {
+        return fail(QCoreApplication::translate("HashPreprocessor", "Could not create %1.").arg(dir.filePath(runName)));
+    }
+    QDir runDir(dir.filePath(runName));
+
+    const QString normalizedFile = runDir.filePath("normalized");
+    QFile normalized(normalizedFile);
+    if (!normalized.open(QIODevice::WriteOnly)) {
+        const QString error = normalized.errorString();
+        runDir.removeRecursively();
+        return fail(QCoreApplication::translate("HashPreprocessor", "Could not write %1: %2").arg(normalizedFile, error));
+    }
+
+    const QList<FileChunks::Chunk> chunks = FileChunks::split(options.hashFile, info.size());
+    std::atomic<bool> canceled = false;
+    bool failed = false;
+    int done = 0;
+
+    // Order does not matter, the merge sorts the lines anyway
+    QtConcurrent::blockingMappedReduced<int>(
+        chunks,
+        [&options, &canceled, &potfile](const FileChunks::Chunk &chunk) {
+            return canceled ? NormalizedChunk() : normalizeChunk(chunk, options, potfile);
+        },
+        [&](int &, const NormalizedChunk &chunk) {
+            failed |= chunk.failed || normalized.write(chunk.data) != chunk.data.size();
+            result.lines += chunk.lines;
+            result.cracked += chunk.cracked;
+            canceled = canceled || !progress(normalizeEnd * ++done / static_cast<int>(chunks.size()));
+        },
+        QtConcurrent::UnorderedReduce);
+
+    normalized.close();
+    failed |= normalized.error() != QFileDevice::NoError;
+
+    if (canceled || failed) {
+        runDir.removeRecursively();
+        return canceled ? result : fail(QCoreApplication::translate("HashPreprocessor", "Could not normalize %1.").arg(options.hashFile));
+    }
+
+    if (result.cracked > 0 && result.cracked == result.lines) {
+        runDir.removeRecursively();
+        return fail(QCoreApplication::translate("HashPreprocessor", "All hashes in %1 are already cracked.").arg(options.hashFile));
+    }
+
+    /* ---------- Deduplicate with the external merge sort of the wordlist merger ---------- */
+
+    const bool shard = options.shardSize > 0 && result.lines - result.cracked > options.shardSize;
+    const QString hashesFile = runDir.filePath("hashes");
+    const QString mergedFile = shard ? runDir.filePath("merged") : hashesFile;
+
+    WordlistMergeOptions mergeOptions;
+    mergeOptions.inputs = QStringList { normalizedFile };
+    mergeOptions.output = mergedFile;
+    mergeOptions.memoryLimit = options.memoryLimit;
+
+    const WordlistMergeResult merged = WordlistMerger::merge(mergeOptions, [&progress](int value) {
+        return progress(normalizeEnd + value * (mergeEnd - normalizeEnd) / 1000);
+    });
+    QFile::remove(normalizedFile);
+
+    if (!merged.error.isEmpty()) {
+        runDir.removeRecursively();
+        return fail(merged.error);
+    }
+    if (!progress(mergeEnd)) {
+        runDir.removeRecursively();
+        return result;
+    }
+    result.unique = merged.unique;
+
+    /* ---------- Split into shards that run one after another ---------- */
+
+    if (!shard || result.unique <= options.shardSize) {
+        // Deduplication might have brought the file below the shard size
+        if (mergedFile != hashesFile && !QFile::rename(mergedFile, hashesFile)) {
+            runDir.removeRecursively();
+            return fail(QCoreApplication::translate("HashPreprocessor", "Could not write %1.").arg(hashesFile));
+        }
+        result.files << hashesFile;
+    } else {
+        QFile in(mergedFile);
+        if (!in.open(QIODevice::ReadOnly)) {
+            const QString error = in.errorString();
+            runDir.removeRecursively();
+            return fail(QCoreApplication::translate("HashPreprocessor", "Could not read %1: %2").arg(mergedFile, error));
+        }
+
+        QFile out;
+        quint64 written = 0;
+        while (!in.atEnd()) {
+            if (written % options.shardSize == 0) {
+                // Closing flushes the rest of the previous shard
+                out.close();
+                if (out.error() != QFileDevice::NoError) {
+                    failed = true;
+                    break;
+                }
+                out.setFileName(runDir.filePath(QString("hashes-%1").arg(result.files.size() + 1)));
+                if (!out.open(QIODevice::WriteOnly)) {
+                    failed = true;
+                    break;
+                }
+                result.files << out.fileName();
+
+                if (!progress(mergeEnd + static_cast<int>((1000 - mergeEnd) * written / result.unique))) {
+                    canceled = true;
+                    break;
+                }
+            }
+
+            const QByteArray line = in.readLine();
+            if (out.write(line) != line.size()) {
+                failed = true;
+                break;
+            }
+            ++written;
+        }
+
+        out.close();
+        failed |= out.error() != QFileDevice::NoError;
+        in.close();
+        QFile::remove(mergedFile);
+
+        if (canceled || failed) {
+            const QString error = QCoreApplication::translate("HashPreprocessor", "Could not write %1: %2").arg(out.fileName(), out.errorString());
+            runDir.removeRecursively();
+            result.files.clear();
+            return canceled ? result : fail(error);
+        }
+    }
+
+    /* ---------- Remember the result for the next launch ---------- */
+
+    QJsonArray files;
+    for (const QString &file : std::as_const(result.files)) {
+        files.append(dir.relativeFilePath(file));
+    }
+
+    QJsonObject obj;
+    obj["source"] = info.absoluteFilePath();
+    obj["size"] = info.size();
+    obj["lastModified"] = lastModified;
+    obj["options"] = optionsJson;
+    obj["lines"] = static_cast<qint64>(result.lines);
+    obj["unique"] = static_cast<qint64>(result.unique);
+    obj["cracked"] = static_cast<qint64>(result.cracked);
+    obj["files"] = files;
+
+    // Only written once every shard is complete, a manifest must never point to a partial run
+    QSaveFile manifestOut(manifestFile);
+    if (!manifestOut.open(QIODevice::WriteOnly)) {
+        qWarning("Could not write %s", qPrintable(manifestFile));
+    } else {
+        manifestOut.write(QJsonDocument(obj).toJson(QJsonDocument::Indented));
+        if (!manifestOut.commit()) {
+            qWarning("Could not write %s", qPrintable(manifestFile));
+        }
+    }
+
+    // Earlier runs are outdated now, but a queued job might not have run yet
+    const QFileInfoList runs = dir.entryInfoList({ key + "-*" }, QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QFileInfo &run : runs) {
+        const QString prefix = run.absoluteFilePath() + '/';
+        const bool used = std::any_of(options.inUse.cbegin(), options.inUse.cend(), [&prefix](const QString &file) {
+            return QFileInfo(file).absoluteFilePath().startsWith(prefix);
+        });
+        if (run.fileName() != runName && !used) {
+            QDir(run.absoluteFilePath()).removeRecursively();
+        }
+    }
+
+    progress(1000);
+    return result;
+}
+
+void HashPreprocessor::run(QPromise<HashPreprocessResult> &promise, const HashPreprocessOptions &options)
+{
+    promise.setProgressRange(0, 1000);
+
+    const HashPreprocessResult result = preprocess(options, [&promise](int value) {
+        promise.setProgressValue(value);
+        return !promise.isCanceled();
+    });
+
+    if (!promise.isCanceled()) {
+        promise.addResult(result);
+    }
+}
+
+// One directory per run below it, kept until a later run of the same hash file finds no queued job using it
+QString HashPreprocessor::outputDirectory()
+{
+    const QString dirPath = QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).filePath("preprocessed");
+    QDir().mkpath(dirPath);
+    return dirPath;
+}
+
+QString HashPreprocessor::fileKey(const QString &hashFile)
+{
+    const QByteArray path = QFileInfo(hashFile).absoluteFilePath().toUtf8();
+    return QString::fromLatin1(QCryptographicHash::hash(path, QCryptographicHash::Sha1).toHex().left(16));
+}
+
+QJsonObject HashPreprocessor::optionsToJson(const HashPreprocessOptions &options)
+{
+    QJsonObject obj;
+    obj["signature"] = options.signature.toString();
+    obj["stripUsername"] = options.stripUsername;
+    obj["shardSize"] = static_cast<qint64>(options.shardSize);
+
+    // Hashes cracked since the last run have to be left out as well
+    if (!options.potfile.isEmpty()) {
+        const QFileInfo potfile(options.potfile);
+        obj["potfile"] = potfile.absoluteFilePath();
+        obj["potfileSize"] = potfile.size();
+        obj["potfileModified"] = potfile.lastModified().toMSecsSinceEpoch();
+    }
+    return obj;
+}
@@ -0,0 +1,59 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef HASHPREPROCESSOR_H
+#define HASHPREPROCESSOR_H
+
+#include <QJsonObject>
+#include <QPromise>
+#include <QStringList>
+#include "hashsignature.h"
+#include "potfileindex.h"
+#include "wordlistmerger.h"
+
+struct HashPreprocessOptions {
+    QString hashFile;
+    // Hex fields of lines that match are lowercased, an invalid signature leaves lines as they are
+    HashSignature signature;
+    // Drop everything up to the first ':', for hash files that need --username
+    bool stripUsername = false;
+    // Hashes found in this potfile are left out, hashcat would only skip them after loading
+    QString potfile;
+    // Hashes per shard, 0 keeps all of them in one file
+    quint64 shardSize = 0;
+    qint64 memoryLimit = 512 * 1024 * 1024;
+    // Files hashcat still has to read, e.g. hash files of queued jobs. Earlier runs that wrote
+    // one of them are kept.
+    QStringList inUse;
+};
+
+struct HashPreprocessResult {
+    // Shards in the order they should run
+    QStringList files;
+    quint64 lines = 0;
+    quint64 unique = 0;
+    // Lines left out because they are in the potfile
+    quint64 cracked = 0;
+    // An earlier result for the unchanged hash file was reused
+    bool cached = false;
+    QString error;
+};
+
+// Normalizes, deduplicates and optionally shards a hash file before hashcat loads it
+class HashPreprocessor
+{
+public:
+    // The error is empty if preprocessing was canceled
+    static HashPreprocessResult preprocess(const HashPreprocessOptions &options, const WordlistMerger::Progress &progress);
+    // Meant for QtConcurrent::run(), honors cancellation
+    static void run(QPromise<HashPreprocessResult> &promise, const HashPreprocessOptions &options);
+
+private:
+    static QString outputDirectory();
+    static QString fileKey(const QString &hashFile);
+    static QJsonObject optionsToJson(const HashPreprocessOptions &options);
+};
+
+#endif // HASHPREPROCESSOR_H
@@ -0,0 +1,249 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "hashsignature.h"
+#include <QPair>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+// Hex fields of these lengths are digests, other lengths are salts or blobs of any size
+static constexpr qsizetype digestLengths[] = { 16, 32, 40, 48, 56, 64, 96, 128 };
+// Longest base64 field that is still treated as a digest, a 512 bit digest with padding
+static constexpr qsizetype maxBase64Digest = 88;
+
+static bool isHex(char c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+static bool isLetter(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+// Includes the crypt (./) and URL-safe (-_) variants of the alphabet
+static bool isBase64(char c)
+{
+    return isLetter(c) || (c >= '0' && c <= '9') || c == '+' || c == '/' || c == '=' || c == '.' || c == '-' || c == '_';
+}
+
+template <typename Predicate>
+static bool allOf(const char *data, qsizetype length, Predicate predicate)
+{
+    for (qsizetype i = 0; i < length; ++i) {
+        if (!predicate(data[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool HashSignature::isSeparator(char c)
+{
+    return c == '$' || c == '*' || c == ':' || c == '#' || c == ';' || c == ',' || c == '|';
+}
+
+HashSignature HashSignature::fromExample(const QString &example)
+{
+    HashSignature signature;
+    const QByteArray data = example.trimmed().toUtf8();
+    if (data.isEmpty()) {
+        return signature;
+    }
+
+    bool only = true;
+    for (char c : data) {
+        if (isSeparator(c)) {
+            only = false;
+            break;
+        }
+    }
+
+    QByteArray segment;
+    bool first = true;
+
+    auto addSegment = [&](bool last) {
+        // A leading or trailing separator has no field next to it
+        if (segment.isEmpty() && (signature.elements.isEmpty() || last)) {
+            return;
+        }
+        signature.elements.append(classify(segment, first, only));
+        first = false;
+        segment.clear();
+    };
+
+    for (char c : data) {
+        if (isSeparator(c)) {
+            addSegment(false);
+            signature.elements.append({ Kind::Separator, QByteArray(1, c) });
+        } else {
+            segment.append(c);
+        }
+    }
+    addSegment(true);
+
+    return signature;
+}
+
+HashSignature::Element HashSignature::classify(const QByteArray &segment, bool first, bool only)
+{
+    const char *data = segment.constData();
+    const qsizetype length = segment.size();
+
+    int letters = 0;
+    for (char c : segment) {
+        letters += isLetter(c) ? 1 : 0;
+    }
+
+    // Leading tags such as "krb5tgs" or "WPA", short ones like "2a" or "P" have variants
+    if (first && !only && length >= 3 && length <= 32 && letters >= 2
+        && !allOf(data, length, isHex) && allOf(data, length, [](char c) { return isBase64(c) && c != '/' && c != '+' && c != '='; })) {
+        return { Kind::Literal, segment, length, true };
+    }
+
+    if (allOf(data, length, isHex) && (only || length >= digestLengths[0])) {
+        const bool digest = only || std::find(std::begin(digestLengths), std::end(digestLengths), length) != std::end(digestLengths);
+        return { Kind::Hex, QByteArray(), digest ? length : 2, digest };
+    }
+
+    if (allOf(data, length, isBase64) && (only || length >= 16)) {
+        const bool digest = only || length <= maxBase64Digest;
+        return { Kind::Base64, QByteArray(), digest ? length : 16, digest };
+    }
+
+    return { Kind::Text, QByteArray(), only ? 1 : 0, false };
+}
+
+bool HashSignature::isValid() const
+{
+    return !elements.isEmpty();
+}
+
+bool HashSignature::matches(const char *data, qsizetype length) const
+{
+    return match(data, length, nullptr);
+}
+
+bool HashSignature::normalize(char *data, qsizetype length) const
+{
+    return match(data, length, data);
+}
+
+// Writes the lowercase hex digits to output if it is set, only if the whole line matches
+bool HashSignature::match(const char *data, qsizetype length, char *output) const
+{
+    QList<QPair<qsizetype, qsizetype>> hexFields;
+    qsizetype pos = 0;
+
+    for (qsizetype i = 0; i < elements.size(); ++i) {
+        const Element &e = elements.at(i);
+
+        if (e.kind == Kind::Separator) {
+            if (pos >= length || data[pos] != e.literal.at(0)) {
+                return false;
+            }
+            ++pos;
+            continue;
+        }
+
+        // A field ends at the next separator, the last one takes the rest of the line
+        qsizetype end = length;
+        if (i + 1 < elements.size()) {
+            const char separator = elements.at(i + 1).literal.at(0);
+            if (e.kind == Kind::Text) {
+                // Text may contain the separator itself, so it is searched from the right and the
+                // field ends where just enough of them are left for the separators still to come
+                qsizetype remaining = 0;
+                for (qsizetype j = i + 1; j < elements.size(); ++j) {
+                    const Element &next = elements.at(j);
+                    remaining += next.kind == Kind::Separator && next.literal.at(0) == separator ? 1 : 0;
+                }
+                while (remaining > 0 && end > pos) {
+                    remaining -= data[--end] == separator ? 1 : 0;
+                }
+                if (remaining > 0) {
+                    return false;
+                }
+            } else {
+                const void *found = std::memchr(data + pos, separator, static_cast<size_t>(length - pos));
+                if (!found) {
+                    return false;
+                }
+                end = static_cast<const char *>(found) - data;
+            }
+        }
+
+        const char *field = data + pos;
+        const qsizetype n = end - pos;
+        if (e.exact ? n != e.length : n < e.length) {
+            return false;
+        }
+
+        switch (e.kind) {
+        case Kind::Literal:
+            if (std::memcmp(field, e.literal.constData(), static_cast<size_t>(n)) != 0) {
+                return false;
+            }
+            break;
+        case Kind::Hex:
+            if (!allOf(field, n, isHex)) {
+                return false;
+            }
+            if (output) {
+                hexFields.append({ pos, n });
+            }
+            break;
+        case Kind::Base64:
+            if (!allOf(field, n, isBase64)) {
+                return false;
+            }
+            break;
+        case Kind::Separator:
+        case Kind::Text:
+            break;
+        }
+
+        pos = end;
+    }
+
+    if (pos != length) {
+        return false;
+    }
+
+    for (const auto &field : std::as_const(hexFields)) {
+        for (qsizetype i = field.first; i < field.first + field.second; ++i) {
+            const char c = data[i];
+            output[i] = (c >= 'A' && c <= 'F') ? static_cast<char>(c - 'A' + 'a') : c;
+        }
+    }
+
+    return true;
+}
+
+QString HashSignature::toString() const
+{
+    QString result;
+
+    for (const Element &e : elements) {
+        switch (e.kind) {
+        case Kind::Separator:
+        case Kind::Literal:
+            result += QString::fromUtf8(e.literal);
+            break;
+        case Kind::Hex:
+            result += e.exact ? QString("<hex:%1>").arg(e.length) : QString("<hex>");
+            break;
+        case Kind::Base64:
+            result += e.exact ? QString("<base64:%1>").arg(e.length) : QString("<base64>");
+            break;
+        case Kind::Text:
+            result += "<text>";
+            break;
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,50 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef HASHSIGNATURE_H
+#define HASHSIGNATURE_H
+
+#include <QList>
+#include <QString>
+
+// Structure of a hash line derived from the example hash of a mode, e.g. "$1$<text>$<base64:22>"
+class HashSignature
+{
+public:
+    // Invalid if the example is empty
+    static HashSignature fromExample(const QString &example);
+
+    bool isValid() const;
+    bool matches(const char *data, qsizetype length) const;
+    // Lowercases the hex fields of a matching line in place, hashcat reads them case-insensitively
+    bool normalize(char *data, qsizetype length) const;
+    QString toString() const;
+
+private:
+    enum class Kind
+    {
+        Separator,
+        Literal,
+        Hex,
+        Base64,
+        Text
+    };
+
+    struct Element {
+        Kind kind;
+        QByteArray literal;
+        // Fixed length, or the minimum length if not exact
+        qsizetype length = 0;
+        bool exact = false;
+    };
+
+    QList<Element> elements;
+
+    bool match(const char *data, qsizetype length, char *output) const;
+    static Element classify(const QByteArray &segment, bool first, bool only);
+    static bool isSeparator(char c);
+};
+
+#endif // HASHSIGNATURE_H
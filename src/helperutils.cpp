@@ -4,13 +4,8 @@
  */
 
 #include "helperutils.h"
-#include "settingsmanager.h"
-#include <QProcess>
 #include <QString>
 #include <QStandardPaths>
-#include <QFileInfo>
-#include <QFuture>
-#include <QtConcurrent/QtConcurrentRun>
 
 // Mapping of supported command line options
 QMap<HelperUtils::Parameter, QPair<QString, QString>> HelperUtils::parameterMap = {
@@ -25,13 +20,22 @@ QMap<HelperUtils::Parameter, QPair<QString, QString>> HelperUtils::parameterMap
     {HelperUtils::Parameter::HashType,          {"-m",  "--hash-type"}},
     {HelperUtils::Parameter::HexCharset,        {"",    "--hex-charset"}},
     {HelperUtils::Parameter::HexSalt,           {"",    "--hex-salt"}},
+    {HelperUtils::Parameter::Keyspace,          {"",    "--keyspace"}},
+    {HelperUtils::Parameter::Limit,             {"-l",  "--limit"}},
     {HelperUtils::Parameter::OptimizedKernel,   {"-O",  "--optimized-kernel-enable"}},
     {HelperUtils::Parameter::Outfile,           {"-o",  "--outfile"}},
     {HelperUtils::Parameter::OutfileFormat,     {"",    "--outfile-format"}},
     {HelperUtils::Parameter::Remove,            {"",    "--remove"}},
+    {HelperUtils::Parameter::Restore,           {"",    "--restore"}},
+    {HelperUtils::Parameter::RestoreFilePath,   {"",    "--restore-file-path"}},
     {HelperUtils::Parameter::RulesFile,         {"-r",  "--rules-file"}},
     {HelperUtils::Parameter::SegmentSize,       {"-c",  "--segment-size"}},
+    {HelperUtils::Parameter::Session,           {"",    "--session"}},
+    {HelperUtils::Parameter::Skip,              {"-s",  "--skip"}},
     {HelperUtils::Parameter::SpeedOnly,         {"",    "--speed-only"}},
+    {HelperUtils::Parameter::Status,            {"",    "--status"}},
+    {HelperUtils::Parameter::StatusJson,        {"",    "--status-json"}},
+    {HelperUtils::Parameter::StatusTimer,       {"",    "--status-timer"}},
     {HelperUtils::Parameter::Username,          {"",    "--username"}},
     {HelperUtils::Parameter::WorkloadProfile,   {"-w",  "--workload-profile"}},
 };
@@ -52,63 +56,94 @@ QString HelperUtils::getParameter(Parameter key, bool useShort)
     return pair.second;
 }
 
-/**
- * This method runs hashcat asynchronously using QtConcurrent and returns a future
- * that will contain the execution results.
- *
- * Usage Example:
- *
- * QFutureWatcher<HashcatResult> *watcher = new QFutureWatcher<HashcatResult>();
- * connect(watcher, &QFutureWatcher<HashcatResult>::finished, this, [this, watcher]() {
- *     const HashcatResult &result = watcher->result();
- *     // process contents of "result"
- *     watcher->deleteLater();
- * });
- * watcher->setFuture(HelperUtils::executeHashcat(QStringList() << "--help"));
- */
-QFuture<HashcatResult> HelperUtils::executeHashcat(const QStringList &args, int timeoutMs) {
-    return QtConcurrent::run([args, timeoutMs]() -> HashcatResult {
-        HashcatResult result;
-        QProcess proc;
-        QStringList cmdArgs = args;
-        const auto &settings = SettingsManager::instance();
-
-        if (settings.getKey<QString>("hashcatPath").isEmpty()) {
-            result.standardError = "hashcatPath not configured";
-            return result;
+// Removes an option in short, long and "--long=value" form, including its value
+QStringList HelperUtils::removeParameter(const QStringList &args, Parameter key, bool hasValue)
+{
+    const auto &pair = parameterMap.value(key);
+    QStringList result;
+
+    for (qsizetype i = 0; i < args.size(); ++i) {
+        const QString &arg = args.at(i);
+
+        if ((!pair.first.isEmpty() && arg == pair.first) || arg == pair.second) {
+            if (hasValue) {
+                ++i;
+            }
+            continue;
         }
 
-        // Always run in quiet mode when reading output
-        cmdArgs << "--quiet";
+        if (hasValue && arg.startsWith(pair.second + "=")) {
+            continue;
+        }
+
+        result << arg;
+    }
+
+    return result;
+}
 
-        proc.setProgram(settings.getKey<QString>("hashcatPath"));
-        proc.setArguments(cmdArgs);
-        proc.setWorkingDirectory(QFileInfo(settings.getKey<QString>("hashcatPath")).absolutePath());
+QString HelperUtils::parameterValue(const QStringList &args, Parameter key)
+{
+    const auto &pair = parameterMap.value(key);
 
-        proc.start();
+    for (qsizetype i = 0; i < args.size(); ++i) {
+        const QString &arg = args.at(i);
 
-        if (!proc.waitForStarted()) {
-            result.standardError = "Failed to start hashcat";
-            return result;
+        if ((!pair.first.isEmpty() && arg == pair.first) || arg == pair.second) {
+            return args.value(i + 1);
         }
 
-        if (!proc.waitForFinished(timeoutMs)) {
-            proc.kill();
-            result.standardError = "hashcat timed out";
-            return result;
+        if (arg.startsWith(pair.second + "=")) {
+            return arg.mid(pair.second.size() + 1);
         }
+    }
 
-        result.exitStatus = proc.exitStatus();
-        result.exitCode = proc.exitCode();
-        result.standardOutput = proc.readAllStandardOutput();
-        result.standardError = proc.readAllStandardError();
+    return QString();
+}
+
+// Human readable hash rate, e.g. "1.23 GH/s"
+QString HelperUtils::formatSpeed(qint64 hashesPerSecond)
+{
+    static const char *units[] = {"H/s", "kH/s", "MH/s", "GH/s", "TH/s", "PH/s"};
+    double speed = static_cast<double>(hashesPerSecond);
+    int unit = 0;
 
-        return result;
-    });
+    while (speed >= 1000.0 && unit < 5) {
+        speed /= 1000.0;
+        ++unit;
+    }
+
+    return QString("%1 %2").arg(speed, 0, 'f', unit == 0 ? 0 : 2).arg(units[unit]);
 }
 
-// Returns all supported terminals
+// Human readable duration, e.g. "2d 03:12:45"
+QString HelperUtils::formatDuration(qint64 seconds)
+{
+    if (seconds < 0) {
+        return "-";
+    }
+
+    const qint64 days = seconds / 86400;
+    const QString time = QString("%1:%2:%3")
+                             .arg((seconds % 86400) / 3600, 2, 10, QChar('0'))
+                             .arg((seconds % 3600) / 60, 2, 10, QChar('0'))
+                             .arg(seconds % 60, 2, 10, QChar('0'));
+
+    if (days > 0) {
+        return QString("%1d %2").arg(days).arg(time);
+    }
+    return time;
+}
+
+// Returns all supported terminals, PATH is only searched on the first call
 QMap<QString, QStringList> HelperUtils::getAvailableTerminals()
+{
+    // Thread-safe, the main window probes in the background at startup
+    static const QMap<QString, QStringList> terminals = findTerminals();
+    return terminals;
+}
+
+QMap<QString, QStringList> HelperUtils::findTerminals()
 {
     QMap<QString, QStringList> terminals;
 
@@ -8,15 +8,7 @@
 
 #include <QString>
 #include <QStringList>
-#include <QProcess>
-#include <QFuture>
-
-struct HashcatResult {
-    QProcess::ExitStatus exitStatus;
-    int exitCode;
-    QString standardOutput;
-    QString standardError;
-};
+#include <QMap>
 
 class HelperUtils
 {
@@ -37,23 +29,38 @@ public:
         HashType,
         HexCharset,
         HexSalt,
+        Keyspace,
+        Limit,
         OptimizedKernel,
         Outfile,
         OutfileFormat,
         Remove,
+        Restore,
+        RestoreFilePath,
         RulesFile,
         SegmentSize,
+        Session,
+        Skip,
         SpeedOnly,
+        Status,
+        StatusJson,
+        StatusTimer,
         Username,
         WorkloadProfile,
     };
 
-    static QFuture<HashcatResult> executeHashcat(const QStringList &args, int timeoutMs = 20000);
     static QMap<QString, QStringList> getAvailableTerminals();
     static QString getParameter(Parameter key, bool useShort = false);
+    static QStringList removeParameter(const QStringList &args, Parameter key, bool hasValue);
+    // Value of an option in short, long or "--long=value" form, empty if it is not set
+    static QString parameterValue(const QStringList &args, Parameter key);
+    static QString formatSpeed(qint64 hashesPerSecond);
+    static QString formatDuration(qint64 seconds);
 
 private:
     static QMap<Parameter, QPair<QString, QString>> parameterMap;
+
+    static QMap<QString, QStringList> findTerminals();
 };
 
 #endif // HELPERUTILS_H
@@ -0,0 +1,82 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "hyperloglog.h"
+#include <cmath>
+#include <cstring>
+
+HyperLogLog::HyperLogLog()
+    : registers(registerCount, 0)
+{
+}
+
+void HyperLogLog::add(quint64 hash)
+{
+    const int index = static_cast<int>(hash >> (64 - precision));
+    const char rank = static_cast<char>(qCountLeadingZeroBits((hash << precision) | (1ULL << (precision - 1))) + 1);
+    char *r = registers.data();
+    if (r[index] < rank) {
+        r[index] = rank;
+    }
+}
+
+void HyperLogLog::merge(const HyperLogLog &other)
+{
+    char *r = registers.data();
+    const char *o = other.registers.constData();
+    for (int i = 0; i < registerCount; ++i) {
+        r[i] = qMax(r[i], o[i]);
+    }
+}
+
+quint64 HyperLogLog::estimate() const
+{
+    const double m = registerCount;
+    double sum = 0.0;
+    int zeros = 0;
+
+    for (char r : registers) {
+        sum += std::ldexp(1.0, -static_cast<int>(r));
+        zeros += r == 0 ? 1 : 0;
+    }
+
+    double estimate = (0.7213 / (1.0 + 1.079 / m)) * m * m / sum;
+
+    // Linear counting is more accurate for small sets
+    if (estimate <= 2.5 * m && zeros > 0) {
+        estimate = m * std::log(m / zeros);
+    }
+
+    return static_cast<quint64>(estimate + 0.5);
+}
+
+quint64 HyperLogLog::hash(const char *data, qsizetype length)
+{
+    quint64 h = 0x9E3779B97F4A7C15ULL ^ (static_cast<quint64>(length) * 0xFF51AFD7ED558CCDULL);
+
+    while (length >= 8) {
+        quint64 k;
+        std::memcpy(&k, data, 8);
+        h = (h ^ k) * 0x9FB21C651E98DF25ULL;
+        h ^= h >> 32;
+        data += 8;
+        length -= 8;
+    }
+
+    if (length > 0) {
+        quint64 k = 0;
+        std::memcpy(&k, data, length);
+        h = (h ^ k) * 0x9FB21C651E98DF25ULL;
+        h ^= h >> 32;
+    }
+
+    // splitmix64 finalizer
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    return h;
+}
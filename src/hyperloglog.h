@@ -0,0 +1,32 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef HYPERLOGLOG_H
+#define HYPERLOGLOG_H
+
+#include <QByteArray>
+
+// Estimates the number of distinct values with 2^14 registers, about 0.8% standard error
+class HyperLogLog
+{
+public:
+    HyperLogLog();
+
+    void add(quint64 hash);
+    // The union of two sketches is the maximum of their registers
+    void merge(const HyperLogLog &other);
+    quint64 estimate() const;
+
+    // Fast 64 bit hash, not suitable for anything but estimates and fingerprints
+    static quint64 hash(const char *data, qsizetype length);
+
+private:
+    static constexpr int precision = 14;
+    static constexpr int registerCount = 1 << precision;
+
+    QByteArray registers;
+};
+
+#endif // HYPERLOGLOG_H
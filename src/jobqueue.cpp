@@ -0,0 +1,458 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "jobqueue.h"
+#include "helperutils.h"
+#include "sessionindex.h"
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+// Seconds between two status updates of a queued job
+static constexpr int statusTimerSeconds = 10;
+
+JobQueue::JobQueue(QObject *parent)
+    : ListModel(parent)
+    , runner(new HashcatRunner(this))
+{
+    runner->setCaptureLimit(64 * 1024);
+
+    connect(runner, &HashcatRunner::standardOutputLine, this, &JobQueue::outputLineReceived);
+    connect(runner, &HashcatRunner::finished, this, &JobQueue::jobFinished);
+
+    load();
+
+    // Continue where we left off if the queue was running when the GUI was closed
+    if (active) {
+        QMetaObject::invokeMethod(this, &JobQueue::scheduleNext, Qt::QueuedConnection);
+    }
+}
+
+int JobQueue::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : jobs.size();
+}
+
+int JobQueue::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant JobQueue::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= jobs.size()) {
+        return QVariant();
+    }
+
+    const Job &j = jobs.at(index.row());
+
+    if (role == Qt::DisplayRole || role == Qt::EditRole) {
+        switch (index.column()) {
+        case ColumnPriority:
+            return j.priority;
+        case ColumnName:
+            return j.name;
+        case ColumnState:
+            if (j.state == JobState::Failed || j.state == JobState::Finished) {
+                return QString("%1 (%2)").arg(stateText(j.state)).arg(j.exitCode);
+            }
+            return stateText(j.state);
+        case ColumnProgress:
+            return QString("%1%").arg(j.progress, 0, 'f', 2);
+        case ColumnCommand:
+            return j.arguments.join(" ");
+        }
+    } else if (role == Qt::ToolTipRole && index.column() == ColumnCommand) {
+        return j.arguments.join(" ");
+    }
+
+    return QVariant();
+}
+
+QVariant JobQueue::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return ListModel::headerData(section, orientation, role);
+    }
+
+    switch (section) {
+    case ColumnPriority:
+        return tr("Priority");
+    case ColumnName:
+        return tr("Job");
+    case ColumnState:
+        return tr("State");
+    case ColumnProgress:
+        return tr("Progress");
+    case ColumnCommand:
+        return tr("Command");
+    }
+
+    return QVariant();
+}
+
+Qt::ItemFlags JobQueue::flags(const QModelIndex &index) const
+{
+    Qt::ItemFlags f = ListModel::flags(index);
+
+    // Priority and name can be edited in place
+    if (index.isValid() && (index.column() == ColumnPriority || index.column() == ColumnName)) {
+        f |= Qt::ItemIsEditable;
+    }
+
+    return f;
+}
+
+bool JobQueue::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (!index.isValid() || role != Qt::EditRole || index.row() >= jobs.size()) {
+        return false;
+    }
+
+    Job &j = jobs[index.row()];
+
+    if (index.column() == ColumnPriority) {
+        j.priority = value.toInt();
+    } else if (index.column() == ColumnName) {
+        j.name = value.toString();
+    } else {
+        return false;
+    }
+
+    emitRowChanged(index.row());
+    save();
+    return true;
+}
+
+QString JobQueue::stateText(JobState state)
+{
+    switch (state) {
+    case JobState::Queued:
+        return tr("Queued");
+    case JobState::Running:
+        return tr("Running");
+    case JobState::Finished:
+        return tr("Finished");
+    case JobState::Failed:
+        return tr("Failed");
+    case JobState::Cancelled:
+        return tr("Cancelled");
+    }
+
+    return QString();
+}
+
+const JobQueue::Job &JobQueue::job(int row) const
+{
+    return jobs.at(row);
+}
+
+int JobQueue::rowOf(const QUuid &id) const
+{
+    for (int row = 0; row < jobs.size(); ++row) {
+        if (jobs.at(row).id == id) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+void JobQueue::emitRowChanged(int row)
+{
+    emit dataChanged(index(row, 0), index(row, ColumnCount - 1));
+}
+
+void JobQueue::enqueue(const QString &name, const QStringList &arguments, const QJsonObject &profile, quint64 keyspace,
+                       int priority)
+{
+    Job j;
+    j.id = QUuid::createUuid();
+    j.name = name;
+    j.arguments = arguments;
+    j.profile = profile;
+    j.priority = priority;
+    j.keyspace = keyspace;
+    j.added = QDateTime::currentDateTime();
+
+    beginInsertRows(QModelIndex(), jobs.size(), jobs.size());
+    jobs.append(j);
+    endInsertRows();
+
+    save();
+    scheduleNext();
+}
+
+void JobQueue::removeJob(int row)
+{
+    if (row < 0 || row >= jobs.size()) {
+        return;
+    }
+
+    // jobFinished() ignores jobs that are no longer in the list
+    if (jobs.at(row).id == currentJob) {
+        runner->cancel();
+    }
+
+    beginRemoveRows(QModelIndex(), row, row);
+    jobs.removeAt(row);
+    endRemoveRows();
+
+    save();
+}
+
+void JobQueue::moveJob(int row, int delta)
+{
+    if (moveListRow(jobs, row, delta)) {
+        save();
+    }
+}
+
+void JobQueue::requeueJob(int row)
+{
+    if (row < 0 || row >= jobs.size() || jobs.at(row).state == JobState::Running) {
+        return;
+    }
+
+    Job &j = jobs[row];
+    j.state = JobState::Queued;
+    j.exitCode = -1;
+    j.progress = 0.0;
+    j.resume = false;
+    emitRowChanged(row);
+
+    save();
+    scheduleNext();
+}
+
+bool JobQueue::isActive() const
+{
+    return active;
+}
+
+void JobQueue::setActive(bool active)
+{
+    if (this->active == active) {
+        return;
+    }
+
+    // Deactivating only stops the scheduler, a running job is left alone
+    this->active = active;
+    save();
+    emit activeChanged(active);
+
+    scheduleNext();
+}
+
+void JobQueue::cancelCurrent()
+{
+    runner->cancel();
+}
+
+/*
+ * Picks the queued job with the highest priority. Jobs with the same
+ * priority run in list order.
+ */
+void JobQueue::scheduleNext()
+{
+    if (!active || runner->isRunning()) {
+        return;
+    }
+
+    int next = -1;
+    for (int row = 0; row < jobs.size(); ++row) {
+        if (jobs.at(row).state != JobState::Queued) {
+            continue;
+        }
+        if (next < 0 || jobs.at(row).priority > jobs.at(next).priority) {
+            next = row;
+        }
+    }
+
+    if (next < 0) {
+        return;
+    }
+
+    Job &j = jobs[next];
+    const QString session = HelperUtils::parameterValue(j.arguments, HelperUtils::Parameter::Session);
+
+    // The restore file holds the whole command line, status options included
+    QStringList args;
+    if (j.resume) {
+        const RestoreSession restore = SessionIndex::find(session);
+        if (restore.isValid()) {
+            args = SessionIndex::restoreArguments(restore);
+        }
+        j.resume = false;
+    }
+
+    j.state = JobState::Running;
+    if (args.isEmpty()) {
+        j.progress = 0.0;
+    }
+    currentJob = j.id;
+    emitRowChanged(next);
+    save();
+
+    // Registered when the job starts, the index forgets sessions that wrote no checkpoint for a day
+    if (!session.isEmpty()) {
+        SessionIndex::remember(session, j.keyspace);
+    }
+
+    if (args.isEmpty()) {
+        args = j.arguments;
+        args << HelperUtils::getParameter(HelperUtils::Parameter::Status)
+             << HelperUtils::getParameter(HelperUtils::Parameter::StatusJson)
+             << HelperUtils::getParameter(HelperUtils::Parameter::StatusTimer) << QString::number(statusTimerSeconds);
+    }
+    runner->start(args);
+}
+
+void JobQueue::outputLineReceived(const QByteArray &line)
+{
+    HashcatStatus status;
+    if (!HashcatStatus::fromJson(line, status)) {
+        return;
+    }
+
+    int row = rowOf(currentJob);
+    if (row < 0) {
+        return;
+    }
+
+    jobs[row].progress = status.progressPercent();
+    emitRowChanged(row);
+    emit statusUpdated(jobs.at(row).name, status);
+}
+
+void JobQueue::jobFinished(const HashcatResult &result)
+{
+    int row = rowOf(currentJob);
+    currentJob = QUuid();
+
+    if (row >= 0) {
+        Job &j = jobs[row];
+        j.exitCode = result.exitCode;
+
+        // hashcat exit codes: 0 cracked, 1 exhausted, 2 aborted by the user, 3-4 aborted by checkpoint/runtime
+        if (result.exitStatus != QProcess::NormalExit) {
+            j.state = JobState::Failed;
+        } else if (result.exitCode == 0 || result.exitCode == 1 || result.exitCode == 3 || result.exitCode == 4) {
+            j.state = JobState::Finished;
+            if (result.exitCode <= 1) {
+                j.progress = 100.0;
+            }
+        } else if (result.exitCode == 2) {
+            j.state = JobState::Cancelled;
+        } else {
+            j.state = JobState::Failed;
+        }
+
+        emitRowChanged(row);
+        save();
+    }
+
+    scheduleNext();
+}
+
+// Path to the persisted queue JSON
+QString JobQueue::queueFile()
+{
+    const QString dirPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dirPath);
+    return QDir(dirPath).filePath("job_queue.json");
+}
+
+void JobQueue::load()
+{
+    QFile f(queueFile());
+    if (!f.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QJsonDocument doc = QJsonDocument::fromJson(f.readAll());
+    if (!doc.isObject()) {
+        return;
+    }
+
+    const QJsonObject root = doc.object();
+    active = root.value("active").toBool();
+
+    const QJsonArray list = root.value("jobs").toArray();
+    for (const QJsonValue &v : list) {
+        const QJsonObject obj = v.toObject();
+        Job j;
+        j.id = QUuid::fromString(obj.value("id").toString());
+        j.name = obj.value("name").toString();
+        j.profile = obj.value("profile").toObject();
+        j.priority = obj.value("priority").toInt();
+        j.state = static_cast<JobState>(obj.value("state").toInt());
+        j.exitCode = obj.value("exitCode").toInt(-1);
+        j.progress = obj.value("progress").toDouble();
+        j.added = QDateTime::fromString(obj.value("added").toString(), Qt::ISODate);
+        j.keyspace = obj.value("keyspace").toString().toULongLong();
+
+        const QJsonArray args = obj.value("arguments").toArray();
+        for (const QJsonValue &arg : args) {
+            j.arguments << arg.toString();
+        }
+
+        if (j.id.isNull()) {
+            j.id = QUuid::createUuid();
+        }
+
+        j.resume = obj.value("resume").toBool();
+
+        // A job that was running when the GUI went away continues from its checkpoint if hashcat wrote one
+        if (j.state == JobState::Running) {
+            const QString session = HelperUtils::parameterValue(j.arguments, HelperUtils::Parameter::Session);
+            j.state = JobState::Queued;
+            j.resume = !session.isEmpty() && SessionIndex::find(session).isValid();
+            if (!j.resume) {
+                j.progress = 0.0;
+            }
+        }
+
+        jobs.append(j);
+    }
+}
+
+void JobQueue::save() const
+{
+    QJsonArray list;
+    for (const Job &j : jobs) {
+        QJsonObject obj;
+        obj["id"] = j.id.toString(QUuid::WithoutBraces);
+        obj["name"] = j.name;
+        obj["arguments"] = QJsonArray::fromStringList(j.arguments);
+        obj["profile"] = j.profile;
+        obj["priority"] = j.priority;
+        obj["state"] = static_cast<int>(j.state);
+        obj["exitCode"] = j.exitCode;
+        obj["progress"] = j.progress;
+        obj["added"] = j.added.toString(Qt::ISODate);
+        // As text, JSON numbers lose precision above 2^53
+        obj["keyspace"] = QString::number(j.keyspace);
+        obj["resume"] = j.resume;
+        list.append(obj);
+    }
+
+    QJsonObject root;
+    root["active"] = active;
+    root["jobs"] = list;
+
+    // A crash while writing must not cost the queue
+    QSaveFile f(queueFile());
+    if (!f.open(QIODevice::WriteOnly)) {
+        qWarning("Could not write job queue to %s", qPrintable(f.fileName()));
+        return;
+    }
+    f.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    if (!f.commit()) {
+        qWarning("Could not write job queue to %s", qPrintable(f.fileName()));
+    }
+}
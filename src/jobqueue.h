@@ -0,0 +1,102 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef JOBQUEUE_H
+#define JOBQUEUE_H
+
+#include <QDateTime>
+#include <QJsonObject>
+#include <QStringList>
+#include <QUuid>
+#include "hashcatrunner.h"
+#include "hashcatstatus.h"
+#include "listmodel.h"
+
+class JobQueue : public ListModel
+{
+    Q_OBJECT
+
+public:
+    enum Column
+    {
+        ColumnPriority,
+        ColumnName,
+        ColumnState,
+        ColumnProgress,
+        ColumnCommand,
+        ColumnCount
+    };
+
+    enum class JobState
+    {
+        Queued,
+        Running,
+        Finished,
+        Failed,
+        Cancelled
+    };
+
+    struct Job {
+        QUuid id;
+        QString name;
+        QStringList arguments;
+        QJsonObject profile;
+        int priority = 0;
+        JobState state = JobState::Queued;
+        int exitCode = -1;
+        double progress = 0.0;
+        QDateTime added;
+        // Keyspace of the attack for the session index, 0 if unknown
+        quint64 keyspace = 0;
+        // Interrupted while running, the next start continues from the session's last checkpoint
+        bool resume = false;
+    };
+
+    explicit JobQueue(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+
+    void enqueue(const QString &name, const QStringList &arguments, const QJsonObject &profile, quint64 keyspace = 0,
+                 int priority = 0);
+    void removeJob(int row);
+    void moveJob(int row, int delta);
+    void requeueJob(int row);
+    const Job &job(int row) const;
+
+    // The scheduler starts queued jobs one after another while active
+    bool isActive() const;
+    void setActive(bool active);
+    void cancelCurrent();
+
+signals:
+    void activeChanged(bool active);
+    void statusUpdated(const QString &jobName, const HashcatStatus &status);
+
+private slots:
+    void outputLineReceived(const QByteArray &line);
+    void jobFinished(const HashcatResult &result);
+
+private:
+    QList<Job> jobs;
+    HashcatRunner *runner;
+    QUuid currentJob;
+    bool active = false;
+
+    void scheduleNext();
+    int rowOf(const QUuid &id) const;
+    void emitRowChanged(int row);
+
+    static QString queueFile();
+    static QString stateText(JobState state);
+    void load();
+    void save() const;
+};
+
+#endif // JOBQUEUE_H
@@ -0,0 +1,95 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "jobqueuedialog.h"
+#include "ui_jobqueuedialog.h"
+#include "helperutils.h"
+#include <QItemSelectionModel>
+
+JobQueueDialog::JobQueueDialog(JobQueue *queue, QWidget *parent)
+    : QDialog(parent)
+    , ui(new Ui::JobQueueDialog)
+    , queue(queue)
+{
+    ui->setupUi(this);
+
+    ui->tableView_jobs->setModel(queue);
+    ui->tableView_jobs->resizeColumnsToContents();
+    activeChanged(queue->isActive());
+
+    connect(ui->toolButton_up, &QToolButton::clicked, this, &JobQueueDialog::upClicked);
+    connect(ui->toolButton_down, &QToolButton::clicked, this, &JobQueueDialog::downClicked);
+    connect(ui->pushButton_requeue, &QPushButton::clicked, this, &JobQueueDialog::requeueClicked);
+    connect(ui->pushButton_load_profile, &QPushButton::clicked, this, &JobQueueDialog::loadProfileClicked);
+    connect(ui->pushButton_remove, &QPushButton::clicked, this, &JobQueueDialog::removeClicked);
+    connect(ui->pushButton_start_stop, &QPushButton::clicked, this, &JobQueueDialog::startStopClicked);
+    connect(ui->pushButton_cancel_job, &QPushButton::clicked, queue, &JobQueue::cancelCurrent);
+    connect(ui->pushButton_close, &QPushButton::clicked, this, &JobQueueDialog::close);
+    connect(queue, &JobQueue::activeChanged, this, &JobQueueDialog::activeChanged);
+    connect(queue, &JobQueue::statusUpdated, this, &JobQueueDialog::statusUpdated);
+}
+
+JobQueueDialog::~JobQueueDialog()
+{
+    delete ui;
+}
+
+int JobQueueDialog::selectedRow() const
+{
+    const QModelIndexList rows = ui->tableView_jobs->selectionModel()->selectedRows();
+    return rows.isEmpty() ? -1 : rows.constFirst().row();
+}
+
+void JobQueueDialog::upClicked()
+{
+    int row = selectedRow();
+    if (row > 0) {
+        queue->moveJob(row, -1);
+        ui->tableView_jobs->selectRow(row - 1);
+    }
+}
+
+void JobQueueDialog::downClicked()
+{
+    int row = selectedRow();
+    if (row >= 0 && row < queue->rowCount() - 1) {
+        queue->moveJob(row, 1);
+        ui->tableView_jobs->selectRow(row + 1);
+    }
+}
+
+void JobQueueDialog::requeueClicked()
+{
+    queue->requeueJob(selectedRow());
+}
+
+void JobQueueDialog::loadProfileClicked()
+{
+    int row = selectedRow();
+    if (row >= 0) {
+        emit loadProfileRequested(queue->job(row).profile);
+    }
+}
+
+void JobQueueDialog::removeClicked()
+{
+    queue->removeJob(selectedRow());
+}
+
+void JobQueueDialog::startStopClicked()
+{
+    queue->setActive(!queue->isActive());
+}
+
+void JobQueueDialog::activeChanged(bool active)
+{
+    ui->pushButton_start_stop->setText(active ? tr("Stop queue") : tr("Start queue"));
+    ui->pushButton_start_stop->setToolTip(active ? tr("Don't start further jobs, the running job continues") : QString());
+}
+
+void JobQueueDialog::statusUpdated(const QString &jobName, const HashcatStatus &status)
+{
+    ui->label_current->setText(tr("%1: %2, %3").arg(jobName, status.statusText(), HelperUtils::formatSpeed(status.totalSpeed())));
+}
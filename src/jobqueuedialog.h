@@ -0,0 +1,45 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef JOBQUEUEDIALOG_H
+#define JOBQUEUEDIALOG_H
+
+#include <QDialog>
+#include <QJsonObject>
+#include "jobqueue.h"
+
+namespace Ui {
+    class JobQueueDialog;
+}
+
+class JobQueueDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit JobQueueDialog(JobQueue *queue, QWidget *parent = nullptr);
+    ~JobQueueDialog();
+
+signals:
+    void loadProfileRequested(const QJsonObject &profile);
+
+private slots:
+    void upClicked();
+    void downClicked();
+    void requeueClicked();
+    void loadProfileClicked();
+    void removeClicked();
+    void startStopClicked();
+    void activeChanged(bool active);
+    void statusUpdated(const QString &jobName, const HashcatStatus &status);
+
+private:
+    Ui::JobQueueDialog *ui;
+    JobQueue *queue;
+
+    int selectedRow() const;
+};
+
+#endif // JOBQUEUEDIALOG_H
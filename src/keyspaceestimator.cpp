@@ -0,0 +1,109 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "keyspaceestimator.h"
+#include "helperutils.h"
+#include "keyspaceslicer.h"
+#include "maskparser.h"
+#include <limits>
+
+static quint64 saturatingMultiply(quint64 a, quint64 b)
+{
+    if (a != 0 && b > std::numeric_limits<quint64>::max() / a) {
+        return std::numeric_limits<quint64>::max();
+    }
+    return a * b;
+}
+
+KeyspaceEstimator::KeyspaceEstimator(QObject *parent)
+    : QObject(parent)
+{
+    delayTimer.setSingleShot(true);
+    delayTimer.setInterval(500);
+    connect(&delayTimer, &QTimer::timeout, this, &KeyspaceEstimator::run);
+}
+
+void KeyspaceEstimator::setDelay(int ms)
+{
+    delayTimer.setInterval(ms);
+}
+
+void KeyspaceEstimator::request(const QStringList &arguments, quint64 multiplier)
+{
+    clear();
+
+    if (lastKeyspace > 0 && arguments == lastArguments) {
+        emit estimated(lastKeyspace, saturatingMultiply(lastKeyspace, multiplier));
+        return;
+    }
+
+    pendingArguments = arguments;
+    pendingMultiplier = multiplier;
+    delayTimer.start();
+}
+
+void KeyspaceEstimator::setResult(quint64 keyspace, quint64 candidates)
+{
+    clear();
+    emit estimated(keyspace, candidates);
+}
+
+void KeyspaceEstimator::clear()
+{
+    // Results of older requests are recognized by their generation and dropped
+    ++generation;
+    delayTimer.stop();
+
+    if (runner) {
+        runner->cancel();
+        runner.clear();
+    }
+}
+
+bool KeyspaceEstimator::isBusy() const
+{
+    return delayTimer.isActive() || runner;
+}
+
+void KeyspaceEstimator::run()
+{
+    const quint64 current = generation;
+
+    const quint64 multiplier = pendingMultiplier;
+
+    QStringList args = pendingArguments;
+    args << HelperUtils::getParameter(HelperUtils::Parameter::Keyspace);
+
+    const QStringList arguments = pendingArguments;
+    runner = HashcatRunner::run(args, this);
+    connect(runner, &HashcatRunner::finished, this, [this, current, multiplier, arguments](const HashcatResult &result) {
+        if (current != generation) {
+            return;
+        }
+        runner.clear();
+
+        const quint64 keyspace = KeyspaceSlicer::parseKeyspace(result.standardOutput);
+        if (result.exitStatus != QProcess::NormalExit || result.exitCode != 0 || keyspace == 0) {
+            emit failed(result.standardError.trimmed().section('\n', -1));
+            return;
+        }
+
+        lastArguments = arguments;
+        lastKeyspace = keyspace;
+        emit estimated(keyspace, saturatingMultiply(keyspace, multiplier));
+    });
+}
+
+quint64 KeyspaceEstimator::maskCandidates(const QString &mask, const QStringList &customCharsets, bool hexCharset)
+{
+    // hashcat runs the masks of a file one after another
+    if (MaskParser::isHcmaskFile(mask)) {
+        const ParsedMaskFile file = MaskParser::parseHcmaskFile(mask, hexCharset);
+        return file.error.isEmpty() && file.invalidCount() == 0 ? file.keyspace.toUInt64() : 0;
+    }
+
+    const ParsedMask parsed = MaskParser::parse(mask, customCharsets, hexCharset);
+    return parsed.isValid() ? parsed.keyspace.toUInt64() : 0;
+}
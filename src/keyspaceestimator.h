@@ -0,0 +1,58 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef KEYSPACEESTIMATOR_H
+#define KEYSPACEESTIMATOR_H
+
+#include <QObject>
+#include <QPointer>
+#include <QStringList>
+#include <QTimer>
+#include "hashcatrunner.h"
+
+// Calculates the keyspace of the current attack in the background
+class KeyspaceEstimator : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit KeyspaceEstimator(QObject *parent = nullptr);
+
+    // Debounce interval before hashcat is started (default: 500 ms)
+    void setDelay(int ms);
+
+    // Run "hashcat --keyspace" once the arguments stop changing. The candidates are the keyspace
+    // multiplied by multiplier, a multiplier of 0 means unknown.
+    void request(const QStringList &arguments, quint64 multiplier = 1);
+    // Report a keyspace that was calculated without hashcat
+    void setResult(quint64 keyspace, quint64 candidates);
+    // Drop pending and running requests
+    void clear();
+
+    bool isBusy() const;
+
+    // Number of candidates of a mask, 0 if it can't be parsed. Saturates on overflow.
+    static quint64 maskCandidates(const QString &mask, const QStringList &customCharsets = {}, bool hexCharset = false);
+
+signals:
+    void estimated(quint64 keyspace, quint64 candidates);
+    void failed(const QString &error);
+
+private:
+    QTimer delayTimer;
+    QPointer<HashcatRunner> runner;
+    quint64 generation = 0;
+
+    QStringList pendingArguments;
+    quint64 pendingMultiplier = 1;
+
+    // Changing only skip, limit or the outfile keeps the keyspace
+    QStringList lastArguments;
+    quint64 lastKeyspace = 0;
+
+    void run();
+};
+
+#endif // KEYSPACEESTIMATOR_H
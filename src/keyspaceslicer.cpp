@@ -0,0 +1,128 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "keyspaceslicer.h"
+#include "helperutils.h"
+
+QStringList KeyspaceSlicer::deviceGroups(const QString &devices)
+{
+    QStringList groups;
+
+    if (devices.contains(';')) {
+        groups = devices.split(';', Qt::SkipEmptyParts);
+    } else {
+        groups = devices.split(',', Qt::SkipEmptyParts);
+    }
+
+    for (QString &group : groups) {
+        group = group.trimmed();
+    }
+    groups.removeAll(QString());
+
+    return groups;
+}
+
+QList<KeyspaceSlice> KeyspaceSlicer::split(quint64 skip, quint64 limit, const QStringList &groups,
+                                           const QList<double> &weights, const QString &cpuAffinity)
+{
+    QList<KeyspaceSlice> slices;
+    if (groups.isEmpty() || limit == 0) {
+        return slices;
+    }
+
+    // Unknown or invalid weights fall back to an equal split
+    QList<double> w = weights;
+    double total = 0.0;
+    for (double value : std::as_const(w)) {
+        total += value > 0.0 ? value : 0.0;
+    }
+    if (w.size() != groups.size() || total <= 0.0) {
+        w = QList<double>(groups.size(), 1.0);
+        total = groups.size();
+    }
+
+    // CPU cores are handed out round-robin, every process gets at least one
+    const QStringList cores = cpuAffinity.split(',', Qt::SkipEmptyParts);
+    QList<QStringList> coresPerGroup(groups.size());
+    for (int i = 0; i < cores.size(); ++i) {
+        coresPerGroup[i % groups.size()] << cores.at(i).trimmed();
+    }
+    for (int i = 0; i < groups.size() && !cores.isEmpty(); ++i) {
+        if (coresPerGroup.at(i).isEmpty()) {
+            coresPerGroup[i] << cores.at(i % cores.size()).trimmed();
+        }
+    }
+
+    quint64 offset = skip;
+    quint64 remaining = limit;
+
+    for (int i = 0; i < groups.size() && remaining > 0; ++i) {
+        quint64 size;
+        if (i == groups.size() - 1) {
+            // The last slice picks up what rounding left over
+            size = remaining;
+        } else {
+            const double share = qMax(w.at(i), 0.0) / total;
+            size = static_cast<quint64>(static_cast<long double>(limit) * share);
+            size = qBound<quint64>(1, size, remaining);
+        }
+
+        KeyspaceSlice slice;
+        slice.devices = groups.at(i);
+        slice.cpuAffinity = coresPerGroup.at(i).join(',');
+        slice.skip = offset;
+        slice.limit = size;
+        slices.append(slice);
+
+        offset += size;
+        remaining -= size;
+    }
+
+    return slices;
+}
+
+QStringList KeyspaceSlicer::sliceArguments(const QStringList &arguments, const KeyspaceSlice &slice,
+                                           const QString &session, const QString &outfile)
+{
+    using Parameter = HelperUtils::Parameter;
+
+    // Everything the slice decides on its own is replaced
+    QStringList args = arguments;
+    args = HelperUtils::removeParameter(args, Parameter::BackendDevices, true);
+    args = HelperUtils::removeParameter(args, Parameter::CpuAffinity, true);
+    args = HelperUtils::removeParameter(args, Parameter::Skip, true);
+    args = HelperUtils::removeParameter(args, Parameter::Limit, true);
+    args = HelperUtils::removeParameter(args, Parameter::Session, true);
+    // Slices must not rewrite the shared hash file
+    args = HelperUtils::removeParameter(args, Parameter::Remove, false);
+    if (!outfile.isEmpty()) {
+        args = HelperUtils::removeParameter(args, Parameter::Outfile, true);
+        args << HelperUtils::getParameter(Parameter::Outfile) << outfile;
+    }
+
+    args << HelperUtils::getParameter(Parameter::BackendDevices) << slice.devices;
+    if (!slice.cpuAffinity.isEmpty()) {
+        args << HelperUtils::getParameter(Parameter::CpuAffinity) << slice.cpuAffinity;
+    }
+    args << HelperUtils::getParameter(Parameter::Skip) << QString::number(slice.skip);
+    args << HelperUtils::getParameter(Parameter::Limit) << QString::number(slice.limit);
+    args << HelperUtils::getParameter(Parameter::Session) << session;
+
+    return args;
+}
+
+quint64 KeyspaceSlicer::parseKeyspace(const QString &output)
+{
+    // The keyspace is printed on the last line, warnings may come before it
+    const QStringList lines = output.split('\n', Qt::SkipEmptyParts);
+    for (auto it = lines.crbegin(); it != lines.crend(); ++it) {
+        bool ok = false;
+        quint64 keyspace = it->trimmed().toULongLong(&ok);
+        if (ok) {
+            return keyspace;
+        }
+    }
+    return 0;
+}
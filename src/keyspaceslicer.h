@@ -0,0 +1,39 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef KEYSPACESLICER_H
+#define KEYSPACESLICER_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+// Part of the keyspace processed by one hashcat process
+struct KeyspaceSlice {
+    QString devices;
+    QString cpuAffinity;
+    quint64 skip = 0;
+    quint64 limit = 0;
+};
+
+class KeyspaceSlicer
+{
+public:
+    // "1,2,3" runs one process per device, "1,2;3" groups devices 1 and 2 into one process
+    static QStringList deviceGroups(const QString &devices);
+
+    // Splits [skip, skip + limit) proportionally to weights, equal shares if no weights are given
+    static QList<KeyspaceSlice> split(quint64 skip, quint64 limit, const QStringList &groups,
+                                      const QList<double> &weights = {}, const QString &cpuAffinity = QString());
+
+    // Arguments for one slice, based on the arguments of the whole attack
+    static QStringList sliceArguments(const QStringList &arguments, const KeyspaceSlice &slice,
+                                      const QString &session, const QString &outfile = QString());
+
+    // Output of "hashcat --keyspace", 0 if it can't be parsed
+    static quint64 parseKeyspace(const QString &output);
+};
+
+#endif // KEYSPACESLICER_H
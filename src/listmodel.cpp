@@ -0,0 +1,53 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "listmodel.h"
+#include <QDir>
+#include <QMimeData>
+#include <QUrl>
+
+ListModel::ListModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+FileListModel::FileListModel(QObject *parent)
+    : ListModel(parent)
+{
+}
+
+QStringList FileListModel::mimeTypes() const
+{
+    return { "text/uri-list" };
+}
+
+Qt::DropActions FileListModel::supportedDropActions() const
+{
+    return Qt::CopyAction | Qt::MoveAction | Qt::LinkAction;
+}
+
+bool FileListModel::canDropMimeData(const QMimeData *data, [[maybe_unused]] Qt::DropAction action,
+                                    [[maybe_unused]] int row, [[maybe_unused]] int column,
+                                    [[maybe_unused]] const QModelIndex &parent) const
+{
+    return data->hasUrls();
+}
+
+bool FileListModel::dropMimeData(const QMimeData *data, [[maybe_unused]] Qt::DropAction action,
+                                 [[maybe_unused]] int row, [[maybe_unused]] int column,
+                                 [[maybe_unused]] const QModelIndex &parent)
+{
+    QStringList paths;
+    const QList<QUrl> urls = data->urls();
+
+    for (const QUrl &url : urls) {
+        if (url.isLocalFile()) {
+            paths << QDir::toNativeSeparators(url.toLocalFile());
+        }
+    }
+
+    addDroppedPaths(paths);
+    return true;
+}
@@ -0,0 +1,89 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef LISTMODEL_H
+#define LISTMODEL_H
+
+#include <QAbstractTableModel>
+#include <QList>
+#include <QStringList>
+#include <algorithm>
+#include <functional>
+
+// Table model whose rows are the entries of a QList, reordered and removed by the user
+class ListModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit ListModel(QObject *parent = nullptr);
+
+protected:
+    // Moves one entry by delta rows, false if it would leave the list
+    template <typename T>
+    bool moveListRow(QList<T> &list, int row, int delta)
+    {
+        const int target = row + delta;
+        if (row < 0 || row >= list.size() || target < 0 || target >= list.size() || delta == 0) {
+            return false;
+        }
+
+        // beginMoveRows() expects the destination in terms of the list before the move
+        beginMoveRows(QModelIndex(), row, row, QModelIndex(), delta > 0 ? target + 1 : target);
+        list.move(row, target);
+        endMoveRows();
+        return true;
+    }
+
+    // Removes contiguous ranges at once and from the back, so the remaining rows stay valid.
+    // removing sees every range before it is gone, e.g. to update counters.
+    template <typename T>
+    void removeListRows(QList<T> &list, QList<int> rows, const std::function<void(int first, int last)> &removing = {})
+    {
+        std::sort(rows.begin(), rows.end(), std::greater<int>());
+        rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+        int i = 0;
+        while (i < rows.size()) {
+            const int last = rows.at(i);
+            int first = last;
+            while (i + 1 < rows.size() && rows.at(i + 1) == first - 1) {
+                first = rows.at(++i);
+            }
+            ++i;
+
+            if (first < 0 || last >= list.size()) {
+                continue;
+            }
+
+            beginRemoveRows(QModelIndex(), first, last);
+            if (removing) {
+                removing(first, last);
+            }
+            list.remove(first, last - first + 1);
+            endRemoveRows();
+        }
+    }
+};
+
+// List of files that takes files dropped from a file manager
+class FileListModel : public ListModel
+{
+    Q_OBJECT
+
+public:
+    explicit FileListModel(QObject *parent = nullptr);
+
+    QStringList mimeTypes() const override;
+    Qt::DropActions supportedDropActions() const override;
+    bool canDropMimeData(const QMimeData *data, Qt::DropAction action, int row, int column, const QModelIndex &parent) const override;
+    bool dropMimeData(const QMimeData *data, Qt::DropAction action, int row, int column, const QModelIndex &parent) override;
+
+protected:
+    // Local paths of a drop with native separators, files as well as folders
+    virtual void addDroppedPaths(const QStringList &paths) = 0;
+};
+
+#endif // LISTMODEL_H
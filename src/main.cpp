@@ -4,15 +4,59 @@
  */
 
 #include <QApplication>
+#include <QTimer>
+#include "batchrunner.h"
 #include "mainwindow.h"
+#include "startuptrace.h"
 #include "config.h"
 
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <cstdio>
+
+// A GUI subsystem program has no console of its own, batch mode writes to the one it was started from.
+// Output that is redirected to a file or pipe already has a stream and stays there.
+static void attachParentConsole()
+{
+    if (!AttachConsole(ATTACH_PARENT_PROCESS)) {
+        return;
+    }
+    if (_fileno(stdout) < 0) {
+        std::freopen("CONOUT$", "w", stdout);
+    }
+    if (_fileno(stderr) < 0) {
+        std::freopen("CONOUT$", "w", stderr);
+    }
+}
+#endif
+
 int main(int argc, char *argv[])
 {
+    // No display needed, neither widgets nor the hash mode list are loaded
+    if (BatchRunner::requested(argc, argv)) {
+#if defined(Q_OS_WIN)
+        attachParentConsole();
+#endif
+        QCoreApplication a(argc, argv);
+        a.setApplicationVersion(GUI_VERSION);
+        return BatchRunner::exec();
+    }
+
+    StartupTrace::init(argc, argv);
+
     QApplication a(argc, argv);
     a.setApplicationVersion(GUI_VERSION);
+    QObject::connect(&a, &QCoreApplication::aboutToQuit, &StartupTrace::finish);
+    StartupTrace::mark("QApplication");
+
     MainWindow w;
-    w.show();
+    {
+        StartupTrace::Scope scope("show");
+        w.show();
+    }
+
+    // The first pass of the event loop paints the window, everything after it runs in the background
+    QTimer::singleShot(0, [] { StartupTrace::mark("interactive"); });
 
     return a.exec();
 }
@@ -9,19 +9,52 @@
 #include "settingsdialog.h"
 #include "settingsmanager.h"
 #include "helperutils.h"
-#include "widgetstateserializer.h"
+#include "hashmodecatalog.h"
+#include "hashmodemodel.h"
+#include "sessiondialog.h"
+#include "sessionindex.h"
+#include "jobqueue.h"
+#include "jobqueuedialog.h"
+#include "benchmarkcache.h"
+#include "benchmarkdialog.h"
+#include "wordlistmodel.h"
+#include "wordlistmergedialog.h"
+#include "keyspaceslicer.h"
+#include "keyspaceestimator.h"
+#include "maskfiledialog.h"
+#include "maskparser.h"
+#include "passwordstatsdialog.h"
+#include "hashfileanalyzer.h"
+#include "hashpreprocessor.h"
+#include "potfileindex.h"
+#include "restoredialog.h"
+#include "resultsdialog.h"
+#include "ruleanalyzer.h"
+#include "rulesfilemodel.h"
+#include "fileviewerdialog.h"
+#include "startuptrace.h"
 #include <QDateTime>
 #include <QDir>
 #include <QFileDialog>
+#include <QFileSystemWatcher>
 #include <QFileInfo>
 #include <QMessageBox>
 #include <QProcess>
+#include <QProgressDialog>
+#include <QtConcurrent>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QAbstractItemModel>
 #include <QClipboard>
+#include <QCompleter>
+#include <QHeaderView>
+#include <QLocale>
+#include <QMenu>
+#include <QRegularExpressionValidator>
 #include <QStandardPaths>
-#include <QFutureWatcher>
+#include <QThreadPool>
+#include <algorithm>
+#include <limits>
 
 #if defined(Q_OS_WIN)
 #include <process.h>
@@ -31,11 +64,61 @@
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
+    , hashModeCatalog(new HashModeCatalog(this))
+    , hashModeModel(new HashModeModel(this))
+    , hashModeFilter(new HashModeFilterModel(this))
+    , jobQueue(new JobQueue(this))
+    , keyspaceEstimator(new KeyspaceEstimator(this))
+    , hashFileAnalyzer(new HashFileAnalyzer(this))
+    , potfileWatcher(new QFileSystemWatcher(this))
+    , benchmarkCache(new BenchmarkCache(this))
+    , wordlistModel(new WordlistModel(this))
+    , rulesFileModel(new RulesFileModel(this))
 {
-    ui->setupUi(this);
+    StartupTrace::Scope scope("MainWindow");
+    {
+        StartupTrace::Scope scope("setupUi");
+        ui->setupUi(this);
+    }
 
     auto &settings = SettingsManager::instance();
 
+    /* ---------- hash mode catalog ---------- */
+    connect(hashModeCatalog, &HashModeCatalog::updated, this, &MainWindow::populateHashModes);
+    connect(hashModeCatalog, &HashModeCatalog::failed, this, [this](const QString &error) {
+        // A stale catalog is still usable, only complain if there is nothing to show
+        if (hashModeModel->rowCount() == 0) {
+            ui->comboBox_hash->setToolTip(QString());
+            QMessageBox::warning(this, tr("hashcat error"), error);
+        }
+    });
+
+    /* ---------- hash mode selector ---------- */
+    QList<quint32> recentHashModes;
+    for (const QVariant &id : settings.getKey<QVariantList>("recentHashModes")) {
+        recentHashModes << id.toUInt();
+    }
+    hashModeModel->setRecent(recentHashModes);
+    hashModeFilter->setSourceModel(hashModeModel);
+
+    // Typing filters the modes in a popup, picking one selects it in the combo box
+    ui->comboBox_hash->setModel(hashModeModel);
+    ui->comboBox_hash->setEditable(true);
+    ui->comboBox_hash->setInsertPolicy(QComboBox::NoInsert);
+    ui->comboBox_hash->lineEdit()->setPlaceholderText(tr("Type to filter, e.g. ntlm or 1000"));
+    QCompleter *hashModeCompleter = new QCompleter(hashModeFilter, this);
+    hashModeCompleter->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    hashModeCompleter->setMaxVisibleItems(15);
+    ui->comboBox_hash->setCompleter(hashModeCompleter);
+    connect(ui->comboBox_hash->lineEdit(), &QLineEdit::textEdited, this, [this, hashModeCompleter](const QString &text) {
+        hashModeFilter->setQuery(text);
+        hashModeCompleter->complete();
+    });
+    // A filter that was not picked from is replaced by the selected mode again
+    connect(ui->comboBox_hash->lineEdit(), &QLineEdit::editingFinished, this, [this] {
+        ui->comboBox_hash->setEditText(ui->comboBox_hash->itemText(ui->comboBox_hash->currentIndex()));
+    });
+
     initHashAndAttackModes();
     updateViewAttackMode();
 
@@ -50,25 +133,105 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->actionImport, &QAction::triggered, this, &MainWindow::importTriggered);
     connect(ui->actionSettings, &QAction::triggered, this, &MainWindow::settingsTriggered);
     connect(ui->actionAbout_Qt, &QAction::triggered, this, &MainWindow::aboutQtTriggered);
+    connect(ui->actionJob_queue, &QAction::triggered, this, &MainWindow::jobQueueTriggered);
+    connect(ui->actionBenchmarks, &QAction::triggered, this, &MainWindow::benchmarksTriggered);
+    connect(ui->actionMerge_wordlists, &QAction::triggered, this, &MainWindow::mergeWordlistsTriggered);
+    connect(ui->actionMask_file, &QAction::triggered, this, &MainWindow::maskFileTriggered);
+    connect(ui->toolButton_mask_file, &QToolButton::clicked, this, &MainWindow::maskFileTriggered);
+    connect(ui->actionPassword_statistics, &QAction::triggered, this, &MainWindow::passwordStatsTriggered);
+    connect(ui->actionResults, &QAction::triggered, this, &MainWindow::resultsTriggered);
+    connect(ui->actionInterrupted_sessions, &QAction::triggered, this, &MainWindow::restoreSessionsTriggered);
+    connect(ui->actionView_file, &QAction::triggered, this, &MainWindow::viewFileTriggered);
 
     /* ---------- wordlist ---------- */
-    connect(ui->listWidget_wordlist->model(), &QAbstractItemModel::rowsInserted, this, [this] { commandChanged(); });
-    connect(ui->listWidget_wordlist->model(), &QAbstractItemModel::rowsRemoved, this, [this] { commandChanged(); });
-    connect(ui->listWidget_wordlist->model(), &QAbstractItemModel::rowsMoved, this, [this] { commandChanged(); });
-    connect(ui->listWidget_wordlist, &QListWidget::itemChanged, this, [this] { commandChanged(); });
-    connect(ui->listWidget_wordlist, &QListWidget::itemClicked, this, &MainWindow::wordlistItemClicked);
+    ui->tableView_wordlist->setModel(wordlistModel);
+    ui->tableView_wordlist->horizontalHeader()->setSectionResizeMode(WordlistModel::ColumnPath, QHeaderView::Stretch);
+    for (int column = WordlistModel::ColumnSize; column < WordlistModel::ColumnCount; ++column) {
+        ui->tableView_wordlist->horizontalHeader()->setSectionResizeMode(column, QHeaderView::ResizeToContents);
+    }
+    const auto wordlistsChanged = [this] {
+        spec.wordlists = wordlistModel->wordlists();
+        commandChanged();
+    };
+    connect(wordlistModel, &QAbstractItemModel::rowsInserted, this, wordlistsChanged);
+    connect(wordlistModel, &QAbstractItemModel::rowsRemoved, this, wordlistsChanged);
+    connect(wordlistModel, &QAbstractItemModel::rowsMoved, this, wordlistsChanged);
+    connect(wordlistModel, &QAbstractItemModel::modelReset, this, wordlistsChanged);
+    connect(wordlistModel, &QAbstractItemModel::dataChanged, this, [wordlistsChanged](const QModelIndex &, const QModelIndex &, const QList<int> &roles) {
+        // Statistics arriving in the background don't change the command
+        if (roles.contains(Qt::CheckStateRole)) {
+            wordlistsChanged();
+        }
+    });
+    connect(ui->tableView_wordlist->selectionModel(), &QItemSelectionModel::selectionChanged, this, &MainWindow::wordlistSelectionChanged);
+    connect(ui->pushButton_add_wordlist_folder, &QPushButton::clicked, this, &MainWindow::addWordlistFolderClicked);
     connect(ui->pushButton_remove_wordlist, &QPushButton::clicked, this, &MainWindow::removeWordlistClicked);
     connect(ui->pushButton_add_wordlist, &QPushButton::clicked, this, &MainWindow::addWordlistClicked);
     connect(ui->toolButton_wordlist_sort_asc, &QToolButton::clicked, this, &MainWindow::wordlistSortAscClicked);
     connect(ui->toolButton_wordlist_sort_desc, &QToolButton::clicked, this, &MainWindow::wordlistSortDescClicked);
+    connect(ui->tableView_wordlist, &QTableView::doubleClicked, this, [this](const QModelIndex &index) {
+        viewFile(wordlistModel->wordlists().value(index.row()).path);
+    });
+    ui->tableView_wordlist->setContextMenuPolicy(Qt::CustomContextMenu);
+    connect(ui->tableView_wordlist, &QWidget::customContextMenuRequested, this, [this](const QPoint &pos) {
+        const QModelIndex index = ui->tableView_wordlist->indexAt(pos);
+        if (!index.isValid()) {
+            return;
+        }
+        QMenu menu(this);
+        const QString path = wordlistModel->wordlists().value(index.row()).path;
+        connect(menu.addAction(tr("View")), &QAction::triggered, this, [this, path] { viewFile(path); });
+        menu.exec(ui->tableView_wordlist->viewport()->mapToGlobal(pos));
+    });
+
+    /* ---------- attack spec ---------- */
+    bindSpec();
 
     /* ---------- rules ---------- */
-    connect(ui->checkBox_rulesfile_1, &QCheckBox::toggled, this, &MainWindow::rulesfile1Toggled);
-    connect(ui->checkBox_rulesfile_2, &QCheckBox::toggled, this, &MainWindow::rulesfile2Toggled);
-    connect(ui->checkBox_rulesfile_3, &QCheckBox::toggled, this, &MainWindow::rulesfile3Toggled);
-    connect(ui->pushButton_open_rulesfile_1, &QPushButton::clicked, this, &MainWindow::openRulesFile1Clicked);
-    connect(ui->pushButton_open_rulesfile_2, &QPushButton::clicked, this, &MainWindow::openRulesFile2Clicked);
-    connect(ui->pushButton_open_rulesfile_3, &QPushButton::clicked, this, &MainWindow::openRulesFile3Clicked);
+    ui->tableView_rules->setModel(rulesFileModel);
+    ui->tableView_rules->horizontalHeader()->setSectionResizeMode(RulesFileModel::ColumnPath, QHeaderView::Stretch);
+    for (int column = RulesFileModel::ColumnRules; column < RulesFileModel::ColumnCount; ++column) {
+        ui->tableView_rules->horizontalHeader()->setSectionResizeMode(column, QHeaderView::ResizeToContents);
+    }
+    const auto rulesFilesChanged = [this] {
+        spec.rulesFiles = rulesFileModel->rulesFiles();
+        commandChanged();
+    };
+    connect(rulesFileModel, &QAbstractItemModel::rowsInserted, this, rulesFilesChanged);
+    connect(rulesFileModel, &QAbstractItemModel::rowsRemoved, this, rulesFilesChanged);
+    connect(rulesFileModel, &QAbstractItemModel::rowsMoved, this, rulesFilesChanged);
+    connect(rulesFileModel, &QAbstractItemModel::modelReset, this, rulesFilesChanged);
+    connect(rulesFileModel, &QAbstractItemModel::dataChanged, this, [rulesFilesChanged](const QModelIndex &, const QModelIndex &, const QList<int> &roles) {
+        if (roles.contains(Qt::CheckStateRole) || roles.contains(Qt::EditRole)) {
+            rulesFilesChanged();
+        }
+    });
+    // Counts arriving in the background only change the multiplier
+    connect(rulesFileModel, &RulesFileModel::analyzed, this, [this] {
+        updateRulesInfo();
+        updateEstimate();
+    });
+    connect(ui->tableView_rules->selectionModel(), &QItemSelectionModel::selectionChanged, this, &MainWindow::rulesFileSelectionChanged);
+    connect(ui->pushButton_add_rulesfile, &QPushButton::clicked, this, &MainWindow::addRulesFileClicked);
+    connect(ui->pushButton_remove_rulesfile, &QPushButton::clicked, this, &MainWindow::removeRulesFileClicked);
+    connect(ui->pushButton_optimize_rulesfile, &QPushButton::clicked, this, &MainWindow::optimizeRulesFileClicked);
+    connect(ui->toolButton_rulesfile_up, &QToolButton::clicked, this, &MainWindow::rulesFileUpClicked);
+    connect(ui->toolButton_rulesfile_down, &QToolButton::clicked, this, &MainWindow::rulesFileDownClicked);
+    connect(ui->tableView_rules, &QTableView::doubleClicked, this, [this](const QModelIndex &index) {
+        viewFile(rulesFileModel->rulesFiles().value(index.row()).value);
+    });
+    ui->tableView_rules->setContextMenuPolicy(Qt::CustomContextMenu);
+    connect(ui->tableView_rules, &QWidget::customContextMenuRequested, this, [this](const QPoint &pos) {
+        const QModelIndex index = ui->tableView_rules->indexAt(pos);
+        if (!index.isValid()) {
+            return;
+        }
+        QMenu menu(this);
+        const QString path = rulesFileModel->rulesFiles().value(index.row()).value;
+        connect(menu.addAction(tr("View")), &QAction::triggered, this, [this, path] { viewFile(path); });
+        connect(menu.addAction(tr("Remove duplicates...")), &QAction::triggered, this, &MainWindow::optimizeRulesFileClicked);
+        menu.exec(ui->tableView_rules->viewport()->mapToGlobal(pos));
+    });
     connect(ui->radioButton_generate_rules, &QRadioButton::toggled, this, &MainWindow::generateRulesToggled);
     connect(ui->radioButton_use_rules_file, &QRadioButton::toggled, this, &MainWindow::useRulesFileToggled);
 
@@ -83,16 +246,66 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->pushButton_open_hashfile, &QPushButton::clicked, this, &MainWindow::openHashFileClicked);
     connect(ui->pushButton_output, &QPushButton::clicked, this, &MainWindow::outputClicked);
     connect(ui->pushButton_execute, &QPushButton::clicked, this, &MainWindow::executeClicked);
+    connect(ui->pushButton_add_queue, &QPushButton::clicked, this, &MainWindow::addToQueueClicked);
     connect(ui->pushButton_copy_clipboard, &QPushButton::clicked, this, &MainWindow::copyCommandToClipboard);
     connect(ui->checkBox_override_workload_profile, &QCheckBox::toggled, ui->comboBox_workload_profile, &QComboBox::setEnabled);
     connect(ui->comboBox_attack, &QComboBox::currentIndexChanged, this, &MainWindow::attackIndexChanged);
     connect(ui->checkBox_outfile, &QCheckBox::toggled, this, &MainWindow::outfileToggled);
+    connect(ui->checkBox_preprocess_hashes, &QCheckBox::toggled, ui->spinBox_hashes_per_run, &QSpinBox::setEnabled);
+    addViewFileMenu(ui->lineEdit_hashfile);
+    addViewFileMenu(ui->lineEdit_outfile);
+
+    /* ---------- keyspace ---------- */
+    ui->lineEdit_skip->setValidator(new QRegularExpressionValidator(QRegularExpression("\\d*"), this));
+    ui->lineEdit_limit->setValidator(new QRegularExpressionValidator(QRegularExpression("\\d*"), this));
+
+    /* ---------- keyspace estimate ---------- */
+    connect(keyspaceEstimator, &KeyspaceEstimator::estimated, this, [this](quint64 keyspace, quint64 candidates) {
+        estimatedKeyspace = keyspace;
+        estimatedCandidates = candidates;
+        showEstimate();
+    });
+    connect(keyspaceEstimator, &KeyspaceEstimator::failed, this, [this](const QString &error) {
+        ui->label_estimate->setText(tr("Keyspace: -"));
+        ui->label_estimate->setToolTip(error);
+    });
+    connect(benchmarkCache, &BenchmarkCache::speedsChanged, this, [this] {
+        if (estimatedKeyspace > 0) {
+            showEstimate();
+        }
+    });
 
-    loadDefaultProfile();
+    /* ---------- hash file analysis ---------- */
+    connect(hashFileAnalyzer, &HashFileAnalyzer::started, this, [this] {
+        ui->label_hashfile_analysis->setText(tr("Analyzing hash file..."));
+        ui->label_hashfile_analysis->setToolTip(QString());
+    });
+    connect(hashFileAnalyzer, &HashFileAnalyzer::progress, this, [this](int percent) {
+        ui->label_hashfile_analysis->setText(tr("Analyzing hash file... %1%").arg(percent));
+    });
+    connect(hashFileAnalyzer, &HashFileAnalyzer::analyzed, this, &MainWindow::showHashFileAnalysis);
+    connect(ui->comboBox_hash, &QComboBox::currentIndexChanged, this, &MainWindow::updateHashFileAnalysis);
+    connect(ui->checkBox_ignoreusername, &QCheckBox::toggled, this, &MainWindow::updateHashFileAnalysis);
+    // hashcat appends to the potfile while it cracks, the analyzer waits until it stops changing
+    connect(potfileWatcher, &QFileSystemWatcher::fileChanged, this, &MainWindow::updateHashFileAnalysis);
+    watchPotfile();
+
+    {
+        StartupTrace::Scope scope("loadDefaultProfile");
+        loadDefaultProfile();
+    }
+
+    // Scanning PATH for terminals only matters once a session is started
+    QThreadPool::globalInstance()->start([] {
+        StartupTrace::Scope scope("terminals");
+        HelperUtils::getAvailableTerminals();
+    });
 
     /* ---------- show Settings if hashcatPath not set ---------- */
     if (settings.getKey<QString>("hashcatPath").isEmpty()) {
         QMetaObject::invokeMethod(this, &MainWindow::settingsTriggered, Qt::QueuedConnection);
+    } else {
+        QMetaObject::invokeMethod(this, &MainWindow::checkInterruptedSessions, Qt::QueuedConnection);
     }
 }
 
@@ -106,16 +319,17 @@ MainWindow::~MainWindow()
 // File → Export
 void MainWindow::exportTriggered()
 {
-    QStringList ignoreWidgets = { "lineEdit_command" };
-
     QString file = QFileDialog::getSaveFileName(
         this, tr("Save Profile"),
         QString(),
         tr("JSON Files (*.json)"));
 
     if (!file.isEmpty()) {
-        WidgetStateSerializer s;
-        s.saveStateToFile(QString::fromUtf8(metaObject()->className()), this, file, ignoreWidgets);
+        QString error;
+        if (!AttackSpec::writeProfile(file, spec.toJson(), &error)) {
+            QMessageBox::warning(this, tr("Save failed"), error);
+            return;
+        }
         QMessageBox::information(this, tr("Saved"), tr("Profile saved to %1.").arg(file));
     }
 }
@@ -129,57 +343,242 @@ void MainWindow::importTriggered()
         tr("JSON Files (*.json)"));
 
     if (!file.isEmpty()) {
-        WidgetStateSerializer s;
-        if (s.loadStateFromFile(QString::fromUtf8(metaObject()->className()), this, file)) {
-            commandChanged();
-            QMessageBox::information(this, tr("Loaded"), tr("Profile loaded from %1.").arg(file));
+        QJsonObject profile;
+        QString error;
+        if (!AttackSpec::readProfile(file, &profile, &error)) {
+            QMessageBox::warning(this, tr("Load failed"), error);
+            return;
         }
+        loadProfile(profile);
+        QMessageBox::information(this, tr("Loaded"), tr("Profile loaded from %1.").arg(file));
     }
 }
 
 // Tools → Reset field
 void MainWindow::resetFieldsTriggered()
 {
-    // Main tab
-    ui->lineEdit_hashfile->clear();
-    ui->checkBox_ignoreusername->setChecked(false);
-    ui->checkBox_remove->setChecked(false);
-    ui->listWidget_wordlist->clear();
-    ui->comboBox_attack->setCurrentIndex(0);
-    ui->comboBox_hash->setCurrentIndex(0);
-    ui->radioButton_use_rules_file->setChecked(true);
-    ui->checkBox_rulesfile_1->setChecked(false);
-    ui->checkBox_rulesfile_2->setChecked(false);
-    ui->checkBox_rulesfile_3->setChecked(false);
-    ui->lineEdit_open_rulesfile_1->clear();
-    ui->lineEdit_open_rulesfile_2->clear();
-    ui->lineEdit_open_rulesfile_3->clear();
-    ui->spinBox_generate_rules->setValue(1);
-    ui->lineEdit_mask->clear();
-    ui->checkBox_custom_charset1->setChecked(false);
-    ui->lineEdit_custom_charset1->clear();
-    ui->checkBox_custom_charset2->setChecked(false);
-    ui->lineEdit_custom_charset2->clear();
-    ui->checkBox_custom_charset3->setChecked(false);
-    ui->lineEdit_custom_charset3->clear();
-    ui->checkBox_custom_charset4->setChecked(false);
-    ui->lineEdit_custom_charset4->clear();
-    ui->checkBox_hex_hash->setChecked(false);
-    ui->checkBox_hex_salt->setChecked(false);
-    ui->checkBox_outfile->setChecked(false);
-    ui->lineEdit_outfile->clear();
-    ui->lineEdit_outfile_format->setText("1,2");
-    ui->lineEdit_cpu_affinity->clear();
-    ui->lineEdit_devices->setText("0");
-    ui->spinBox_segment->setValue(32);
+    applySpec(AttackSpec());
+}
 
-    // Advanced tab
-    ui->checkBox_optimized_kernel->setChecked(false);
-    ui->checkBox_speed_only->setChecked(false);
-    ui->checkBox_override_workload_profile->setChecked(false);
-    ui->comboBox_workload_profile->setCurrentIndex(0);
+// Tools → Job queue
+void MainWindow::jobQueueTriggered()
+{
+    // Non-modal and only one instance, the queue keeps running when it is closed
+    if (!jobQueueDialog) {
+        jobQueueDialog = new JobQueueDialog(jobQueue, this);
+        jobQueueDialog->setAttribute(Qt::WA_DeleteOnClose);
+        connect(jobQueueDialog, &JobQueueDialog::loadProfileRequested, this, &MainWindow::loadProfile);
+    }
 
-    commandChanged();
+    jobQueueDialog->show();
+    jobQueueDialog->raise();
+    jobQueueDialog->activateWindow();
+}
+
+// Tools → Benchmarks
+void MainWindow::benchmarksTriggered()
+{
+    if (!benchmarkDialog) {
+        // Benchmark the devices the attack would use
+        QString devices = spec.devices;
+        devices.replace(';', ',');
+        if (devices == "0") {
+            devices.clear();
+        }
+
+        benchmarkDialog = new BenchmarkDialog(benchmarkCache, devices, this);
+        benchmarkDialog->setAttribute(Qt::WA_DeleteOnClose);
+        benchmarkDialog->setModes({ spec.hashMode });
+    }
+
+    benchmarkDialog->show();
+    benchmarkDialog->raise();
+    benchmarkDialog->activateWindow();
+}
+
+// Tools → Interrupted sessions
+void MainWindow::restoreSessionsTriggered()
+{
+    if (!restoreDialog) {
+        restoreDialog = new RestoreDialog(this);
+        restoreDialog->setAttribute(Qt::WA_DeleteOnClose);
+        connect(restoreDialog, &RestoreDialog::restoreRequested, this, &MainWindow::restoreSession);
+    } else {
+        restoreDialog->refresh();
+    }
+
+    restoreDialog->show();
+    restoreDialog->raise();
+    restoreDialog->activateWindow();
+}
+
+// Sessions the GUI started that were cut short, e.g. by a crash or a reboot, are offered at startup
+void MainWindow::checkInterruptedSessions()
+{
+    const QList<RestoreSession> sessions = SessionIndex::scan();
+    const bool interrupted = std::any_of(sessions.cbegin(), sessions.cend(), [](const RestoreSession &session) {
+        return session.isValid() && session.startedByGui && !session.isActive();
+    });
+    if (interrupted) {
+        restoreSessionsTriggered();
+    }
+}
+
+// Tools → Cracked results
+void MainWindow::resultsTriggered()
+{
+    if (!resultsDialog) {
+        resultsDialog = new ResultsDialog(this);
+        resultsDialog->setAttribute(Qt::WA_DeleteOnClose);
+    }
+
+    // Follow the outfile of the last launch, otherwise the one that is configured
+    if (followedOutfile.isEmpty()) {
+        followOutfile(outfileFromArguments(generateArguments()));
+    }
+    resultsDialog->setOutfile(followedOutfile, spec.outfileFormat);
+
+    resultsDialog->show();
+    resultsDialog->raise();
+    resultsDialog->activateWindow();
+}
+
+// Tools → View file
+void MainWindow::viewFileTriggered()
+{
+    const QString file = QFileDialog::getOpenFileName(this, tr("View file"));
+    if (!file.isEmpty()) {
+        viewFile(file);
+    }
+}
+
+// Any number of files can be open at once, each window indexes its own file
+void MainWindow::viewFile(const QString &file)
+{
+    if (!QFileInfo(file).isFile()) {
+        QMessageBox::information(this, tr("View file"), tr("%1 is not a file.").arg(file));
+        return;
+    }
+
+    FileViewerDialog *viewer = new FileViewerDialog(file, this);
+    viewer->setAttribute(Qt::WA_DeleteOnClose);
+    viewer->show();
+}
+
+// The standard context menu of a path field, extended by an entry to view the file
+void MainWindow::addViewFileMenu(QLineEdit *lineEdit)
+{
+    lineEdit->setContextMenuPolicy(Qt::CustomContextMenu);
+    connect(lineEdit, &QWidget::customContextMenuRequested, this, [this, lineEdit](const QPoint &pos) {
+        QMenu *menu = lineEdit->createStandardContextMenu();
+        menu->setAttribute(Qt::WA_DeleteOnClose);
+        menu->addSeparator();
+
+        const QString path = lineEdit->text();
+        QAction *view = menu->addAction(tr("View file"));
+        view->setEnabled(QFileInfo(path).isFile());
+        connect(view, &QAction::triggered, this, [this, path] { viewFile(path); });
+
+        menu->popup(lineEdit->mapToGlobal(pos));
+    });
+}
+
+// Tools → Merge wordlists
+void MainWindow::mergeWordlistsTriggered()
+{
+    if (!wordlistMergeDialog) {
+        const QStringList inputs = wordlistModel->checkedPaths();
+        if (inputs.size() < 2) {
+            QMessageBox::information(this, tr("Merge wordlists"), tr("Check at least two wordlists to merge."));
+            return;
+        }
+
+        wordlistMergeDialog = new WordlistMergeDialog(inputs, this);
+        wordlistMergeDialog->setAttribute(Qt::WA_DeleteOnClose);
+        connect(wordlistMergeDialog, &WordlistMergeDialog::merged, this, [this](const QString &output, const QStringList &inputs) {
+            // The merged file replaces its sources in the attack
+            const QList<WordlistModel::Wordlist> &wordlists = wordlistModel->wordlists();
+            for (int row = 0; row < wordlists.size(); ++row) {
+                const QString &path = wordlists.at(row).path;
+                if (path == output || inputs.contains(path)) {
+                    wordlistModel->setData(wordlistModel->index(row, WordlistModel::ColumnPath),
+                                           path == output ? Qt::Checked : Qt::Unchecked, Qt::CheckStateRole);
+                }
+            }
+            wordlistModel->addFiles({ output });
+        });
+    }
+
+    wordlistMergeDialog->show();
+    wordlistMergeDialog->raise();
+    wordlistMergeDialog->activateWindow();
+}
+
+// Tools → Mask file
+void MainWindow::maskFileTriggered()
+{
+    if (!maskFileDialog) {
+        maskFileDialog = new MaskFileDialog(&spec, this);
+        maskFileDialog->setAttribute(Qt::WA_DeleteOnClose);
+        connect(maskFileDialog, &MaskFileDialog::maskFileChosen, ui->lineEdit_mask, &QLineEdit::setText);
+        maskFileDialog->setPotfile(currentPotfile());
+        updateMaskFileCost();
+
+        // A mask file the attack already uses is opened for editing
+        if (MaskParser::isHcmaskFile(spec.mask)) {
+            maskFileDialog->openFile(spec.mask);
+        }
+    }
+
+    maskFileDialog->show();
+    maskFileDialog->raise();
+    maskFileDialog->activateWindow();
+}
+
+// Tools → Password statistics
+void MainWindow::passwordStatsTriggered()
+{
+    if (!passwordStatsDialog) {
+        passwordStatsDialog = new PasswordStatsDialog(this);
+        passwordStatsDialog->setAttribute(Qt::WA_DeleteOnClose);
+
+        connect(passwordStatsDialog, &PasswordStatsDialog::maskChosen, this, [this](const QString &mask, const QStringList &customCharsets) {
+            ui->comboBox_attack->setCurrentText(attackModes.value(AttackSpec::BruteForce));
+            ui->lineEdit_mask->setText(mask);
+            const std::array<QPair<QCheckBox *, QLineEdit *>, 4> charsets = { {
+                { ui->checkBox_custom_charset1, ui->lineEdit_custom_charset1 },
+                { ui->checkBox_custom_charset2, ui->lineEdit_custom_charset2 },
+                { ui->checkBox_custom_charset3, ui->lineEdit_custom_charset3 },
+                { ui->checkBox_custom_charset4, ui->lineEdit_custom_charset4 },
+            } };
+            for (size_t i = 0; i < charsets.size(); ++i) {
+                const QString charset = customCharsets.value(static_cast<qsizetype>(i));
+                charsets[i].first->setChecked(!charset.isEmpty());
+                charsets[i].second->setText(charset);
+            }
+        });
+        connect(passwordStatsDialog, &PasswordStatsDialog::masksGenerated, this, [this](const QString &hcmask) {
+            ui->comboBox_attack->setCurrentText(attackModes.value(AttackSpec::BruteForce));
+            maskFileTriggered();
+            maskFileDialog->setMasks(hcmask);
+        });
+
+        // The potfile and the outfile of the attack are analyzed unless they are removed
+        const QString potfile = currentPotfile();
+        if (!potfile.isEmpty() && QFileInfo::exists(potfile)) {
+            passwordStatsDialog->addSource(potfile, true);
+        }
+        // The password has to be the last field, "2" alone writes only passwords
+        const QStringList fields = spec.outfileFormat.split(',', Qt::SkipEmptyParts);
+        if (spec.outfile.enabled && QFileInfo::exists(spec.outfile.value) && !fields.isEmpty() && fields.last().trimmed() == "2") {
+            passwordStatsDialog->addSource(spec.outfile.value, fields.size() > 1);
+        }
+        updateMaskFileCost();
+    }
+
+    passwordStatsDialog->show();
+    passwordStatsDialog->raise();
+    passwordStatsDialog->activateWindow();
 }
 
 // File → Settings
@@ -187,10 +586,12 @@ void MainWindow::settingsTriggered()
 {
     SettingsDialog settingsDialog(this);
     if (settingsDialog.exec() == QDialog::Accepted) {
-        // If SettingsDialog was saved and there are no hash types yet maybe we can populate them now
-        if (ui->comboBox_hash->count() == 0) {
-            initHashAndAttackModes();
-        }
+        // The hashcat binary might have changed, the catalog only refreshes if it did
+        hashModeCatalog->load();
+        watchPotfile();
+        updateHashFileAnalysis();
+        // Short parameters or the binary name might have changed
+        commandChanged();
     }
 }
 
@@ -226,38 +627,179 @@ void MainWindow::loadDefaultProfile()
 {
     QString file = defaultProfileFile();
     if (QFile::exists(file)) {
-        WidgetStateSerializer s;
-        if (s.loadStateFromFile(QString::fromUtf8(metaObject()->className()), this, file)) {
-            commandChanged();
+        QJsonObject profile;
+        QString error;
+        if (!AttackSpec::readProfile(file, &profile, &error)) {
+            QMessageBox::warning(this, tr("Load failed"), error);
+            return;
         }
+        loadProfile(profile);
     }
 }
 
 // Save the default profile – called by aboutToQuit signal
 void MainWindow::saveDefaultProfile()
 {
-    QStringList ignoreWidgets = { "lineEdit_command" };
     QString file = defaultProfileFile();
-    WidgetStateSerializer s;
-    if (!s.saveStateToFile(QString::fromUtf8(metaObject()->className()), this, file, ignoreWidgets)) {
+    if (!AttackSpec::writeProfile(file, spec.toJson())) {
         QMessageBox::warning(this, tr("Save failed"), tr("Could not write default profile to %1.").arg(file));
     }
 }
 
+// Profiles and queued jobs restore the whole attack
+void MainWindow::loadProfile(const QJsonObject &profile)
+{
+    applySpec(AttackSpec::fromJson(profile));
+
+    // Profiles keyed by widget names only stored the position in the hash mode list
+    if (!profile.contains("hashMode") && profile.contains("comboBox_hash")) {
+        const int index = profile.value("comboBox_hash").toInt();
+        const auto &modes = hashModeCatalog->modes();
+        if (modes.isEmpty()) {
+            legacyHashIndex = index;
+        } else if (index >= 0 && index < modes.size()) {
+            ui->comboBox_hash->setCurrentIndex(hashModeModel->rowOf(std::next(modes.cbegin(), index).key()));
+        }
+    }
+}
+
+// Every widget writes its own field of the spec as it changes, nothing reads the widgets back
+void MainWindow::bindSpec()
+{
+    const auto bindText = [this](QLineEdit *lineEdit, QString *field) {
+        connect(lineEdit, &QLineEdit::textChanged, this, [this, field](const QString &text) {
+            *field = text;
+            commandChanged();
+        });
+    };
+    const auto bindChecked = [this](QAbstractButton *button, bool *field) {
+        connect(button, &QAbstractButton::toggled, this, [this, field](bool checked) {
+            *field = checked;
+            commandChanged();
+        });
+    };
+    const auto bindValue = [this](QSpinBox *spinBox, int *field) {
+        connect(spinBox, &QSpinBox::valueChanged, this, [this, field](int value) {
+            *field = value;
+            commandChanged();
+        });
+    };
+    const auto bindOption = [&](QAbstractButton *button, QLineEdit *lineEdit, AttackSpec::Option *option) {
+        bindChecked(button, &option->enabled);
+        bindText(lineEdit, &option->value);
+    };
+
+    // Main tab
+    bindText(ui->lineEdit_hashfile, &spec.hashFile);
+    bindChecked(ui->checkBox_ignoreusername, &spec.ignoreUsername);
+    bindChecked(ui->checkBox_remove, &spec.remove);
+    bindChecked(ui->checkBox_preprocess_hashes, &spec.preprocessHashes);
+    bindValue(ui->spinBox_hashes_per_run, &spec.hashesPerRun);
+    connect(ui->comboBox_attack, &QComboBox::currentIndexChanged, this, [this](int index) {
+        spec.attackMode = attackModes.key(ui->comboBox_attack->itemText(index));
+        commandChanged();
+    });
+    connect(ui->comboBox_hash, &QComboBox::currentIndexChanged, this, [this](int index) {
+        // The list is emptied while the catalog is reloaded, the selection is restored afterwards
+        if (index >= 0) {
+            spec.hashMode = ui->comboBox_hash->itemData(index, HashModeModel::IdRole).toUInt();
+            commandChanged();
+        }
+    });
+    bindChecked(ui->radioButton_generate_rules, &spec.generateRules);
+    bindValue(ui->spinBox_generate_rules, &spec.generatedRules);
+    bindText(ui->lineEdit_mask, &spec.mask);
+    bindOption(ui->checkBox_custom_charset1, ui->lineEdit_custom_charset1, &spec.customCharsets[0]);
+    bindOption(ui->checkBox_custom_charset2, ui->lineEdit_custom_charset2, &spec.customCharsets[1]);
+    bindOption(ui->checkBox_custom_charset3, ui->lineEdit_custom_charset3, &spec.customCharsets[2]);
+    bindOption(ui->checkBox_custom_charset4, ui->lineEdit_custom_charset4, &spec.customCharsets[3]);
+    bindChecked(ui->checkBox_hex_hash, &spec.hexCharset);
+    bindChecked(ui->checkBox_hex_salt, &spec.hexSalt);
+    bindOption(ui->checkBox_outfile, ui->lineEdit_outfile, &spec.outfile);
+    bindText(ui->lineEdit_outfile_format, &spec.outfileFormat);
+    bindText(ui->lineEdit_cpu_affinity, &spec.cpuAffinity);
+    bindText(ui->lineEdit_devices, &spec.devices);
+    bindValue(ui->spinBox_segment, &spec.segmentSize);
+
+    // Advanced tab
+    bindChecked(ui->checkBox_optimized_kernel, &spec.optimizedKernel);
+    bindChecked(ui->checkBox_speed_only, &spec.speedOnly);
+    bindChecked(ui->checkBox_override_workload_profile, &spec.overrideWorkloadProfile);
+    connect(ui->comboBox_workload_profile, &QComboBox::currentIndexChanged, this, [this](int index) {
+        spec.workloadProfile = ui->comboBox_workload_profile->itemText(index).toInt();
+        commandChanged();
+    });
+    bindText(ui->lineEdit_skip, &spec.skip);
+    bindText(ui->lineEdit_limit, &spec.limit);
+    bindChecked(ui->checkBox_slice_keyspace, &spec.sliceKeyspace);
+}
+
+// The widgets show the spec, their bindings write it back field by field
+void MainWindow::applySpec(const AttackSpec &newSpec)
+{
+    // Main tab, the outfile follows the hash file and is set after it
+    ui->lineEdit_hashfile->setText(newSpec.hashFile);
+    ui->checkBox_ignoreusername->setChecked(newSpec.ignoreUsername);
+    ui->checkBox_remove->setChecked(newSpec.remove);
+    ui->checkBox_preprocess_hashes->setChecked(newSpec.preprocessHashes);
+    ui->spinBox_hashes_per_run->setValue(newSpec.hashesPerRun);
+    wordlistModel->setWordlists(newSpec.wordlists);
+    ui->comboBox_attack->setCurrentText(attackModes.value(newSpec.attackMode));
+    if (hashModeModel->rowOf(newSpec.hashMode) >= 0) {
+        ui->comboBox_hash->setCurrentIndex(hashModeModel->rowOf(newSpec.hashMode));
+    } else if (hashModeModel->rowCount() == 0) {
+        // Selected as soon as the catalog is loaded
+        spec.hashMode = newSpec.hashMode;
+    }
+
+    rulesFileModel->setRulesFiles(newSpec.rulesFiles);
+    ui->radioButton_use_rules_file->setChecked(!newSpec.generateRules);
+    ui->radioButton_generate_rules->setChecked(newSpec.generateRules);
+    ui->spinBox_generate_rules->setValue(newSpec.generatedRules);
+
+    ui->lineEdit_mask->setText(newSpec.mask);
+    const std::array<QPair<QCheckBox *, QLineEdit *>, 4> charsets = { {
+        { ui->checkBox_custom_charset1, ui->lineEdit_custom_charset1 },
+        { ui->checkBox_custom_charset2, ui->lineEdit_custom_charset2 },
+        { ui->checkBox_custom_charset3, ui->lineEdit_custom_charset3 },
+        { ui->checkBox_custom_charset4, ui->lineEdit_custom_charset4 },
+    } };
+    for (size_t i = 0; i < charsets.size(); ++i) {
+        charsets[i].first->setChecked(newSpec.customCharsets[i].enabled);
+        charsets[i].second->setText(newSpec.customCharsets[i].value);
+    }
+    ui->checkBox_hex_hash->setChecked(newSpec.hexCharset);
+    ui->checkBox_hex_salt->setChecked(newSpec.hexSalt);
+
+    ui->checkBox_outfile->setChecked(newSpec.outfile.enabled);
+    ui->lineEdit_outfile->setText(newSpec.outfile.value);
+    ui->lineEdit_outfile_format->setText(newSpec.outfileFormat);
+    ui->lineEdit_cpu_affinity->setText(newSpec.cpuAffinity);
+    ui->lineEdit_devices->setText(newSpec.devices);
+    ui->spinBox_segment->setValue(newSpec.segmentSize);
+
+    // Advanced tab
+    ui->checkBox_optimized_kernel->setChecked(newSpec.optimizedKernel);
+    ui->checkBox_speed_only->setChecked(newSpec.speedOnly);
+    ui->checkBox_override_workload_profile->setChecked(newSpec.overrideWorkloadProfile);
+    ui->comboBox_workload_profile->setCurrentText(QString::number(newSpec.workloadProfile));
+    ui->lineEdit_skip->setText(newSpec.skip);
+    ui->lineEdit_limit->setText(newSpec.limit);
+    ui->checkBox_slice_keyspace->setChecked(newSpec.sliceKeyspace);
+}
+
 void MainWindow::initHashAndAttackModes()
 {
     ui->comboBox_attack->clear();
-    ui->comboBox_hash->clear();
     attackModes.clear();
-    hashModes.clear();
 
     // Attack modes
-    attackModes.insert(AttackMode::Straight, "Straight");
-    attackModes.insert(AttackMode::Combination, "Combination");
-    attackModes.insert(AttackMode::BruteForce, "Brute-force");
-    attackModes.insert(AttackMode::HybridWordMask, "Hybrid Wordlist + Mask");
-    attackModes.insert(AttackMode::HybridMaskWord, "Hybrid Mask + Wordlist");
-    attackModes.insert(AttackMode::Association, "Association");
+    attackModes.insert(AttackSpec::Straight, "Straight");
+    attackModes.insert(AttackSpec::Combination, "Combination");
+    attackModes.insert(AttackSpec::BruteForce, "Brute-force");
+    attackModes.insert(AttackSpec::HybridWordMask, "Hybrid Wordlist + Mask");
+    attackModes.insert(AttackSpec::HybridMaskWord, "Hybrid Mask + Wordlist");
+    attackModes.insert(AttackSpec::Association, "Association");
 
     for (const auto &value : std::as_const(attackModes)) {
         ui->comboBox_attack->addItem(value);
@@ -270,52 +812,62 @@ void MainWindow::initHashAndAttackModes()
         ui->comboBox_hash->setToolTip("Updating...");
         ui->comboBox_hash->setEnabled(false);
 
-        // Create a watcher that will be destroyed once finished
-        QFutureWatcher<HashcatResult> *watcher = new QFutureWatcher<HashcatResult>(this);
-
-        // When the future is finished parse the JSON and fill hashModes
-        connect(watcher, &QFutureWatcher<HashcatResult>::finished, this, [this, watcher]() {
-            const HashcatResult &result = watcher->result();
-            watcher->deleteLater();
+        // Emits updated() once the cached catalog is read in the background, hashcat is only queried if the binary changed
+        hashModeCatalog->load();
+    }
+}
 
-            // Check if the command failed
-            if (result.exitStatus != QProcess::NormalExit || result.exitCode != 0) {
-                QMessageBox::warning(this, tr("hashcat error"), tr("Failed to obtain supported hash types.\nError: %1").arg(result.standardError));
-                return;
-            }
+// Modes of started or queued attacks are pinned at the top of the hash mode list
+void MainWindow::rememberHashMode()
+{
+    QList<quint32> recent = hashModeModel->recent();
+    recent.removeAll(spec.hashMode);
+    recent.prepend(spec.hashMode);
+    hashModeModel->setRecent(recent);
+
+    QVariantList ids;
+    for (quint32 id : hashModeModel->recent()) {
+        ids << id;
+    }
+    SettingsManager::instance().setKey("recentHashModes", ids);
+}
 
-            // The output is machine-readable JSON - strip newlines and parse
-            QString output = result.standardOutput.simplified();
+void MainWindow::populateHashModes()
+{
+    StartupTrace::Scope scope("populateHashModes");
 
-            QJsonDocument doc = QJsonDocument::fromJson(output.toUtf8());
-            if (!doc.isObject()) {
-                QMessageBox::warning(this, tr("hashcat error"), tr("Invalid JSON returned from hashcat."));
-                return;
-            }
+    // Keep the selection across background refreshes, a profile may have chosen it before the catalog was loaded
+    quint32 selected = spec.hashMode;
 
-            QJsonObject rootObj = doc.object();
+    QHash<quint32, QString> modeNames;
+    const auto &modes = hashModeCatalog->modes();
+    for (const HashMode &mode : modes) {
+        modeNames.insert(mode.id, mode.name);
+    }
 
-            hashModes.clear();
+    // Old profiles counted the position in the list sorted by id, without recently used modes
+    if (legacyHashIndex >= 0 && legacyHashIndex < modes.size()) {
+        selected = std::next(modes.cbegin(), legacyHashIndex).key();
+    }
+    legacyHashIndex = -1;
 
-            for (auto it = rootObj.constBegin(); it != rootObj.constEnd(); ++it) {
-                hashModes.insert(it.key().toInt(),
-                                 QString(it.key() + " | " + it.value().toObject().value("name").toString()));
-            }
+    // Benchmarks are only valid for the hashcat version they were measured with
+    benchmarkCache->setVersion(hashModeCatalog->hashcatVersion());
+    benchmarkCache->setModeNames(modeNames);
 
-            ui->comboBox_hash->clear();
+    // One model reset instead of one insertion per mode
+    hashModeModel->setModes(modes);
+    hashModeFilter->setQuery(QString());
 
-            // fill the combobox
-            for (const QString &value : std::as_const(hashModes)) {
-                ui->comboBox_hash->addItem(value);
-            }
+    const int row = hashModeModel->rowOf(selected);
+    ui->comboBox_hash->setCurrentIndex(row >= 0 ? row : 0);
 
-            ui->comboBox_hash->setEnabled(true);
-            ui->comboBox_hash->setToolTip(QString());
-        });
+    ui->comboBox_hash->setEnabled(true);
+    ui->comboBox_hash->setToolTip(QString());
 
-        // Kick off the asynchronous process
-        watcher->setFuture(HelperUtils::executeHashcat(QStringList() << "--example-hashes" << "--machine-readable"));
-    }
+    // The estimate needs the catalog even if the attack is unchanged
+    commandValid = false;
+    commandChanged();
 }
 
 void MainWindow::attackIndexChanged([[maybe_unused]] int index)
@@ -325,42 +877,10 @@ void MainWindow::attackIndexChanged([[maybe_unused]] int index)
 
 void MainWindow::updateViewAttackMode()
 {
-    int attackMode = attackModes.key(ui->comboBox_attack->currentText());
-    bool groupWordlists = false, groupRules = false, groupMask = false;
-
-    switch (attackMode) {
-    case AttackMode::Straight:
-        groupWordlists = true;
-        groupRules = true;
-        groupMask = false;
-        break;
-    case AttackMode::Combination:
-        groupWordlists = true;
-        groupRules = false;
-        groupMask = false;
-        break;
-    case AttackMode::BruteForce:
-        groupWordlists = false;
-        groupRules = false;
-        groupMask = true;
-        break;
-    case AttackMode::HybridWordMask:
-    case AttackMode::HybridMaskWord:
-        groupWordlists = true;
-        groupRules = false;
-        groupMask = true;
-        break;
-    case AttackMode::Association:
-        groupWordlists = true;
-        groupRules = true;
-        groupMask = false;
-        break;
-    }
-
-    ui->groupBox_wordlists->setEnabled(groupWordlists);
-    ui->groupBox_rules->setEnabled(groupRules);
-    ui->groupBox_custom_charset->setEnabled(groupMask);
-    ui->groupBox_mask->setEnabled(groupMask);
+    ui->groupBox_wordlists->setEnabled(spec.usesWordlists());
+    ui->groupBox_rules->setEnabled(spec.usesRules());
+    ui->groupBox_custom_charset->setEnabled(spec.usesMask());
+    ui->groupBox_mask->setEnabled(spec.usesMask());
     commandChanged();
 }
 
@@ -382,114 +902,152 @@ void MainWindow::outputClicked()
 
 void MainWindow::removeWordlistClicked()
 {
-    qDeleteAll(ui->listWidget_wordlist->selectedItems());
-    ui->pushButton_remove_wordlist->setEnabled(false);
-    ui->toolButton_wordlist_sort_asc->setEnabled(false);
-    ui->toolButton_wordlist_sort_desc->setEnabled(false);
-    ui->listWidget_wordlist->clearSelection();
+    QList<int> rows;
+    const QModelIndexList selected = ui->tableView_wordlist->selectionModel()->selectedRows();
+    for (const QModelIndex &index : selected) {
+        rows << index.row();
+    }
+
+    ui->tableView_wordlist->clearSelection();
+    wordlistModel->removeWordlists(rows);
 }
 
 void MainWindow::addWordlistClicked()
 {
     QStringList files = QFileDialog::getOpenFileNames();
-    QListWidget *w = ui->listWidget_wordlist;
 
-    for (const QString &wordlist : std::as_const(files)) {
-        // A file has been selected and it is not already in the list
-        if (!wordlist.isEmpty() && w->findItems(wordlist, Qt::MatchExactly).isEmpty()) {
-            QListWidgetItem *newItem = new QListWidgetItem(wordlist, w);
-            newItem->setCheckState(Qt::Checked);
-        }
+    // Files that are already in the list are skipped
+    wordlistModel->addFiles(files);
+}
+
+void MainWindow::addWordlistFolderClicked()
+{
+    QString directory = QFileDialog::getExistingDirectory(this);
+    if (!directory.isEmpty()) {
+        wordlistModel->addDirectory(directory);
     }
 }
 
 void MainWindow::wordlistSortAscClicked()
 {
-    int currentRow = ui->listWidget_wordlist->currentRow();
-    if (currentRow == 0) return;
-    QListWidgetItem *currentItem = ui->listWidget_wordlist->takeItem(currentRow);
-    ui->listWidget_wordlist->insertItem(currentRow - 1, currentItem);
-    ui->listWidget_wordlist->setCurrentRow(currentRow - 1);
+    int currentRow = ui->tableView_wordlist->currentIndex().row();
+    if (currentRow <= 0) return;
+    wordlistModel->moveWordlist(currentRow, -1);
+    ui->tableView_wordlist->setCurrentIndex(wordlistModel->index(currentRow - 1, 0));
 }
 
 void MainWindow::wordlistSortDescClicked()
 {
-    int currentRow = ui->listWidget_wordlist->currentRow();
-    if (currentRow >= ui->listWidget_wordlist->count() - 1) return;
-    QListWidgetItem *currentItem = ui->listWidget_wordlist->takeItem(currentRow);
-    ui->listWidget_wordlist->insertItem(currentRow + 1, currentItem);
-    ui->listWidget_wordlist->setCurrentRow(currentRow + 1);
+    int currentRow = ui->tableView_wordlist->currentIndex().row();
+    if (currentRow < 0 || currentRow >= wordlistModel->rowCount() - 1) return;
+    wordlistModel->moveWordlist(currentRow, 1);
+    ui->tableView_wordlist->setCurrentIndex(wordlistModel->index(currentRow + 1, 0));
 }
 
-void MainWindow::wordlistItemClicked([[maybe_unused]] QListWidgetItem *item)
+void MainWindow::wordlistSelectionChanged()
 {
-    ui->pushButton_remove_wordlist->setEnabled(true);
-    ui->toolButton_wordlist_sort_asc->setEnabled(true);
-    ui->toolButton_wordlist_sort_desc->setEnabled(true);
+    bool selected = ui->tableView_wordlist->selectionModel()->hasSelection();
+    ui->pushButton_remove_wordlist->setEnabled(selected);
+    ui->toolButton_wordlist_sort_asc->setEnabled(selected);
+    ui->toolButton_wordlist_sort_desc->setEnabled(selected);
 }
 
-void MainWindow::rulesfile1Toggled(bool checked)
+void MainWindow::addRulesFileClicked()
 {
-    ui->lineEdit_open_rulesfile_1->setEnabled(checked);
-    ui->pushButton_open_rulesfile_1->setEnabled(checked);
+    // The same file may be stacked more than once, e.g. best64 twice
+    rulesFileModel->addFiles(QFileDialog::getOpenFileNames());
 }
 
-void MainWindow::rulesfile2Toggled(bool checked)
+void MainWindow::removeRulesFileClicked()
 {
-    ui->lineEdit_open_rulesfile_2->setEnabled(checked);
-    ui->pushButton_open_rulesfile_2->setEnabled(checked);
+    QList<int> rows;
+    const QModelIndexList selected = ui->tableView_rules->selectionModel()->selectedRows();
+    for (const QModelIndex &index : selected) {
+        rows << index.row();
+    }
+
+    ui->tableView_rules->clearSelection();
+    rulesFileModel->removeRulesFiles(rows);
 }
 
-void MainWindow::rulesfile3Toggled(bool checked)
+void MainWindow::rulesFileUpClicked()
 {
-    ui->lineEdit_open_rulesfile_3->setEnabled(checked);
-    ui->pushButton_open_rulesfile_3->setEnabled(checked);
+    int currentRow = ui->tableView_rules->currentIndex().row();
+    if (currentRow <= 0) return;
+    rulesFileModel->moveRulesFile(currentRow, -1);
+    ui->tableView_rules->setCurrentIndex(rulesFileModel->index(currentRow - 1, 0));
 }
 
-void MainWindow::useRulesFileToggled(bool checked)
+void MainWindow::rulesFileDownClicked()
 {
-    ui->checkBox_rulesfile_1->setEnabled(checked);
-    ui->checkBox_rulesfile_2->setEnabled(checked);
-    ui->checkBox_rulesfile_3->setEnabled(checked);
-    if (checked) {
-        rulesfile1Toggled(ui->checkBox_rulesfile_1->isChecked());
-        rulesfile2Toggled(ui->checkBox_rulesfile_2->isChecked());
-        rulesfile3Toggled(ui->checkBox_rulesfile_3->isChecked());
-    }
+    int currentRow = ui->tableView_rules->currentIndex().row();
+    if (currentRow < 0 || currentRow >= rulesFileModel->rowCount() - 1) return;
+    rulesFileModel->moveRulesFile(currentRow, 1);
+    ui->tableView_rules->setCurrentIndex(rulesFileModel->index(currentRow + 1, 0));
 }
 
-void MainWindow::generateRulesToggled(bool checked)
+void MainWindow::rulesFileSelectionChanged()
 {
-    ui->spinBox_generate_rules->setEnabled(checked);
-    if (checked) {
-        useRulesFileToggled(false);
-        rulesfile1Toggled(false);
-        rulesfile2Toggled(false);
-        rulesfile3Toggled(false);
-    }
+    bool selected = ui->radioButton_use_rules_file->isChecked() && ui->tableView_rules->selectionModel()->hasSelection();
+    ui->pushButton_remove_rulesfile->setEnabled(selected);
+    ui->pushButton_optimize_rulesfile->setEnabled(selected);
+    ui->toolButton_rulesfile_up->setEnabled(selected);
+    ui->toolButton_rulesfile_down->setEnabled(selected);
 }
 
-void MainWindow::openRulesFile1Clicked()
+// Writes a copy of the current rules file without invalid and duplicate rules, the copy replaces it in the list
+void MainWindow::optimizeRulesFileClicked()
 {
-    QString rulesfile = QFileDialog::getOpenFileName();
-    if (!rulesfile.isEmpty()) {
-        ui->lineEdit_open_rulesfile_1->setText(QDir::toNativeSeparators(rulesfile));
+    const QString input = rulesFileModel->rulesFiles().value(ui->tableView_rules->currentIndex().row()).value;
+    if (input.isEmpty()) {
+        return;
     }
+
+    const QFileInfo info(input);
+    const QString suggestion = info.dir().filePath(info.completeBaseName() + "-unique." + (info.suffix().isEmpty() ? QString("rule") : info.suffix()));
+    const QString output = QFileDialog::getSaveFileName(this, tr("Remove duplicate rules"), suggestion);
+    if (output.isEmpty()) {
+        return;
+    }
+
+    ui->pushButton_optimize_rulesfile->setEnabled(false);
+
+    auto *watcher = new QFutureWatcher<RuleFileStats>(this);
+    connect(watcher, &QFutureWatcher<RuleFileStats>::finished, this, [this, watcher, input] {
+        watcher->deleteLater();
+        rulesFileSelectionChanged();
+
+        const RuleFileStats stats = watcher->result();
+        if (!stats.error.isEmpty()) {
+            QMessageBox::warning(this, tr("Remove duplicate rules"), stats.error);
+            return;
+        }
+
+        rulesFileModel->replaceFile(input, QDir::toNativeSeparators(stats.file));
+        QLocale locale;
+        QMessageBox::information(this, tr("Remove duplicate rules"),
+                                 tr("%1 of %2 rules are left: %3 duplicates, %4 rules with the same effect as an earlier one "
+                                    "and %5 invalid rules were removed.")
+                                     .arg(locale.toString(stats.unique()), locale.toString(stats.rules + stats.invalid),
+                                          locale.toString(stats.duplicates), locale.toString(stats.equivalent),
+                                          locale.toString(stats.invalid)));
+    });
+    watcher->setFuture(QtConcurrent::run(&RuleAnalyzer::optimize, input, output));
 }
 
-void MainWindow::openRulesFile2Clicked()
+void MainWindow::useRulesFileToggled(bool checked)
 {
-    QString rulesfile = QFileDialog::getOpenFileName();
-    if (!rulesfile.isEmpty()) {
-        ui->lineEdit_open_rulesfile_2->setText(QDir::toNativeSeparators(rulesfile));
-    }
+    ui->tableView_rules->setEnabled(checked);
+    ui->pushButton_add_rulesfile->setEnabled(checked);
+    rulesFileSelectionChanged();
+    updateRulesInfo();
 }
 
-void MainWindow::openRulesFile3Clicked()
+void MainWindow::generateRulesToggled(bool checked)
 {
-    QString rulesfile = QFileDialog::getOpenFileName();
-    if (!rulesfile.isEmpty()) {
-        ui->lineEdit_open_rulesfile_3->setText(QDir::toNativeSeparators(rulesfile));
+    ui->spinBox_generate_rules->setEnabled(checked);
+    if (checked) {
+        useRulesFileToggled(false);
     }
 }
 
@@ -524,6 +1082,92 @@ void MainWindow::hashFileTextChanged(const QString &text)
     if (!text.isEmpty()) {
         ui->lineEdit_outfile->setText(text + ".out");
     }
+    updateHashFileAnalysis();
+}
+
+// Check the hash file against the example hash of the selected mode in the background
+void MainWindow::updateHashFileAnalysis()
+{
+    const QString hashFile = spec.hashFile;
+    if (hashFile.trimmed().isEmpty()) {
+        hashFileAnalyzer->clear();
+        ui->label_hashfile_analysis->clear();
+        ui->label_hashfile_analysis->setToolTip(QString());
+        return;
+    }
+
+    // The potfile might have been created since it was looked for
+    if (potfileWatcher->files().isEmpty()) {
+        watchPotfile();
+    }
+
+    hashFileAnalyzer->request(hashFile, currentHashSignature(), spec.ignoreUsername, currentPotfile());
+}
+
+QString MainWindow::currentPotfile() const
+{
+    return PotfileIndex::defaultPotfile(SettingsManager::instance().getKey<QString>("hashcatPath"));
+}
+
+void MainWindow::watchPotfile()
+{
+    if (!potfileWatcher->files().isEmpty()) {
+        potfileWatcher->removePaths(potfileWatcher->files());
+    }
+
+    const QString potfile = currentPotfile();
+    if (!potfile.isEmpty()) {
+        potfileWatcher->addPath(potfile);
+    }
+}
+
+void MainWindow::showHashFileAnalysis(const HashFileAnalysis &analysis)
+{
+    QLocale locale;
+    QStringList details;
+
+    if (!analysis.error.isEmpty()) {
+        ui->label_hashfile_analysis->setText(analysis.error);
+        ui->label_hashfile_analysis->setToolTip(QString());
+        return;
+    }
+
+    if (analysis.validated) {
+        details << tr("Expected format: %1").arg(analysis.signature);
+    } else {
+        details << tr("The hash mode has no example hash to check the format against.");
+    }
+    if (analysis.potfileChecked) {
+        details << tr("Potfile: %1").arg(currentPotfile());
+    }
+    for (const auto &sample : analysis.samples) {
+        details << tr("Line %1: %2").arg(locale.toString(sample.first), sample.second);
+    }
+    ui->label_hashfile_analysis->setToolTip(details.join('\n'));
+
+    if (analysis.singleHash) {
+        if (analysis.cracked > 0) {
+            ui->label_hashfile_analysis->setText(tr("Single hash, already cracked"));
+        } else if (!analysis.validated) {
+            ui->label_hashfile_analysis->setText(tr("Single hash"));
+        } else if (analysis.malformed > 0) {
+            ui->label_hashfile_analysis->setText(tr("Single hash, does not match the example hash of this mode"));
+        } else {
+            ui->label_hashfile_analysis->setText(tr("Single hash, matches the example hash of this mode"));
+        }
+        return;
+    }
+
+    QString text = tr("%1 hashes, %2%3 duplicates").arg(locale.toString(analysis.lines),
+                                                        analysis.duplicatesEstimated ? "~" : "",
+                                                        locale.toString(analysis.duplicates));
+    if (analysis.validated) {
+        text += tr(", %1 malformed").arg(locale.toString(analysis.malformed));
+    }
+    if (analysis.potfileChecked) {
+        text += tr(", %1 of %2 already cracked").arg(locale.toString(analysis.cracked), locale.toString(analysis.lines));
+    }
+    ui->label_hashfile_analysis->setText(text);
 }
 
 void MainWindow::copyCommandToClipboard()
@@ -533,18 +1177,133 @@ void MainWindow::copyCommandToClipboard()
     clipboard->setText(text);
 }
 
-void MainWindow::executeClicked()
+bool MainWindow::validateHashFile()
 {
-    auto &settings = SettingsManager::instance();
-    QProcess proc;
-    QString terminal;
-    QStringList arguments;
-
-    if (ui->lineEdit_hashfile->text().isEmpty()) {
+    if (spec.hashFile.isEmpty()) {
         QMessageBox msgBox(this);
         msgBox.setIcon(QMessageBox::Information);
         msgBox.setText("Please choose a hash file.");
         msgBox.exec();
+        return false;
+    }
+
+    // Only a finished analysis of this very file is worth a warning, launching is never delayed
+    const HashFileAnalysis &analysis = hashFileAnalyzer->result();
+    if (!hashFileAnalyzer->isBusy() && analysis.file == spec.hashFile && analysis.malformed > 0) {
+        QString message = analysis.singleHash
+                              ? tr("The hash does not match the example hash of the selected hash mode.")
+                              : tr("%1 of %2 lines do not match the example hash of the selected hash mode.")
+                                    .arg(QLocale().toString(analysis.malformed), QLocale().toString(analysis.lines));
+        if (!analysis.samples.isEmpty() && !analysis.singleHash) {
+            message += "\n\n" + tr("Line %1: %2").arg(QLocale().toString(analysis.samples.first().first), analysis.samples.first().second);
+        }
+        message += "\n\n" + tr("Start anyway?");
+
+        QMessageBox::StandardButton answer = QMessageBox::question(this, tr("Hash file"), message);
+        if (answer != QMessageBox::Yes) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void MainWindow::addToQueueClicked()
+{
+    QStringList hashFiles;
+    if (!validateHashFile() || !preprocessHashFile(&hashFiles)) {
+        return;
+    }
+
+    rememberHashMode();
+    enqueueHashFiles(hashFiles);
+    jobQueueTriggered();
+}
+
+// One job per hash file, shards of a preprocessed hash file are numbered
+void MainWindow::enqueueHashFiles(const QStringList &hashFiles)
+{
+    const QJsonObject profile = spec.toJson();
+
+    const quint64 keyspace = estimateFromHashcat ? estimatedKeyspace : 0;
+
+    // Every job gets its own session like a direct launch, shards are numbered after the first one
+    const QString session = SessionIndex::newSession();
+
+    QString name = QString("%1 - %2").arg(QFileInfo(spec.hashFile).fileName(), attackModes.value(spec.attackMode));
+    for (int i = 0; i < hashFiles.size(); ++i) {
+        const QString &hashFile = hashFiles.at(i);
+        const QString jobName = hashFiles.size() > 1 ? QString("%1 [%2/%3]").arg(name).arg(i + 1).arg(hashFiles.size()) : name;
+        const QString jobSession = hashFiles.size() > 1 ? QString("%1-%2").arg(session).arg(i + 1) : session;
+        jobQueue->enqueue(jobName, generateArguments(true, hashFile == spec.hashFile ? QString() : hashFile, jobSession),
+                          profile, keyspace);
+    }
+}
+
+// The signature of the selected mode's example hash, invalid for modes that take binary files
+HashSignature MainWindow::currentHashSignature() const
+{
+    const HashMode mode = hashModeCatalog->modes().value(spec.hashMode);
+    return mode.exampleHashFormat == "plain" ? HashSignature::fromExample(mode.exampleHash) : HashSignature();
+}
+
+// Normalize, deduplicate and shard the hash file if enabled. hashFiles receives the files to attack one after
+// another, only the hash file itself if preprocessing is off. Returns false if it failed or was canceled.
+bool MainWindow::preprocessHashFile(QStringList *hashFiles)
+{
+    const QString hashFile = spec.hashFile;
+    hashFiles->clear();
+
+    if (!spec.preprocessHashes || !QFileInfo(hashFile).isFile()) {
+        *hashFiles << hashFile;
+        return true;
+    }
+
+    HashPreprocessOptions options;
+    options.hashFile = hashFile;
+    options.signature = currentHashSignature();
+    options.stripUsername = spec.ignoreUsername;
+    options.potfile = currentPotfile();
+    options.shardSize = static_cast<quint64>(spec.hashesPerRun);
+    options.memoryLimit = static_cast<qint64>(SettingsManager::instance().getKey<int>("mergeMemoryLimit", 1024)) * 1024 * 1024;
+    // Shards of earlier runs stay as long as a job in the queue still refers to them
+    for (int row = 0; row < jobQueue->rowCount(); ++row) {
+        options.inUse << jobQueue->job(row).arguments;
+    }
+
+    QFutureWatcher<HashPreprocessResult> watcher;
+    QProgressDialog dialog(tr("Preprocessing %1...").arg(QFileInfo(hashFile).fileName()), tr("Cancel"), 0, 1000, this);
+    dialog.setWindowModality(Qt::WindowModal);
+    connect(&watcher, &QFutureWatcher<HashPreprocessResult>::progressValueChanged, &dialog, &QProgressDialog::setValue);
+    connect(&watcher, &QFutureWatcher<HashPreprocessResult>::finished, &dialog, &QProgressDialog::reset);
+    connect(&dialog, &QProgressDialog::canceled, &watcher, &QFutureWatcher<HashPreprocessResult>::cancel);
+    watcher.setFuture(QtConcurrent::run(&HashPreprocessor::run, options));
+
+    // Unchanged hash files are reused right away, no need to flash the dialog
+    if (!watcher.isFinished()) {
+        dialog.exec();
+    }
+    watcher.waitForFinished();
+
+    if (watcher.isCanceled() || watcher.future().resultCount() == 0) {
+        return false;
+    }
+
+    const HashPreprocessResult result = watcher.result();
+    if (!result.error.isEmpty()) {
+        QMessageBox::warning(this, tr("Preprocessing"), result.error);
+        return false;
+    }
+
+    *hashFiles = result.files;
+    return true;
+}
+
+void MainWindow::executeClicked()
+{
+    auto &settings = SettingsManager::instance();
+
+    if (!validateHashFile()) {
         return;
     }
 
@@ -559,6 +1318,73 @@ void MainWindow::executeClicked()
         return;
     }
 
+    QStringList hashFiles;
+    if (!preprocessHashFile(&hashFiles)) {
+        return;
+    }
+    rememberHashMode();
+
+    /* Shards of a preprocessed hash file run one after another in the job queue */
+    if (hashFiles.size() > 1) {
+        enqueueHashFiles(hashFiles);
+        jobQueue->setActive(true);
+        jobQueueTriggered();
+        return;
+    }
+    const QString hashFile = hashFiles.first() == spec.hashFile ? QString() : hashFiles.first();
+
+    // Every launch gets its own .restore file, an interrupted run can be continued from its last checkpoint
+    const QString session = SessionIndex::newSession();
+    const quint64 keyspace = estimateFromHashcat ? estimatedKeyspace : 0;
+
+    /* Split the keyspace between one process per device group, always managed */
+    if (spec.sliceKeyspace) {
+        const QStringList groups = KeyspaceSlicer::deviceGroups(spec.devices);
+        if (groups.size() < 2) {
+            QMessageBox::information(this, tr("Keyspace slicing"),
+                                     tr("Enter at least two backend devices to split the keyspace between them."));
+            return;
+        }
+        // Every slice would rewrite the hash file on its own and could bring back hashes another slice cracked
+        if (spec.remove) {
+            QMessageBox::information(this, tr("Keyspace slicing"),
+                                     tr("Removing cracked hashes can't be combined with keyspace slicing, every slice "
+                                        "would rewrite the same hash file. Uncheck one of the two."));
+            return;
+        }
+
+        const QStringList args = generateArguments(true, hashFile, session);
+        const QString outfile = outfileFromArguments(args);
+        followOutfile(outfile);
+
+        SessionIndex::remember(session, keyspace);
+        SessionDialog *sessionDialog = openSessionDialog();
+        const QList<double> weights = sliceWeights(spec.hashMode, groups);
+        sessionDialog->startSliced(args, generateKeyspaceArguments(), groups, weights, spec.cpuAffinity,
+                                   spec.skip.toULongLong(), spec.limit.toULongLong(), outfile);
+        return;
+    }
+
+    const QStringList args = generateArguments(true, hashFile, session);
+    followOutfile(outfileFromArguments(args));
+    SessionIndex::remember(session, keyspace);
+    launch(args);
+}
+
+// Runs hashcat in the session window or in a terminal, depending on the settings
+void MainWindow::launch(const QStringList &hashcatArguments)
+{
+    auto &settings = SettingsManager::instance();
+    QProcess proc;
+    QString terminal;
+    QStringList arguments;
+
+    /* Run as a managed child process and show the live status */
+    if (settings.getKey<bool>("runEmbedded")) {
+        openSessionDialog()->start(hashcatArguments);
+        return;
+    }
+
     if (settings.getKey<QString>("terminal").isEmpty()) {
         QMessageBox msgBox(this);
         QString message = tr("Navigate to <b>%1 → %2</b> to select the terminal used for launching.")
@@ -583,7 +1409,7 @@ void MainWindow::executeClicked()
     arguments << settings.getKey<QString>("hashcatPath");
 
     /* 3. append arguments set in gui elements */
-    arguments << generateArguments();
+    arguments << hashcatArguments;
 
 #if defined(Q_OS_WIN)
     /* Need CREATE_NEW_CONSOLE flag on windows to spawn visible terminal */
@@ -603,154 +1429,357 @@ void MainWindow::executeClicked()
 void MainWindow::commandChanged()
 {
     auto &settings = SettingsManager::instance();
-    QFileInfo fileInfo(settings.getKey<QString>("hashcatPath"));
+    const QString hashcatPath = settings.getKey<QString>("hashcatPath");
+    const bool useShort = settings.getKey<bool>("useShortParameters");
+
+    // Changes that leave the attack as it was, e.g. wordlist statistics, keep the command and the estimate
+    if (commandValid && spec == commandSpec && hashcatPath == commandBinary && useShort == commandShort) {
+        return;
+    }
+    commandSpec = spec;
+    commandBinary = hashcatPath;
+    commandShort = useShort;
+    commandValid = true;
 
     ui->lineEdit_command->clear();
 
     // prepend hashcat binary name if it has already been configured in settings
-    if (!settings.getKey<QString>("hashcatPath").isEmpty()) {
-        ui->lineEdit_command->setText(fileInfo.fileName());
+    if (!hashcatPath.isEmpty()) {
+        ui->lineEdit_command->setText(QFileInfo(hashcatPath).fileName());
     }
 
     // command line arguments for hashcat
     ui->lineEdit_command->insert(" " + generateArguments().join(" "));
     ui->lineEdit_command->setCursorPosition(0);
+
+    updateMaskInfo();
+    updateRulesInfo();
+    updateEstimate();
+    updateMaskFileCost();
+}
+
+// The mask file and password statistics dialogs order and cut masks by their runtime
+void MainWindow::updateMaskFileCost()
+{
+    if (!maskFileDialog && !passwordStatsDialog) {
+        return;
+    }
+
+    QString source;
+    const qint64 speed = expectedSpeed(spec.hashMode, &source);
+    // Generated masks are for brute-force attacks
+    if (passwordStatsDialog) {
+        passwordStatsDialog->setSpeed(speed, source);
+    }
+    if (!maskFileDialog) {
+        return;
+    }
+
+    // Hybrid attacks run every mask candidate once per word, hashcat's keyspace counts the words
+    quint64 multiplier = 1;
+    if (spec.attackMode != AttackSpec::BruteForce) {
+        multiplier = estimateFromHashcat ? estimatedKeyspace : 0;
+    }
+    maskFileDialog->setCost(speed, source, multiplier);
+}
+
+// The mask is checked locally as it is typed, hashcat would only report errors when it is started
+void MainWindow::updateMaskInfo()
+{
+    if (!spec.usesMask() || spec.mask.isEmpty()) {
+        ui->label_mask_info->clear();
+        return;
+    }
+
+    if (MaskParser::isHcmaskFile(spec.mask)) {
+        const ParsedMaskFile file = MaskParser::parseHcmaskFile(spec.mask, spec.hexCharset);
+        if (!file.error.isEmpty()) {
+            ui->label_mask_info->setText(file.error);
+        } else if (file.invalidCount() > 0) {
+            ui->label_mask_info->setText(tr("%n of %1 masks in the file are invalid", nullptr, file.invalidCount()).arg(file.masks.size()));
+        } else {
+            ui->label_mask_info->setText(tr("%n mask(s), keyspace %1", nullptr, file.masks.size()).arg(file.keyspace.toString()));
+        }
+        return;
+    }
+
+    const ParsedMask mask = MaskParser::parse(spec.mask, spec.customCharsetValues(), spec.hexCharset);
+    if (!mask.isValid()) {
+        ui->label_mask_info->setText(mask.errorPosition >= 0 ? tr("Position %1: %2").arg(mask.errorPosition + 1).arg(mask.error) : mask.error);
+    } else if (!mask.keyspace.fitsUInt64()) {
+        ui->label_mask_info->setText(tr("Keyspace %1 is more than hashcat can count").arg(mask.keyspace.toString()));
+    } else {
+        ui->label_mask_info->setText(tr("%n position(s), keyspace %1", nullptr, mask.positions.size()).arg(mask.keyspace.toString()));
+    }
 }
 
-QStringList MainWindow::generateArguments()
+// Every rule of a file is combined with every rule of the other files, the counts are known before hashcat starts
+void MainWindow::updateRulesInfo()
+{
+    const QStringList files = spec.enabledRulesFiles();
+    if (files.isEmpty()) {
+        ui->label_rules_info->clear();
+        return;
+    }
+    if (rulesFileModel->isAnalyzing()) {
+        ui->label_rules_info->setText(tr("Counting rules..."));
+        return;
+    }
+
+    QLocale locale;
+    QStringList counts;
+    quint64 invalid = 0;
+    bool duplicates = false;
+    for (const QString &file : files) {
+        const RuleFileStats stats = rulesFileModel->stats(file);
+        if (!stats.error.isEmpty()) {
+            ui->label_rules_info->setText(stats.error);
+            return;
+        }
+        counts << locale.toString(stats.rules);
+        invalid += stats.invalid;
+        duplicates |= stats.unique() != stats.rules;
+    }
+
+    const Keyspace candidates = rulesFileModel->candidatesPerWord();
+    QString text = files.size() > 1 ? tr("%1 = %2 candidates per word").arg(counts.join(" × "), candidates.toString())
+                                    : tr("%1 candidates per word").arg(candidates.toString());
+    if (duplicates) {
+        text += ", " + tr("%1 without duplicates").arg(rulesFileModel->candidatesPerWord(true).toString());
+    }
+    if (invalid > 0) {
+        text += ". " + tr("%n invalid rule(s) will be skipped.", nullptr, static_cast<int>(invalid));
+    }
+    ui->label_rules_info->setText(text);
+}
+
+// Starts a new keyspace estimate for the current attack, the previous one is dropped
+void MainWindow::updateEstimate()
 {
     auto &settings = SettingsManager::instance();
-    QStringList arguments;
-    QString mask_before_dict = "";
-    QString mask_after_dict = "";
 
-    bool useShort = settings.getKey<bool>("useShortParameters");
-    int attackMode = attackModes.key(ui->comboBox_attack->currentText());
+    estimatedKeyspace = 0;
+    estimatedCandidates = 0;
+    estimateFromHashcat = false;
+    ui->label_estimate->clear();
+    ui->label_estimate->setToolTip(QString());
+
+    if (settings.getKey<QString>("hashcatPath").isEmpty() || hashModeModel->rowCount() == 0) {
+        keyspaceEstimator->clear();
+        return;
+    }
 
-    arguments << HelperUtils::getParameter(HelperUtils::Parameter::HashType, useShort) << QString::number(hashModes.key(ui->comboBox_hash->currentText()));
-    arguments << HelperUtils::getParameter(HelperUtils::Parameter::AttackMode, useShort) << QString::number(attackMode);
+    const quint64 maskCandidates = KeyspaceEstimator::maskCandidates(spec.mask, spec.customCharsetValues(), spec.hexCharset);
 
-    if (ui->checkBox_remove->isChecked()) {
-        arguments << HelperUtils::getParameter(HelperUtils::Parameter::Remove, useShort);
+    // A plain mask is calculated right away, everything else needs hashcat
+    if (spec.attackMode == AttackSpec::BruteForce) {
+        if (maskCandidates == 0) {
+            keyspaceEstimator->clear();
+        } else {
+            keyspaceEstimator->setResult(maskCandidates, maskCandidates);
+        }
+        return;
     }
 
-    if (ui->checkBox_ignoreusername->isChecked()) {
-        arguments << HelperUtils::getParameter(HelperUtils::Parameter::Username, useShort);
+    if (spec.checkedWordlists().isEmpty()) {
+        keyspaceEstimator->clear();
+        return;
     }
 
-    switch (attackMode) {
-    case AttackMode::Straight:
-    case AttackMode::Association:
-        if (ui->radioButton_use_rules_file->isChecked()) {
-            if (ui->checkBox_rulesfile_1->isChecked() && !ui->lineEdit_open_rulesfile_1->text().isEmpty()) {
-                arguments << HelperUtils::getParameter(HelperUtils::Parameter::RulesFile, useShort) << ui->lineEdit_open_rulesfile_1->text();
-            }
-            if (ui->checkBox_rulesfile_2->isChecked() && !ui->lineEdit_open_rulesfile_2->text().isEmpty()) {
-                arguments << HelperUtils::getParameter(HelperUtils::Parameter::RulesFile, useShort) << ui->lineEdit_open_rulesfile_2->text();
-            }
-            if (ui->checkBox_rulesfile_3->isChecked() && !ui->lineEdit_open_rulesfile_3->text().isEmpty()) {
-                arguments << HelperUtils::getParameter(HelperUtils::Parameter::RulesFile, useShort) << ui->lineEdit_open_rulesfile_3->text();
-            }
-        } else if (ui->radioButton_generate_rules->isChecked() && !ui->spinBox_generate_rules->cleanText().isEmpty()) {
-            arguments << HelperUtils::getParameter(HelperUtils::Parameter::GenerateRules, useShort) << ui->spinBox_generate_rules->cleanText();
+    // The rules are counted in the background, the estimate follows once they are known
+    if (rulesFileModel->isAnalyzing()) {
+        keyspaceEstimator->clear();
+        ui->label_estimate->setText(tr("Estimating..."));
+        return;
+    }
+
+    // hashcat reports the keyspace without the amplifier, rules and masks multiply it
+    quint64 multiplier = 1;
+
+    switch (spec.attackMode) {
+    case AttackSpec::Straight:
+    case AttackSpec::Association:
+        if (spec.generateRules) {
+            multiplier = spec.generatedRules;
         }
         break;
-    case AttackMode::Combination:
+    case AttackSpec::HybridWordMask:
+    case AttackSpec::HybridMaskWord:
+        multiplier = maskCandidates;
         break;
-    case AttackMode::BruteForce:
-        mask_before_dict = ui->lineEdit_mask->text();
-        break;
-    case AttackMode::HybridWordMask:
-        if (!ui->lineEdit_mask->text().isEmpty()) {
-            mask_after_dict = ui->lineEdit_mask->text();
-        }
-        break;
-    case AttackMode::HybridMaskWord:
-        if (!ui->lineEdit_mask->text().isEmpty()) {
-            mask_before_dict = ui->lineEdit_mask->text();
-        }
+    case AttackSpec::Combination:
+        // Would require counting the right wordlist
+        multiplier = 0;
         break;
     }
 
-    if (ui->checkBox_speed_only->isChecked()) {
-        arguments << HelperUtils::getParameter(HelperUtils::Parameter::SpeedOnly, useShort);
+    // hashcat skips invalid rules, the model doesn't count them either
+    const quint64 rules = rulesFileModel->candidatesPerWord().toUInt64();
+    multiplier = rules != 0 && multiplier > std::numeric_limits<quint64>::max() / rules ? std::numeric_limits<quint64>::max()
+                                                                                         : multiplier * rules;
+
+    estimateFromHashcat = true;
+    ui->label_estimate->setText(tr("Estimating..."));
+    keyspaceEstimator->request(generateKeyspaceArguments(), multiplier);
+}
+
+void MainWindow::showEstimate()
+{
+    quint64 candidates = estimatedCandidates;
+
+    // Skip and limit count in keyspace units
+    if (estimateFromHashcat && estimatedKeyspace > 0 && candidates > 0) {
+        const quint64 skip = qMin(spec.skip.toULongLong(), estimatedKeyspace);
+        quint64 range = estimatedKeyspace - skip;
+        const quint64 limit = spec.limit.toULongLong();
+        if (limit > 0) {
+            range = qMin(range, limit);
+        }
+        candidates = static_cast<quint64>(static_cast<long double>(candidates) * range / estimatedKeyspace);
     }
 
-    if (ui->checkBox_override_workload_profile->isChecked()) {
-        arguments << HelperUtils::getParameter(HelperUtils::Parameter::WorkloadProfile, useShort) << ui->comboBox_workload_profile->currentText();
+    QString source;
+    const qint64 speed = expectedSpeed(spec.hashMode, &source);
+    QString runtime;
+
+    if (candidates == 0 || speed <= 0) {
+        runtime = tr("runtime unknown");
+    } else {
+        const long double seconds = static_cast<long double>(candidates) / speed;
+        // Anything above a century is not worth a precise number
+        runtime = seconds > 100.0L * 365 * 86400 ? tr("more than 100 years")
+                                                  : tr("about %1").arg(HelperUtils::formatDuration(static_cast<qint64>(seconds)));
     }
 
-    if (ui->checkBox_optimized_kernel->isChecked()) {
-        arguments << HelperUtils::getParameter(HelperUtils::Parameter::OptimizedKernel, useShort);
+    QLocale locale;
+    ui->label_estimate->setText(tr("Keyspace: %1, %2").arg(locale.toString(estimatedKeyspace), runtime));
+
+    if (speed > 0) {
+        ui->label_estimate->setToolTip(tr("%1 candidates at %2 (%3)").arg(locale.toString(candidates), HelperUtils::formatSpeed(speed), source));
+    } else {
+        ui->label_estimate->setToolTip(tr("No speed measured for this hash mode yet, run a benchmark from %1 → %2")
+                                           .arg(ui->menuTools->menuAction()->text(), ui->actionBenchmarks->text()));
     }
 
-    if (ui->groupBox_custom_charset->isEnabled()) {
-        if (ui->checkBox_custom_charset1->isChecked() && !ui->lineEdit_custom_charset1->text().isEmpty()) {
-            arguments << HelperUtils::getParameter(HelperUtils::Parameter::CustomCharset1, useShort) << ui->lineEdit_custom_charset1->text();
-        }
-        if (ui->checkBox_custom_charset2->isChecked() && !ui->lineEdit_custom_charset2->text().isEmpty()) {
-            arguments << HelperUtils::getParameter(HelperUtils::Parameter::CustomCharset2, useShort) << ui->lineEdit_custom_charset2->text();
-        }
-        if (ui->checkBox_custom_charset3->isChecked() && !ui->lineEdit_custom_charset3->text().isEmpty()) {
-            arguments << HelperUtils::getParameter(HelperUtils::Parameter::CustomCharset3, useShort) << ui->lineEdit_custom_charset3->text();
-        }
-        if (ui->checkBox_custom_charset4->isChecked() && !ui->lineEdit_custom_charset4->text().isEmpty()) {
-            arguments << HelperUtils::getParameter(HelperUtils::Parameter::CustomCharset4, useShort) << ui->lineEdit_custom_charset4->text();
+    updateMaskFileCost();
+}
+
+// Speed of the selected devices, a session of this hash mode beats a benchmark
+qint64 MainWindow::expectedSpeed(quint32 hashMode, QString *source) const
+{
+    if (measuredSpeeds.contains(hashMode)) {
+        if (source) {
+            *source = tr("last session");
         }
+        return measuredSpeeds.value(hashMode);
     }
 
-    if (ui->checkBox_hex_hash->isChecked()) {
-        arguments << HelperUtils::getParameter(HelperUtils::Parameter::HexCharset, useShort);
+    if (source) {
+        *source = tr("benchmark");
     }
 
-    if (ui->checkBox_hex_salt->isChecked()) {
-        arguments << HelperUtils::getParameter(HelperUtils::Parameter::HexSalt, useShort);
+    const QStringList devices = spec.devices.split(QRegularExpression("[,;]"), Qt::SkipEmptyParts);
+    if (devices.isEmpty() || spec.devices == "0") {
+        return benchmarkCache->speed(hashMode);
     }
 
-    if (ui->checkBox_outfile->isChecked() && !ui->lineEdit_outfile->text().isEmpty()) {
-        QFileInfo hash_fi(ui->lineEdit_hashfile->text());
-        QString outfile = ui->lineEdit_outfile->text();
-        outfile.replace("<unixtime>", QString::number(QDateTime::currentMSecsSinceEpoch() / 1000));
-        outfile.replace("<hash>", hash_fi.fileName(), Qt::CaseInsensitive);
-        arguments << HelperUtils::getParameter(HelperUtils::Parameter::Outfile, useShort) << outfile;
+    qint64 speed = 0;
+    for (const QString &device : devices) {
+        speed += benchmarkCache->speed(hashMode, device.trimmed().toInt());
     }
+    return speed;
+}
 
-    if (ui->lineEdit_outfile_format->text() != "1,2") {
-        arguments << HelperUtils::getParameter(HelperUtils::Parameter::OutfileFormat, useShort) << ui->lineEdit_outfile_format->text();
-    }
+// Benchmark speed of every device group, empty if any of them is unknown
+QList<double> MainWindow::sliceWeights(quint32 hashMode, const QStringList &deviceGroups) const
+{
+    QList<double> weights;
 
-    if (!ui->lineEdit_cpu_affinity->text().isEmpty()) {
-        arguments << HelperUtils::getParameter(HelperUtils::Parameter::CpuAffinity, useShort) << ui->lineEdit_cpu_affinity->text();
+    for (const QString &group : deviceGroups) {
+        qint64 speed = 0;
+        const QStringList devices = group.split(',', Qt::SkipEmptyParts);
+        for (const QString &device : devices) {
+            speed += benchmarkCache->speed(hashMode, device.trimmed().toInt());
+        }
+
+        if (speed <= 0) {
+            return {};
+        }
+        weights << static_cast<double>(speed);
     }
 
-    if (!ui->lineEdit_devices->text().isEmpty() && ui->lineEdit_devices->text() != "0") {
-        arguments << HelperUtils::getParameter(HelperUtils::Parameter::BackendDevices, useShort) << ui->lineEdit_devices->text();
+    return weights;
+}
+
+// The restore writes to the outfile of the interrupted command line, relative to the directory it ran in
+void MainWindow::restoreSession(const RestoreSession &session)
+{
+    const QString outfile = HelperUtils::parameterValue(session.arguments, HelperUtils::Parameter::Outfile);
+    if (!outfile.isEmpty()) {
+        followOutfile(session.workingDirectory.isEmpty() ? outfile : QDir(session.workingDirectory).absoluteFilePath(outfile));
     }
 
-    if (!ui->spinBox_segment->cleanText().isEmpty() && ui->spinBox_segment->cleanText() != "32") {
-        arguments << HelperUtils::getParameter(HelperUtils::Parameter::SegmentSize, useShort) << ui->spinBox_segment->cleanText();
+    launch(SessionIndex::restoreArguments(session));
+}
+
+// The path passed as --outfile, <unixtime> and <hash> are already replaced
+QString MainWindow::outfileFromArguments(const QStringList &arguments) const
+{
+    int index = arguments.indexOf(HelperUtils::getParameter(HelperUtils::Parameter::Outfile, true));
+    if (index < 0) {
+        index = arguments.indexOf(HelperUtils::getParameter(HelperUtils::Parameter::Outfile, false));
     }
+    return index >= 0 ? arguments.value(index + 1) : QString();
+}
 
-    if (!ui->lineEdit_hashfile->text().isEmpty()) {
-        arguments << ui->lineEdit_hashfile->text();
+// An open results window switches to the outfile of the attack that was just launched
+void MainWindow::followOutfile(const QString &outfile)
+{
+    if (outfile.isEmpty()) {
+        return;
     }
 
-    if (!mask_before_dict.isEmpty()) {
-        arguments << mask_before_dict;
+    // hashcat runs in its own directory, a relative outfile ends up there
+    const QDir hashcatDir = QFileInfo(SettingsManager::instance().getKey<QString>("hashcatPath")).absoluteDir();
+    followedOutfile = hashcatDir.absoluteFilePath(outfile);
+
+    if (resultsDialog) {
+        resultsDialog->setOutfile(followedOutfile, spec.outfileFormat);
     }
+}
 
-    if (ui->groupBox_wordlists->isEnabled()) {
-        auto const wordlists = ui->listWidget_wordlist->findItems(QString("*"), Qt::MatchWildcard);
-        for (QListWidgetItem *item : wordlists) {
-            if (item->checkState() == Qt::Checked) {
-                arguments << item->text();
-            }
+SessionDialog *MainWindow::openSessionDialog()
+{
+    SessionDialog *session = new SessionDialog(this);
+    session->setAttribute(Qt::WA_DeleteOnClose);
+
+    // Remember the speed of the hash mode the session was started with
+    const quint32 hashMode = spec.hashMode;
+    connect(session, &SessionDialog::speedMeasured, this, [this, hashMode](qint64 speed) {
+        measuredSpeeds.insert(hashMode, speed);
+        if (hashMode == spec.hashMode && estimatedKeyspace > 0) {
+            showEstimate();
         }
-    }
+    });
 
-    if (!mask_after_dict.isEmpty()) {
-        arguments << mask_after_dict;
-    }
+    session->show();
+    return session;
+}
+
+QStringList MainWindow::generateArguments(bool withHashFile, const QString &preprocessedHashFile, const QString &session) const
+{
+    AttackSpec::ArgumentOptions options;
+    options.useShortParameters = SettingsManager::instance().getKey<bool>("useShortParameters");
+    options.withHashFile = withHashFile;
+    options.preprocessedHashFile = preprocessedHashFile;
+    options.unixTime = QDateTime::currentSecsSinceEpoch();
+    options.session = session;
+
+    return spec.arguments(options);
+}
 
-    return arguments;
+// Arguments for "hashcat --keyspace", which takes no hash file and ignores output and device options
+QStringList MainWindow::generateKeyspaceArguments() const
+{
+    return spec.keyspaceArguments(SettingsManager::instance().getKey<bool>("useShortParameters"));
 }
@@ -7,14 +7,40 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include <QListWidgetItem>
 #include <QComboBox>
+#include <QHash>
 #include <QProcess>
+#include <QPointer>
+#include "attackspec.h"
 
 namespace Ui {
     class MainWindow;
 }
 
+class BenchmarkCache;
+class BenchmarkDialog;
+class QFileSystemWatcher;
+class QJsonObject;
+class QLineEdit;
+class HashFileAnalyzer;
+class HashSignature;
+struct HashFileAnalysis;
+class HashModeCatalog;
+class HashModeFilterModel;
+class HashModeModel;
+class JobQueue;
+class JobQueueDialog;
+class KeyspaceEstimator;
+class MaskFileDialog;
+class PasswordStatsDialog;
+class RestoreDialog;
+struct RestoreSession;
+class ResultsDialog;
+class RulesFileModel;
+class WordlistMergeDialog;
+class WordlistModel;
+class SessionDialog;
+
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
@@ -32,22 +58,35 @@ private slots:
     void resetFieldsTriggered();
     void aboutQtTriggered();
     void aboutTriggered();
+    void jobQueueTriggered();
+    void benchmarksTriggered();
+    void mergeWordlistsTriggered();
+    void maskFileTriggered();
+    void passwordStatsTriggered();
+    void resultsTriggered();
+    void restoreSessionsTriggered();
+    void viewFileTriggered();
 
     // main‑tab buttons
     void executeClicked();
+    void addToQueueClicked();
     void openHashFileClicked();
     void outputClicked();
     void removeWordlistClicked();
     void addWordlistClicked();
+    void addWordlistFolderClicked();
     void wordlistSortAscClicked();
     void wordlistSortDescClicked();
-    void wordlistItemClicked(QListWidgetItem *item);
+    void wordlistSelectionChanged();
+    void addRulesFileClicked();
+    void removeRulesFileClicked();
+    void rulesFileUpClicked();
+    void rulesFileDownClicked();
+    void rulesFileSelectionChanged();
+    void optimizeRulesFileClicked();
 
     // checkboxes / radio buttons
     void outfileToggled(bool checked);
-    void rulesfile1Toggled(bool checked);
-    void rulesfile2Toggled(bool checked);
-    void rulesfile3Toggled(bool checked);
     void generateRulesToggled(bool checked);
     void useRulesFileToggled(bool checked);
     void customCharset1Toggled(bool checked);
@@ -58,11 +97,6 @@ private slots:
     // line edits
     void hashFileTextChanged(const QString &text);
 
-    // rule‑file buttons
-    void openRulesFile1Clicked();
-    void openRulesFile2Clicked();
-    void openRulesFile3Clicked();
-
     // combobox
     void attackIndexChanged(int index);
 
@@ -72,13 +106,79 @@ private slots:
 private:
     Ui::MainWindow *ui;
 
-    QMap<quint32, QString> hashModes;
+    // The attack as entered, widgets write their field as they change
+    AttackSpec spec;
+    // What the command line was last generated from
+    AttackSpec commandSpec;
+    QString commandBinary;
+    bool commandShort = false;
+    bool commandValid = false;
+    // Position in the hash mode list stored by old profiles, applied once the catalog is loaded
+    int legacyHashIndex = -1;
+
     QMap<quint32, QString> attackModes;
+    HashModeCatalog *hashModeCatalog;
+    HashModeModel *hashModeModel;
+    HashModeFilterModel *hashModeFilter;
+    JobQueue *jobQueue;
+    QPointer<JobQueueDialog> jobQueueDialog;
+    KeyspaceEstimator *keyspaceEstimator;
+    HashFileAnalyzer *hashFileAnalyzer;
+    QFileSystemWatcher *potfileWatcher;
+    BenchmarkCache *benchmarkCache;
+    QPointer<BenchmarkDialog> benchmarkDialog;
+    WordlistModel *wordlistModel;
+    QPointer<WordlistMergeDialog> wordlistMergeDialog;
+    RulesFileModel *rulesFileModel;
+    QPointer<MaskFileDialog> maskFileDialog;
+    QPointer<PasswordStatsDialog> passwordStatsDialog;
+    QPointer<ResultsDialog> resultsDialog;
+    QPointer<RestoreDialog> restoreDialog;
+    // Outfile of the last attack launched from the main window, the results window follows it
+    QString followedOutfile;
+
+    // Last estimate of the current attack
+    quint64 estimatedKeyspace = 0;
+    quint64 estimatedCandidates = 0;
+    bool estimateFromHashcat = false;
+    // Speed seen in sessions, per hash mode
+    QHash<quint32, qint64> measuredSpeeds;
 
     void initHashAndAttackModes();
+    void rememberHashMode();
+    void populateHashModes();
     void updateViewAttackMode();
-
-    QStringList generateArguments();
+    void bindSpec();
+    void applySpec(const AttackSpec &newSpec);
+    void loadProfile(const QJsonObject &profile);
+
+    // preprocessedHashFile replaces the hash file, it has no usernames left
+    QStringList generateArguments(bool withHashFile = true, const QString &preprocessedHashFile = QString(),
+                                  const QString &session = QString()) const;
+    QStringList generateKeyspaceArguments() const;
+    void updateEstimate();
+    void showEstimate();
+    void updateMaskInfo();
+    void updateRulesInfo();
+    void updateMaskFileCost();
+    qint64 expectedSpeed(quint32 hashMode, QString *source = nullptr) const;
+    QList<double> sliceWeights(quint32 hashMode, const QStringList &deviceGroups) const;
+    SessionDialog *openSessionDialog();
+    void launch(const QStringList &hashcatArguments);
+    void restoreSession(const RestoreSession &session);
+    void checkInterruptedSessions();
+    QString outfileFromArguments(const QStringList &arguments) const;
+    void followOutfile(const QString &outfile);
+    void viewFile(const QString &file);
+    void addViewFileMenu(QLineEdit *lineEdit);
+    bool validateHashFile();
+    void updateHashFileAnalysis();
+    QString currentPotfile() const;
+    void watchPotfile();
+    HashSignature currentHashSignature() const;
+    bool preprocessHashFile(QStringList *hashFiles);
+    void enqueueHashFiles(const QStringList &hashFiles);
+    void showHashFileAnalysis(const HashFileAnalysis &analysis);
 
     void addWordlistItem(QStringList &);
     void setOutfilePath();
@@ -86,17 +186,6 @@ private:
     QString defaultProfileFile() const;
     void loadDefaultProfile();
     void saveDefaultProfile();
-
-    // Supported attack modes
-    enum AttackMode
-    {
-        Straight       = 0,
-        Combination    = 1,
-        BruteForce     = 3,
-        HybridWordMask = 6,
-        HybridMaskWord = 7,
-        Association    = 9
-    };
 };
 
 #endif // MAINWINDOW_H
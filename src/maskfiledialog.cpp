@@ -0,0 +1,285 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "maskfiledialog.h"
+#include "ui_maskfiledialog.h"
+#include "attackspec.h"
+#include "helperutils.h"
+#include "maskparser.h"
+#include <QDir>
+#include <QFile>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QMessageBox>
+#include <QSaveFile>
+#include <QTextBlock>
+#include <QtConcurrent>
+#include <algorithm>
+
+MaskFileDialog::MaskFileDialog(const AttackSpec *spec, QWidget *parent)
+    : QDialog(parent)
+    , ui(new Ui::MaskFileDialog)
+    , spec(spec)
+{
+    ui->setupUi(this);
+
+    // Files from statsgen have thousands of lines, they are checked once typing pauses
+    validateTimer.setSingleShot(true);
+    validateTimer.setInterval(200);
+    connect(&validateTimer, &QTimer::timeout, this, &MaskFileDialog::validate);
+    connect(ui->plainTextEdit_masks, &QPlainTextEdit::textChanged, &validateTimer, qOverload<>(&QTimer::start));
+
+    connect(ui->pushButton_add_mask, &QPushButton::clicked, this, &MaskFileDialog::addMaskClicked);
+    connect(ui->pushButton_add_increments, &QPushButton::clicked, this, &MaskFileDialog::addIncrementsClicked);
+    connect(ui->pushButton_open, &QPushButton::clicked, this, &MaskFileDialog::openClicked);
+    connect(ui->pushButton_save, &QPushButton::clicked, this, &MaskFileDialog::saveClicked);
+    connect(ui->pushButton_use, &QPushButton::clicked, this, &MaskFileDialog::useClicked);
+    connect(ui->pushButton_close, &QPushButton::clicked, this, &MaskFileDialog::close);
+    connect(ui->pushButton_optimize, &QPushButton::clicked, this, &MaskFileDialog::optimizeClicked);
+    connect(&optimizeWatcher, &QFutureWatcher<Schedule>::finished, this, &MaskFileDialog::optimizeFinished);
+
+    validate();
+}
+
+MaskFileDialog::~MaskFileDialog()
+{
+    optimizeWatcher.waitForFinished();
+    delete ui;
+}
+
+void MaskFileDialog::setCost(qint64 speed, const QString &source, quint64 multiplier)
+{
+    if (this->speed == speed && speedSource == source && this->multiplier == multiplier) {
+        return;
+    }
+
+    this->speed = speed;
+    speedSource = source;
+    this->multiplier = multiplier;
+    validateTimer.start();
+}
+
+void MaskFileDialog::setPotfile(const QString &potfile)
+{
+    this->potfile = potfile;
+    ui->checkBox_history->setEnabled(!potfile.isEmpty());
+}
+
+bool MaskFileDialog::openFile(const QString &file)
+{
+    QFile f(file);
+    if (!f.open(QIODevice::ReadOnly)) {
+        QMessageBox::warning(this, tr("Mask file"), tr("Could not open %1.").arg(file));
+        return false;
+    }
+
+    ui->plainTextEdit_masks->setPlainText(QString::fromUtf8(f.readAll()));
+    this->file = file;
+    setWindowTitle(tr("Mask file - %1").arg(QFileInfo(file).fileName()));
+    validate();
+    return true;
+}
+
+void MaskFileDialog::setMasks(const QString &text)
+{
+    ui->plainTextEdit_masks->setPlainText(text);
+    file.clear();
+    setWindowTitle(tr("Mask file"));
+    validate();
+}
+
+void MaskFileDialog::addMaskClicked()
+{
+    if (spec->mask.isEmpty() || MaskParser::isHcmaskFile(spec->mask)) {
+        QMessageBox::information(this, tr("Mask file"), tr("Enter a mask in the main window first."));
+        return;
+    }
+    appendLine(spec->customCharsetValues(), spec->mask);
+}
+
+void MaskFileDialog::addIncrementsClicked()
+{
+    const ParsedMask parsed = MaskParser::parse(spec->mask, spec->customCharsetValues(), spec->hexCharset);
+    if (MaskParser::isHcmaskFile(spec->mask) || !parsed.isValid()) {
+        QMessageBox::information(this, tr("Mask file"), tr("Enter a valid mask in the main window first."));
+        return;
+    }
+
+    QString prefix;
+    for (int i = 0; i < parsed.tokens.size(); ++i) {
+        prefix += parsed.tokens.at(i);
+        // The other bytes of a multi-byte character have no token of their own
+        if (i + 1 < parsed.tokens.size() && parsed.tokens.at(i + 1).isEmpty()) {
+            continue;
+        }
+        appendLine(spec->customCharsetValues(), prefix);
+    }
+}
+
+void MaskFileDialog::openClicked()
+{
+    const QString file = QFileDialog::getOpenFileName(this, tr("Open mask file"), this->file, tr("hashcat masks (*.hcmask);;All files (*)"));
+    if (!file.isEmpty()) {
+        openFile(file);
+    }
+}
+
+void MaskFileDialog::saveClicked()
+{
+    const QString target = chooseFile();
+    if (!target.isEmpty()) {
+        save(target);
+    }
+}
+
+void MaskFileDialog::useClicked()
+{
+    const QString target = file.isEmpty() ? chooseFile() : file;
+    if (target.isEmpty() || !save(target)) {
+        return;
+    }
+    emit maskFileChosen(QDir::toNativeSeparators(target));
+}
+
+void MaskFileDialog::optimizeClicked()
+{
+    const ParsedMaskFile parsed = MaskParser::parseHcmask(ui->plainTextEdit_masks->toPlainText(), spec->hexCharset);
+    if (parsed.masks.isEmpty()) {
+        return;
+    }
+    if (parsed.invalidCount() > 0) {
+        QMessageBox::information(this, tr("Mask file"), tr("Fix the invalid masks first, they can't be ordered."));
+        return;
+    }
+
+    MaskCost cost;
+    cost.speed = speed;
+    cost.multiplier = multiplier;
+    cost.budgetSeconds = ui->spinBox_budget->value() * 60;
+
+    // The mask is matched against the part of a password it would have produced
+    MaskAnchor anchor = MaskAnchor::Whole;
+    if (spec->attackMode == AttackSpec::HybridWordMask) {
+        anchor = MaskAnchor::Suffix;
+    } else if (spec->attackMode == AttackSpec::HybridMaskWord) {
+        anchor = MaskAnchor::Prefix;
+    }
+    const QString history = ui->checkBox_history->isChecked() ? potfile : QString();
+
+    ui->pushButton_optimize->setEnabled(false);
+    optimizeWatcher.setFuture(QtConcurrent::run([parsed, cost, anchor, history] {
+        Schedule schedule;
+        const MaskHistory maskHistory(history.isEmpty() ? QList<QByteArray>() : MaskHistory::readPotfile(history), anchor);
+        schedule.masks = MaskScheduler::schedule(parsed, cost, maskHistory);
+        schedule.history = maskHistory.size();
+        return schedule;
+    }));
+}
+
+void MaskFileDialog::optimizeFinished()
+{
+    ui->pushButton_optimize->setEnabled(true);
+
+    const Schedule schedule = optimizeWatcher.result();
+    ui->plainTextEdit_masks->setPlainText(MaskScheduler::toHcmask(schedule.masks));
+    validate();
+
+    const int cut = std::count_if(schedule.masks.begin(), schedule.masks.end(), [](const ScheduledMask &mask) { return mask.isCut(); });
+    QString text = schedule.history > 0 ? tr("Ordered by the hit rates of %n cracked password(s).", nullptr, schedule.history)
+                                        : tr("No cracked passwords to learn from, the smallest masks run first.");
+    if (cut > 0) {
+        text += " " + tr("%n mask(s) over the time budget are commented out.", nullptr, cut);
+    }
+    if (speed <= 0 || multiplier == 0) {
+        text += " " + tr("The runtime is unknown, run a benchmark for the time budget.");
+    }
+    ui->label_summary->setText(ui->label_summary->text() + "\n" + text);
+}
+
+void MaskFileDialog::validate()
+{
+    validateTimer.stop();
+
+    const ParsedMaskFile parsed = MaskParser::parseHcmask(ui->plainTextEdit_masks->toPlainText(), spec->hexCharset);
+
+    // Invalid lines are highlighted, the first few errors are listed below
+    QList<QTextEdit::ExtraSelection> selections;
+    QStringList errors;
+    QTextDocument *document = ui->plainTextEdit_masks->document();
+    for (int i = 0; i < parsed.masks.size(); ++i) {
+        const ParsedMask &mask = parsed.masks.at(i);
+        if (mask.isValid()) {
+            continue;
+        }
+
+        QTextEdit::ExtraSelection selection;
+        selection.cursor = QTextCursor(document->findBlockByNumber(parsed.lineNumbers.at(i) - 1));
+        selection.format.setBackground(QColor(255, 0, 0, 48));
+        selection.format.setProperty(QTextFormat::FullWidthSelection, true);
+        selections << selection;
+
+        if (errors.size() < 5) {
+            errors << tr("Line %1: %2").arg(parsed.lineNumbers.at(i)).arg(mask.error);
+        }
+    }
+    ui->plainTextEdit_masks->setExtraSelections(selections);
+
+    if (parsed.masks.isEmpty()) {
+        ui->label_summary->clear();
+        return;
+    }
+
+    QString summary = tr("%n mask(s), keyspace %1", nullptr, parsed.masks.size()).arg(parsed.keyspace.toString());
+    if (!parsed.keyspace.fitsUInt64()) {
+        summary += tr(", more than hashcat can count");
+    } else if (speed > 0 && multiplier > 0) {
+        const double seconds = parsed.keyspace.toDouble() * multiplier / speed;
+        // Anything above a century is not worth a precise number
+        const QString runtime = seconds > 100.0 * 365 * 86400 ? tr("more than 100 years")
+                                                              : HelperUtils::formatDuration(static_cast<qint64>(seconds));
+        summary += tr(", about %1 at %2 (%3)").arg(runtime, HelperUtils::formatSpeed(speed), speedSource);
+    }
+    const int invalid = parsed.invalidCount();
+    if (invalid > 0) {
+        summary += "\n" + tr("%n invalid mask(s) are not counted:", nullptr, invalid) + "\n" + errors.join('\n');
+    }
+    ui->label_summary->setText(summary);
+}
+
+bool MaskFileDialog::save(const QString &target)
+{
+    validate();
+
+    QSaveFile f(target);
+    QByteArray data = ui->plainTextEdit_masks->toPlainText().toUtf8();
+    if (!data.endsWith('\n')) {
+        data += '\n';
+    }
+    if (!f.open(QIODevice::WriteOnly) || f.write(data) != data.size() || !f.commit()) {
+        QMessageBox::warning(this, tr("Mask file"), tr("Could not write %1.").arg(target));
+        return false;
+    }
+
+    file = target;
+    setWindowTitle(tr("Mask file - %1").arg(QFileInfo(file).fileName()));
+    return true;
+}
+
+QString MaskFileDialog::chooseFile()
+{
+    QString target = QFileDialog::getSaveFileName(this, tr("Save mask file"), file, tr("hashcat masks (*.hcmask);;All files (*)"));
+    if (!target.isEmpty() && QFileInfo(target).suffix().isEmpty()) {
+        target += ".hcmask";
+    }
+    return target;
+}
+
+void MaskFileDialog::appendLine(const QStringList &customCharsets, const QString &mask)
+{
+    HcmaskLine line;
+    line.customCharsets = customCharsets;
+    line.mask = mask;
+    ui->plainTextEdit_masks->appendPlainText(MaskParser::hcmaskLine(line));
+}
@@ -0,0 +1,75 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef MASKFILEDIALOG_H
+#define MASKFILEDIALOG_H
+
+#include <QDialog>
+#include <QFutureWatcher>
+#include <QTimer>
+#include "maskscheduler.h"
+
+namespace Ui {
+    class MaskFileDialog;
+}
+
+struct AttackSpec;
+
+// Builds and checks .hcmask files, every line is parsed locally as it is typed
+class MaskFileDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    // The current mask and charsets are read from spec, which has to outlive the dialog
+    explicit MaskFileDialog(const AttackSpec *spec, QWidget *parent = nullptr);
+    ~MaskFileDialog();
+
+    bool openFile(const QString &file);
+    // Masks without a file, e.g. generated ones, they are saved under a new name when used
+    void setMasks(const QString &text);
+
+    // Speed of the hash mode and the words of a hybrid attack, for runtimes and the time budget
+    void setCost(qint64 speed, const QString &source, quint64 multiplier);
+    // Cracked passwords the order is learned from
+    void setPotfile(const QString &potfile);
+
+signals:
+    // Emitted after the masks were saved to be used by the attack
+    void maskFileChosen(const QString &file);
+
+private slots:
+    void addMaskClicked();
+    void addIncrementsClicked();
+    void openClicked();
+    void saveClicked();
+    void useClicked();
+    void optimizeClicked();
+    void optimizeFinished();
+    void validate();
+
+private:
+    Ui::MaskFileDialog *ui;
+    const AttackSpec *spec;
+    QString file;
+    QTimer validateTimer;
+
+    struct Schedule {
+        QList<ScheduledMask> masks;
+        int history = 0;
+    };
+
+    qint64 speed = 0;
+    QString speedSource;
+    quint64 multiplier = 1;
+    QString potfile;
+    QFutureWatcher<Schedule> optimizeWatcher;
+
+    bool save(const QString &target);
+    QString chooseFile();
+    void appendLine(const QStringList &customCharsets, const QString &mask);
+};
+
+#endif // MASKFILEDIALOG_H
@@ -0,0 +1,459 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "maskparser.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QLocale>
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+// hashcat does not crack passwords longer than this
+constexpr int maxPositions = 256;
+constexpr int maxCustomCharsets = 4;
+
+QString tr(const char *text)
+{
+    return QCoreApplication::translate("MaskParser", text);
+}
+
+int hexValue(QChar c)
+{
+    if (c >= '0' && c <= '9') {
+        return c.unicode() - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c.unicode() - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c.unicode() - 'A' + 10;
+    }
+    return -1;
+}
+
+// Decodes the two hex digits at pos, -1 if they are not
+int hexByte(const QString &text, int pos)
+{
+    if (pos + 1 >= text.size()) {
+        return -1;
+    }
+    const int high = hexValue(text.at(pos));
+    const int low = hexValue(text.at(pos + 1));
+    return high < 0 || low < 0 ? -1 : high << 4 | low;
+}
+
+// A literal is one position per UTF-8 byte, surrogate pairs are kept together
+QByteArray literalBytes(const QString &text, int pos, int *length)
+{
+    *length = text.at(pos).isHighSurrogate() && pos + 1 < text.size() ? 2 : 1;
+    return text.mid(pos, *length).toUtf8();
+}
+
+} // namespace
+
+/* ---------- Keyspace ---------- */
+
+Keyspace::Keyspace(quint64 value)
+{
+    limbs[0] = static_cast<quint32>(value);
+    limbs[1] = static_cast<quint32>(value >> 32);
+}
+
+void Keyspace::multiply(quint32 factor)
+{
+    quint64 carry = 0;
+    for (quint32 &limb : limbs) {
+        const quint64 product = quint64(limb) * factor + carry;
+        limb = static_cast<quint32>(product);
+        carry = product >> 32;
+    }
+    overflow = overflow || carry != 0;
+}
+
+void Keyspace::add(const Keyspace &other)
+{
+    quint64 carry = 0;
+    for (size_t i = 0; i < limbs.size(); ++i) {
+        const quint64 sum = quint64(limbs[i]) + other.limbs[i] + carry;
+        limbs[i] = static_cast<quint32>(sum);
+        carry = sum >> 32;
+    }
+    overflow = overflow || other.overflow || carry != 0;
+}
+
+bool Keyspace::isZero() const
+{
+    return !overflow && limbs == std::array<quint32, 4> {};
+}
+
+bool Keyspace::overflowed() const
+{
+    return overflow;
+}
+
+bool Keyspace::fitsUInt64() const
+{
+    return !overflow && limbs[2] == 0 && limbs[3] == 0;
+}
+
+quint64 Keyspace::toUInt64() const
+{
+    if (!fitsUInt64()) {
+        return std::numeric_limits<quint64>::max();
+    }
+    return quint64(limbs[1]) << 32 | limbs[0];
+}
+
+double Keyspace::toDouble() const
+{
+    if (overflow) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    double value = 0;
+    for (int i = int(limbs.size()) - 1; i >= 0; --i) {
+        value = value * 4294967296.0 + limbs[i];
+    }
+    return value;
+}
+
+QString Keyspace::toString(bool grouped) const
+{
+    if (overflow) {
+        return tr("more than 2^128");
+    }
+    if (fitsUInt64()) {
+        return grouped ? QLocale().toString(toUInt64()) : QString::number(toUInt64());
+    }
+
+    // Long division by 10^9, nine digits at a time
+    std::array<quint32, 4> rest = limbs;
+    QStringList chunks;
+    while (rest != std::array<quint32, 4> {}) {
+        quint64 remainder = 0;
+        for (int i = int(rest.size()) - 1; i >= 0; --i) {
+            const quint64 current = remainder << 32 | rest[i];
+            rest[i] = static_cast<quint32>(current / 1000000000);
+            remainder = current % 1000000000;
+        }
+        chunks.prepend(QString::number(remainder));
+    }
+
+    QString digits = chunks.takeFirst();
+    for (const QString &chunk : std::as_const(chunks)) {
+        digits += chunk.rightJustified(9, '0');
+    }
+
+    if (grouped) {
+        const QString separator = QLocale().groupSeparator();
+        for (int i = digits.size() - 3; i > 0; i -= 3) {
+            digits.insert(i, separator);
+        }
+    }
+    return digits;
+}
+
+/* ---------- ParsedMaskFile ---------- */
+
+int ParsedMaskFile::invalidCount() const
+{
+    return std::count_if(masks.begin(), masks.end(), [](const ParsedMask &mask) { return !mask.isValid(); });
+}
+
+/* ---------- MaskParser ---------- */
+
+Charset MaskParser::builtinCharset(char c)
+{
+    Charset set;
+    auto addRange = [&set](int from, int to) {
+        for (int i = from; i <= to; ++i) {
+            set.set(i);
+        }
+    };
+
+    switch (c) {
+    case 'l':
+        addRange('a', 'z');
+        break;
+    case 'u':
+        addRange('A', 'Z');
+        break;
+    case 'd':
+        addRange('0', '9');
+        break;
+    case 'h':
+        addRange('0', '9');
+        addRange('a', 'f');
+        break;
+    case 'H':
+        addRange('0', '9');
+        addRange('A', 'F');
+        break;
+    case 's':
+        addRange(' ', '/');
+        addRange(':', '@');
+        addRange('[', '`');
+        addRange('{', '~');
+        break;
+    case 'a':
+        addRange(' ', '~');
+        break;
+    case 'b':
+        addRange(0, 255);
+        break;
+    }
+    return set;
+}
+
+// Custom charsets may use the built-in ones and the custom charsets defined before them, e.g. "?l?d" or "?1-_"
+Charset MaskParser::parseCharset(const QString &charset, const QList<Charset> &previous, bool hexCharset, QString *error)
+{
+    Charset set;
+
+    for (int i = 0; i < charset.size();) {
+        const QChar c = charset.at(i);
+
+        if (c == '?') {
+            if (i + 1 >= charset.size()) {
+                *error = tr("\"?\" at the end, use \"??\" for a question mark");
+                return Charset();
+            }
+
+            const QChar next = charset.at(i + 1);
+            if (next == '?') {
+                set.set('?');
+            } else if (next >= '1' && next <= '4') {
+                const int index = next.unicode() - '1';
+                if (index >= previous.size() || previous.at(index).none()) {
+                    *error = tr("?%1 refers to a charset that is not defined before it").arg(next);
+                    return Charset();
+                }
+                set |= previous.at(index);
+            } else {
+                const Charset builtin = builtinCharset(next.toLatin1());
+                if (builtin.none()) {
+                    *error = tr("Unknown charset ?%1").arg(next);
+                    return Charset();
+                }
+                set |= builtin;
+            }
+            i += 2;
+        } else if (hexCharset) {
+            const int byte = hexByte(charset, i);
+            if (byte < 0) {
+                *error = tr("\"%1\" is not a pair of hex digits").arg(charset.mid(i, 2));
+                return Charset();
+            }
+            set.set(byte);
+            i += 2;
+        } else {
+            int length = 0;
+            for (char byte : literalBytes(charset, i, &length)) {
+                set.set(static_cast<unsigned char>(byte));
+            }
+            i += length;
+        }
+    }
+
+    if (set.none()) {
+        *error = tr("The charset is empty");
+    }
+    return set;
+}
+
+ParsedMask MaskParser::parse(const QString &mask, const QStringList &customCharsets, bool hexCharset)
+{
+    ParsedMask result;
+
+    const auto fail = [&result](const QString &error, int position) {
+        result.error = error;
+        result.errorPosition = position;
+        result.keyspace = Keyspace();
+        return result;
+    };
+
+    if (mask.isEmpty()) {
+        return fail(tr("The mask is empty"), 0);
+    }
+    if (customCharsets.size() > maxCustomCharsets) {
+        return fail(tr("hashcat has only four custom charsets"), -1);
+    }
+
+    QList<Charset> charsets;
+    for (int i = 0; i < maxCustomCharsets; ++i) {
+        const QString charset = customCharsets.value(i);
+        if (charset.isEmpty()) {
+            charsets << Charset();
+            continue;
+        }
+
+        QString error;
+        charsets << parseCharset(charset, charsets, hexCharset, &error);
+        if (!error.isEmpty()) {
+            return fail(tr("Custom charset %1: %2").arg(i + 1).arg(error), -1);
+        }
+    }
+
+    result.keyspace = Keyspace(1);
+    for (int i = 0; i < mask.size();) {
+        const QChar c = mask.at(i);
+
+        if (c == '?') {
+            if (i + 1 >= mask.size()) {
+                return fail(tr("\"?\" at the end, use \"??\" for a question mark"), i);
+            }
+
+            const QChar next = mask.at(i + 1);
+            Charset set;
+            if (next == '?') {
+                set.set('?');
+            } else if (next >= '1' && next <= '4') {
+                set = charsets.at(next.unicode() - '1');
+                if (set.none()) {
+                    return fail(tr("Custom charset %1 is not defined").arg(next), i);
+                }
+            } else {
+                set = builtinCharset(next.toLatin1());
+                if (set.none()) {
+                    return fail(tr("Unknown charset ?%1").arg(next), i);
+                }
+            }
+
+            result.positions << set;
+            result.tokens << mask.mid(i, 2);
+            i += 2;
+        } else if (hexCharset) {
+            const int byte = hexByte(mask, i);
+            if (byte < 0) {
+                return fail(tr("\"%1\" is not a pair of hex digits").arg(mask.mid(i, 2)), i);
+            }
+
+            Charset set;
+            set.set(byte);
+            result.positions << set;
+            result.tokens << mask.mid(i, 2);
+            i += 2;
+        } else {
+            int length = 0;
+            const QByteArray bytes = literalBytes(mask, i, &length);
+            for (qsizetype b = 0; b < bytes.size(); ++b) {
+                Charset set;
+                set.set(static_cast<unsigned char>(bytes.at(b)));
+                result.positions << set;
+                // Multi-byte characters are one token, the other positions have none
+                result.tokens << (b == 0 ? mask.mid(i, length) : QString());
+            }
+            i += length;
+        }
+
+        if (result.positions.size() > maxPositions) {
+            return fail(tr("Longer than %1 positions").arg(maxPositions), i);
+        }
+        result.keyspace.multiply(static_cast<quint32>(result.positions.last().count()));
+    }
+
+    return result;
+}
+
+bool MaskParser::parseHcmaskLine(const QString &line, HcmaskLine *result)
+{
+    QString text = line;
+    if (text.endsWith('\r')) {
+        text.chop(1);
+    }
+    if (text.isEmpty() || text.startsWith('#')) {
+        return false;
+    }
+
+    // "\#" at the start is a mask beginning with "#"
+    if (text.startsWith("\\#")) {
+        text.remove(0, 1);
+    }
+
+    QStringList fields(QString {});
+    for (int i = 0; i < text.size(); ++i) {
+        if (text.at(i) == '\\' && i + 1 < text.size() && text.at(i + 1) == ',') {
+            fields.last() += ',';
+            ++i;
+        } else if (text.at(i) == ',') {
+            fields << QString();
+        } else {
+            fields.last() += text.at(i);
+        }
+    }
+
+    result->mask = fields.takeLast();
+    result->customCharsets = fields;
+    return true;
+}
+
+QString MaskParser::hcmaskLine(const HcmaskLine &line)
+{
+    // Charsets after the last one in use are left out
+    QStringList charsets = line.customCharsets;
+    while (!charsets.isEmpty() && charsets.last().isEmpty()) {
+        charsets.removeLast();
+    }
+
+    QStringList fields;
+    for (const QString &field : std::as_const(charsets) + QStringList(line.mask)) {
+        fields << QString(field).replace(',', "\\,");
+    }
+
+    QString text = fields.join(',');
+    if (text.startsWith('#')) {
+        text.prepend('\\');
+    }
+    return text;
+}
+
+ParsedMaskFile MaskParser::parseHcmask(const QString &text, bool hexCharset)
+{
+    ParsedMaskFile result;
+
+    const QStringList lines = text.split('\n');
+    for (int i = 0; i < lines.size(); ++i) {
+        HcmaskLine line;
+        if (!parseHcmaskLine(lines.at(i), &line)) {
+            continue;
+        }
+
+        ParsedMask mask;
+        if (line.customCharsets.size() > maxCustomCharsets) {
+            mask.error = tr("hashcat has only four custom charsets, a comma in a charset has to be written as \"\\,\"");
+        } else {
+            mask = parse(line.mask, line.customCharsets, hexCharset);
+            result.keyspace.add(mask.keyspace);
+        }
+
+        result.lines << line;
+        result.lineNumbers << i + 1;
+        result.masks << mask;
+    }
+
+    if (result.masks.isEmpty()) {
+        result.error = tr("There are no masks");
+    }
+    return result;
+}
+
+ParsedMaskFile MaskParser::parseHcmaskFile(const QString &file, bool hexCharset)
+{
+    QFile f(file);
+    if (!f.open(QIODevice::ReadOnly)) {
+        ParsedMaskFile result;
+        result.error = tr("Could not open %1").arg(file);
+        return result;
+    }
+    return parseHcmask(QString::fromUtf8(f.readAll()), hexCharset);
+}
+
+// hashcat reads the masks from a file if the mask is the path of one, whatever its name
+bool MaskParser::isHcmaskFile(const QString &mask)
+{
+    return !mask.isEmpty() && !mask.contains('?') && QFile::exists(mask);
+}
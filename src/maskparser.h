@@ -0,0 +1,99 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef MASKPARSER_H
+#define MASKPARSER_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <array>
+#include <bitset>
+
+using Charset = std::bitset<256>;
+
+// Unsigned 128-bit integer for exact keyspaces, without compiler extensions
+class Keyspace
+{
+public:
+    explicit Keyspace(quint64 value = 0);
+
+    void multiply(quint32 factor);
+    void add(const Keyspace &other);
+
+    bool isZero() const;
+    // Set once a result no longer fits into 128 bits, the value is meaningless then
+    bool overflowed() const;
+    // hashcat counts the keyspace in 64 bits
+    bool fitsUInt64() const;
+    // Saturates at the largest quint64
+    quint64 toUInt64() const;
+    // Rounded, for rates and runtimes
+    double toDouble() const;
+    // Decimal digits, with group separators if the locale has them
+    QString toString(bool grouped = true) const;
+
+private:
+    // Least significant first
+    std::array<quint32, 4> limbs {};
+    bool overflow = false;
+};
+
+struct ParsedMask {
+    // One charset per password position
+    QVector<Charset> positions;
+    // The part of the mask each position came from, e.g. "?l", "??" or "a"
+    QStringList tokens;
+    Keyspace keyspace;
+
+    QString error;
+    // Offset in the mask the error refers to, -1 for errors in a custom charset
+    int errorPosition = -1;
+
+    bool isValid() const { return error.isEmpty(); }
+};
+
+// One line of a .hcmask file, the custom charsets apply to this mask only
+struct HcmaskLine {
+    QStringList customCharsets;
+    QString mask;
+};
+
+struct ParsedMaskFile {
+    QList<HcmaskLine> lines;
+    // Numbers of the lines in the file, comments and blank lines are skipped
+    QList<int> lineNumbers;
+    QList<ParsedMask> masks;
+    Keyspace keyspace;
+    QString error;
+
+    int invalidCount() const;
+};
+
+// Parses hashcat masks locally: the built-in charsets ?l ?u ?d ?h ?H ?s ?a ?b, the custom charsets
+// ?1 to ?4, "??" for a literal question mark and, with --hex-charset, literals and charsets in hex
+class MaskParser
+{
+public:
+    // Empty for anything but a built-in charset
+    static Charset builtinCharset(char c);
+
+    // Unchecked custom charsets are passed as empty strings, using one is an error
+    static ParsedMask parse(const QString &mask, const QStringList &customCharsets = {}, bool hexCharset = false);
+    static Charset parseCharset(const QString &charset, const QList<Charset> &previous, bool hexCharset, QString *error);
+
+    // "[charset1,[charset2,[charset3,[charset4,]]]]mask", "\," is a literal comma.
+    // Returns false for comments and blank lines.
+    static bool parseHcmaskLine(const QString &line, HcmaskLine *result);
+    static QString hcmaskLine(const HcmaskLine &line);
+
+    // The hex flag applies to the charsets of every line
+    static ParsedMaskFile parseHcmask(const QString &text, bool hexCharset = false);
+    static ParsedMaskFile parseHcmaskFile(const QString &file, bool hexCharset = false);
+    static bool isHcmaskFile(const QString &mask);
+};
+
+#endif // MASKPARSER_H
@@ -0,0 +1,231 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "maskscheduler.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <algorithm>
+
+/* ---------- MaskHistory ---------- */
+
+QList<QByteArray> MaskHistory::readPotfile(const QString &potfile, qint64 maxBytes)
+{
+    QList<QByteArray> plains;
+
+    QFile f(potfile);
+    if (!f.open(QIODevice::ReadOnly)) {
+        return plains;
+    }
+
+    // Start in the middle of a line and drop it
+    if (f.size() > maxBytes) {
+        f.seek(f.size() - maxBytes);
+        f.readLine();
+    }
+
+    while (!f.atEnd()) {
+        QByteArray line = f.readLine();
+        while (line.endsWith('\n') || line.endsWith('\r')) {
+            line.chop(1);
+        }
+
+        // "hash:plain", hashcat writes plains with a colon or unprintable characters as $HEX[...]
+        QByteArray plain = line.mid(line.lastIndexOf(':') + 1);
+        if (plain.startsWith("$HEX[") && plain.endsWith(']')) {
+            plain = QByteArray::fromHex(plain.mid(5, plain.size() - 6));
+        }
+        if (!plain.isEmpty()) {
+            plains << plain;
+        }
+    }
+
+    return plains;
+}
+
+MaskHistory::MaskHistory(const QList<QByteArray> &plains, MaskAnchor anchor)
+    : anchor(anchor)
+    , count(plains.size())
+{
+    for (const QByteArray &plain : plains) {
+        byLength[plain.size()] << plain;
+    }
+}
+
+int MaskHistory::size() const
+{
+    return count;
+}
+
+int MaskHistory::hits(const ParsedMask &mask) const
+{
+    const int length = mask.positions.size();
+    int hits = 0;
+
+    for (auto it = byLength.constBegin(); it != byLength.constEnd(); ++it) {
+        // Hybrid attacks need at least one character from the word
+        if (anchor == MaskAnchor::Whole ? it.key() != length : it.key() <= length) {
+            continue;
+        }
+
+        const int offset = anchor == MaskAnchor::Suffix ? it.key() - length : 0;
+        for (const QByteArray &plain : it.value()) {
+            bool matches = true;
+            for (int i = 0; i < length && matches; ++i) {
+                matches = mask.positions.at(i).test(static_cast<unsigned char>(plain.at(offset + i)));
+            }
+            hits += matches;
+        }
+    }
+
+    return hits;
+}
+
+/* ---------- MaskScheduler ---------- */
+
+QList<ScheduledMask> MaskScheduler::schedule(const ParsedMaskFile &file, const MaskCost &cost, const MaskHistory &history)
+{
+    QList<ScheduledMask> result;
+
+    const int valid = file.masks.size() - file.invalidCount();
+    for (int i = 0; i < file.masks.size(); ++i) {
+        const ParsedMask &mask = file.masks.at(i);
+        if (!mask.isValid()) {
+            continue;
+        }
+
+        ScheduledMask scheduled;
+        scheduled.line = file.lines.at(i);
+        scheduled.keyspace = mask.keyspace;
+        scheduled.hits = history.hits(mask);
+
+        // Laplace smoothing, without any history every mask is expected to crack the same
+        const double share = (scheduled.hits + 1.0) / (history.size() + valid);
+        // The words of hybrid attacks multiply every mask alike and don't change the order
+        const double candidates = mask.keyspace.toDouble();
+        scheduled.yield = share / candidates;
+
+        if (cost.speed > 0 && cost.multiplier > 0) {
+            scheduled.seconds = candidates * cost.multiplier / cost.speed;
+        }
+
+        result << scheduled;
+    }
+
+    std::stable_sort(result.begin(), result.end(), [](const ScheduledMask &a, const ScheduledMask &b) {
+        return a.yield > b.yield;
+    });
+
+    cutToBudget(result, cost);
+    return result;
+}
+
+QList<ScheduledMask> MaskScheduler::scheduleCounts(const QHash<QString, quint64> &counts, quint64 passwords, const MaskCost &cost,
+                                                   const QStringList &customCharsets, double targetCoverage)
+{
+    QList<ScheduledMask> result;
+    result.reserve(counts.size());
+
+    for (auto it = counts.constBegin(); it != counts.constEnd(); ++it) {
+        const ParsedMask mask = MaskParser::parse(it.key(), customCharsets);
+        if (!mask.isValid()) {
+            continue;
+        }
+
+        ScheduledMask scheduled;
+        scheduled.line.customCharsets = customCharsets;
+        scheduled.line.mask = it.key();
+        scheduled.keyspace = mask.keyspace;
+        scheduled.hits = it.value();
+
+        // Passwords found per candidate, the count is exact and needs no smoothing
+        const double candidates = mask.keyspace.toDouble();
+        scheduled.yield = static_cast<double>(scheduled.hits) / candidates;
+        if (cost.speed > 0 && cost.multiplier > 0) {
+            scheduled.seconds = candidates * cost.multiplier / cost.speed;
+        }
+
+        result << scheduled;
+    }
+
+    // Hash order is random, equal yields are ordered by their masks so the result is stable
+    std::sort(result.begin(), result.end(), [](const ScheduledMask &a, const ScheduledMask &b) {
+        return a.yield != b.yield ? a.yield > b.yield : a.line.mask < b.line.mask;
+    });
+
+    cutToBudget(result, cost);
+
+    if (targetCoverage < 1.0) {
+        quint64 covered = 0;
+        for (ScheduledMask &mask : result) {
+            if (mask.isCut()) {
+                continue;
+            }
+            if (static_cast<double>(covered) >= targetCoverage * static_cast<double>(passwords)) {
+                mask.cut = MaskCut::Coverage;
+            } else {
+                covered += mask.hits;
+            }
+        }
+    }
+
+    return result;
+}
+
+// A mask that starts within the budget runs to its end, the first one always runs
+void MaskScheduler::cutToBudget(QList<ScheduledMask> &masks, const MaskCost &cost)
+{
+    if (cost.budgetSeconds <= 0) {
+        return;
+    }
+
+    double elapsed = 0;
+    for (int i = 0; i < masks.size(); ++i) {
+        if (masks.at(i).seconds < 0) {
+            break;
+        }
+        masks[i].cut = i > 0 && elapsed >= cost.budgetSeconds ? MaskCut::Budget : MaskCut::None;
+        elapsed += masks.at(i).seconds;
+    }
+}
+
+double MaskScheduler::totalSeconds(const QList<ScheduledMask> &masks)
+{
+    double seconds = 0;
+    for (const ScheduledMask &mask : masks) {
+        if (mask.isCut()) {
+            continue;
+        }
+        if (mask.seconds < 0) {
+            return -1;
+        }
+        seconds += mask.seconds;
+    }
+    return seconds;
+}
+
+QString MaskScheduler::toHcmask(const QList<ScheduledMask> &masks, bool withCut)
+{
+    QStringList lines;
+    QStringList overBudget;
+    QStringList covered;
+
+    for (const ScheduledMask &mask : masks) {
+        if (mask.cut == MaskCut::Budget) {
+            overBudget << "# " + MaskParser::hcmaskLine(mask.line);
+        } else if (mask.cut == MaskCut::Coverage) {
+            covered << "# " + MaskParser::hcmaskLine(mask.line);
+        } else {
+            lines << MaskParser::hcmaskLine(mask.line);
+        }
+    }
+
+    if (withCut && !overBudget.isEmpty()) {
+        lines << QCoreApplication::translate("MaskScheduler", "# Over the time budget:") << overBudget;
+    }
+    if (withCut && !covered.isEmpty()) {
+        lines << QCoreApplication::translate("MaskScheduler", "# Not needed for the target coverage:") << covered;
+    }
+    return lines.join('\n') + '\n';
+}
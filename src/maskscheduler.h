@@ -0,0 +1,99 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef MASKSCHEDULER_H
+#define MASKSCHEDULER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include "maskparser.h"
+
+// Which part of a cracked password a mask has to match
+enum class MaskAnchor
+{
+    // Brute-force, the mask is the whole password
+    Whole,
+    // Hybrid wordlist + mask, the mask is appended
+    Suffix,
+    // Hybrid mask + wordlist, the mask is prepended
+    Prefix,
+};
+
+// Cracked passwords to learn which masks find something
+class MaskHistory
+{
+public:
+    // The passwords at the end of the potfile are the most recent cracks, only the last maxBytes are read
+    static QList<QByteArray> readPotfile(const QString &potfile, qint64 maxBytes = 16 * 1024 * 1024);
+
+    explicit MaskHistory(const QList<QByteArray> &plains = {}, MaskAnchor anchor = MaskAnchor::Whole);
+
+    int size() const;
+    // Number of passwords the mask matches
+    int hits(const ParsedMask &mask) const;
+
+private:
+    MaskAnchor anchor;
+    int count = 0;
+    // Passwords by length, a mask only has to be compared with those it can match
+    QHash<int, QList<QByteArray>> byLength;
+};
+
+struct MaskCost {
+    // Candidates per second of the hash mode, 0 if unknown
+    qint64 speed = 0;
+    // Words every mask candidate is combined with in hybrid attacks, 0 if unknown
+    quint64 multiplier = 1;
+    // Masks that would start after this many seconds are cut, 0 for no limit
+    qint64 budgetSeconds = 0;
+};
+
+// Why a mask is left out of the attack
+enum class MaskCut
+{
+    None,
+    // It would start after the time budget is used up
+    Budget,
+    // The masks before it already match the target share of the passwords
+    Coverage,
+};
+
+struct ScheduledMask {
+    HcmaskLine line;
+    Keyspace keyspace;
+    // Estimated runtime, -1 if the speed is unknown
+    double seconds = -1;
+    quint64 hits = 0;
+    // Expected share of the cracks per candidate, higher runs first
+    double yield = 0;
+    MaskCut cut = MaskCut::None;
+
+    bool isCut() const { return cut != MaskCut::None; }
+};
+
+// Orders the masks of a file by expected cracks per second: the share of cracked passwords
+// a mask matched (smoothed, so masks without history keep a chance) divided by its candidates.
+// Without history this puts the smallest masks first.
+class MaskScheduler
+{
+public:
+    // Invalid masks are left out
+    static QList<ScheduledMask> schedule(const ParsedMaskFile &file, const MaskCost &cost, const MaskHistory &history = MaskHistory());
+    // Masks mined from passwords, with the number of passwords each one matched. Masks are cut once
+    // they are over the budget or the ones before already cover targetCoverage of the passwords.
+    static QList<ScheduledMask> scheduleCounts(const QHash<QString, quint64> &counts, quint64 passwords, const MaskCost &cost,
+                                               const QStringList &customCharsets = {}, double targetCoverage = 1.0);
+    // Runtime of the masks that are not cut, -1 if the speed is unknown
+    static double totalSeconds(const QList<ScheduledMask> &masks);
+    // The masks in order, cut masks follow as comments under the reason they were cut so they can be brought back
+    static QString toHcmask(const QList<ScheduledMask> &masks, bool withCut = true);
+
+private:
+    static void cutToBudget(QList<ScheduledMask> &masks, const MaskCost &cost);
+};
+
+#endif // MASKSCHEDULER_H
@@ -0,0 +1,112 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "outfiletailer.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QTimer>
+
+// Large files are read in steps, so the event loop keeps running in between
+static constexpr qint64 maxReadSize = 8 * 1024 * 1024;
+// The first bytes tell a replaced file from the one read so far, even if the new one is just as large
+static constexpr qint64 headSize = 4096;
+
+OutfileTailer::OutfileTailer(QObject *parent)
+    : QObject(parent)
+{
+    connect(&watcher, &QFileSystemWatcher::fileChanged, this, [this] {
+        // Some platforms stop watching a file that was replaced
+        watch();
+        scheduleRead();
+    });
+    connect(&watcher, &QFileSystemWatcher::directoryChanged, this, [this] {
+        if (QFileInfo(path).isFile()) {
+            watch();
+            scheduleRead();
+        }
+    });
+}
+
+void OutfileTailer::setFile(const QString &file)
+{
+    path = file;
+    offset = 0;
+    head.clear();
+    initialSize = QFileInfo(file).isFile() ? QFileInfo(file).size() : 0;
+
+    watch();
+    scheduleRead();
+}
+
+QString OutfileTailer::file() const
+{
+    return path;
+}
+
+// The file itself once it exists, until then its directory
+void OutfileTailer::watch()
+{
+    if (!watcher.files().isEmpty()) {
+        watcher.removePaths(watcher.files());
+    }
+    if (!watcher.directories().isEmpty()) {
+        watcher.removePaths(watcher.directories());
+    }
+    if (path.isEmpty()) {
+        return;
+    }
+
+    const QFileInfo info(path);
+    watcher.addPath(info.isFile() ? info.absoluteFilePath() : info.absolutePath());
+}
+
+// hashcat writes one line per crack, all changes until the event loop runs again are read at once
+void OutfileTailer::scheduleRead()
+{
+    if (!readPending) {
+        readPending = true;
+        QTimer::singleShot(0, this, &OutfileTailer::readAppended);
+    }
+}
+
+void OutfileTailer::readAppended()
+{
+    readPending = false;
+
+    QFile f(path);
+    if (path.isEmpty() || !f.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    if (f.size() < offset || f.read(head.size()) != head) {
+        offset = 0;
+        head.clear();
+        initialSize = 0;
+        emit restarted();
+    }
+    if (f.size() == offset || !f.seek(offset)) {
+        return;
+    }
+
+    const QByteArray data = f.read(qMin(f.size() - offset, maxReadSize));
+    const qsizetype end = data.lastIndexOf('\n') + 1;
+
+    // A line longer than a whole step is cut rather than blocking the file forever
+    const qsizetype consumed = end > 0 ? end : (data.size() == maxReadSize ? data.size() : 0);
+    if (consumed == 0) {
+        return;
+    }
+
+    const bool appended = offset >= initialSize;
+    if (head.size() < headSize && offset == head.size()) {
+        head += data.left(qMin<qint64>(consumed, headSize - head.size()));
+    }
+    offset += consumed;
+    emit linesRead(data.left(consumed), appended);
+
+    if (offset < f.size()) {
+        scheduleRead();
+    }
+}
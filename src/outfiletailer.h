@@ -0,0 +1,46 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef OUTFILETAILER_H
+#define OUTFILETAILER_H
+
+#include <QByteArray>
+#include <QFileSystemWatcher>
+#include <QObject>
+#include <QString>
+
+// Follows a file hashcat appends to, every byte is read once
+class OutfileTailer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit OutfileTailer(QObject *parent = nullptr);
+
+    // Starts with what the file already contains, a file that does not exist yet is waited for
+    void setFile(const QString &file);
+    QString file() const;
+
+signals:
+    // Complete lines only, appended is false for what the file contained when it was set
+    void linesRead(const QByteArray &lines, bool appended);
+    // The file was replaced or truncated, reading starts over
+    void restarted();
+
+private:
+    QFileSystemWatcher watcher;
+    QString path;
+    qint64 offset = 0;
+    // Start of the file as far as it was read
+    QByteArray head;
+    qint64 initialSize = 0;
+    bool readPending = false;
+
+    void watch();
+    void scheduleRead();
+    void readAppended();
+};
+
+#endif // OUTFILETAILER_H
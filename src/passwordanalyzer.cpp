@@ -0,0 +1,223 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "passwordanalyzer.h"
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QStringList>
+#include <QtConcurrent>
+#include <cstring>
+
+struct PasswordAnalyzer::ChunkResult {
+    quint64 passwords = 0;
+    QVector<quint64> lengths = QVector<quint64>(PasswordAnalyzer::maxLength + 1, 0);
+    std::array<quint64, PasswordAnalysis::ClassCount> classes {};
+    std::array<quint64, 256> characters {};
+    // One letter per position, e.g. "ulllldd", the mask is built from it once at the end
+    QHash<QByteArray, quint64> masks;
+    bool failed = false;
+};
+
+namespace {
+
+QString tr(const char *text)
+{
+    return QCoreApplication::translate("PasswordAnalyzer", text);
+}
+
+char maskLetter(int characterClass)
+{
+    switch (characterClass) {
+    case PasswordAnalysis::Lower:
+        return 'l';
+    case PasswordAnalysis::Upper:
+        return 'u';
+    case PasswordAnalysis::Digit:
+        return 'd';
+    case PasswordAnalysis::Special:
+        return 's';
+    }
+    return 'b';
+}
+
+} // namespace
+
+QByteArray PasswordAnalyzer::password(const char *line, qsizetype length, bool withHash)
+{
+    // Hashes may contain colons, passwords written by hashcat only as $HEX[...]
+    qsizetype begin = 0;
+    if (withHash) {
+        for (qsizetype i = length - 1; i >= 0; --i) {
+            if (line[i] == ':') {
+                begin = i + 1;
+                break;
+            }
+        }
+    }
+
+    const char *p = line + begin;
+    const qsizetype size = length - begin;
+    if (size > 6 && std::memcmp(p, "$HEX[", 5) == 0 && p[size - 1] == ']') {
+        return QByteArray::fromHex(QByteArray::fromRawData(p + 5, size - 6));
+    }
+    // Points into line, it is only used while the line is
+    return QByteArray::fromRawData(p, size);
+}
+
+int PasswordAnalyzer::characterClass(unsigned char c)
+{
+    if (c >= 'a' && c <= 'z') {
+        return PasswordAnalysis::Lower;
+    }
+    if (c >= 'A' && c <= 'Z') {
+        return PasswordAnalysis::Upper;
+    }
+    if (c >= '0' && c <= '9') {
+        return PasswordAnalysis::Digit;
+    }
+    // ?s is every other printable ASCII character, the space included
+    if (c >= 0x20 && c <= 0x7e) {
+        return PasswordAnalysis::Special;
+    }
+    return PasswordAnalysis::Other;
+}
+
+QString PasswordAnalyzer::className(int classes)
+{
+    QStringList names;
+    if (classes & PasswordAnalysis::Lower) {
+        names << tr("lower");
+    }
+    if (classes & PasswordAnalysis::Upper) {
+        names << tr("upper");
+    }
+    if (classes & PasswordAnalysis::Digit) {
+        names << tr("digit");
+    }
+    if (classes & PasswordAnalysis::Special) {
+        names << tr("special");
+    }
+    if (classes & PasswordAnalysis::Other) {
+        names << tr("other");
+    }
+    return names.join(" + ");
+}
+
+void PasswordAnalyzer::analyze(QPromise<PasswordAnalysis> &promise, const QList<PasswordSource> &sources)
+{
+    PasswordAnalysis analysis;
+
+    // The chunks of all files go through the same workers
+    QList<QPair<FileChunks::Chunk, bool>> chunks;
+    for (const PasswordSource &source : sources) {
+        const QFileInfo info(source.file);
+        if (!info.isFile()) {
+            analysis.error = tr("%1 does not exist.").arg(source.file);
+            promise.addResult(analysis);
+            return;
+        }
+        for (const FileChunks::Chunk &chunk : FileChunks::split(source.file, info.size())) {
+            chunks.append({ chunk, source.withHash });
+        }
+    }
+
+    promise.setProgressRange(0, 100);
+    int done = 0;
+
+    const ChunkResult total = QtConcurrent::blockingMappedReduced<ChunkResult>(
+        chunks,
+        [&promise](const QPair<FileChunks::Chunk, bool> &chunk) {
+            return promise.isCanceled() ? ChunkResult() : analyzeChunk(chunk.first, chunk.second);
+        },
+        [&promise, &done, &chunks](ChunkResult &result, const ChunkResult &chunk) {
+            mergeChunk(result, chunk);
+            promise.setProgressValue(static_cast<int>(100 * ++done / chunks.size()));
+        });
+
+    if (promise.isCanceled()) {
+        return;
+    }
+    if (total.failed) {
+        analysis.error = tr("Could not read the cracked passwords.");
+        promise.addResult(analysis);
+        return;
+    }
+
+    analysis.passwords = total.passwords;
+    analysis.lengths = total.lengths;
+    analysis.classes = total.classes;
+    analysis.characters = total.characters;
+
+    analysis.masks.reserve(total.masks.size());
+    for (auto it = total.masks.constBegin(); it != total.masks.constEnd(); ++it) {
+        QString mask;
+        mask.reserve(it.key().size() * 2);
+        for (char letter : it.key()) {
+            mask += '?';
+            mask += QLatin1Char(letter);
+        }
+        analysis.masks.insert(mask, it.value());
+    }
+
+    promise.addResult(analysis);
+}
+
+PasswordAnalyzer::ChunkResult PasswordAnalyzer::analyzeChunk(const FileChunks::Chunk &chunk, bool withHash)
+{
+    ChunkResult result;
+    QByteArray mask;
+
+    result.failed = !FileChunks::forEachLine(chunk, [&](const char *line, qsizetype length) {
+        const QByteArray plain = password(line, length, withHash);
+        if (plain.isEmpty()) {
+            return;
+        }
+
+        ++result.passwords;
+        ++result.lengths[qMin<qsizetype>(plain.size(), maxLength)];
+
+        const bool masked = plain.size() <= maxMaskLength;
+        if (masked) {
+            mask.resize(plain.size());
+        }
+
+        int classes = 0;
+        for (qsizetype i = 0; i < plain.size(); ++i) {
+            const unsigned char c = static_cast<unsigned char>(plain.at(i));
+            const int type = characterClass(c);
+            ++result.characters[c];
+            classes |= type;
+            if (masked) {
+                mask[i] = maskLetter(type);
+            }
+        }
+
+        ++result.classes[classes];
+        if (masked) {
+            ++result.masks[mask];
+        }
+    });
+
+    return result;
+}
+
+void PasswordAnalyzer::mergeChunk(ChunkResult &result, const ChunkResult &chunk)
+{
+    result.failed |= chunk.failed;
+    result.passwords += chunk.passwords;
+
+    for (int i = 0; i < result.lengths.size(); ++i) {
+        result.lengths[i] += chunk.lengths.at(i);
+    }
+    for (size_t i = 0; i < result.classes.size(); ++i) {
+        result.classes[i] += chunk.classes[i];
+    }
+    for (size_t i = 0; i < result.characters.size(); ++i) {
+        result.characters[i] += chunk.characters[i];
+    }
+    for (auto it = chunk.masks.constBegin(); it != chunk.masks.constEnd(); ++it) {
+        result.masks[it.key()] += it.value();
+    }
+}
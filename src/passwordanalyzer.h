@@ -0,0 +1,74 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef PASSWORDANALYZER_H
+#define PASSWORDANALYZER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QPromise>
+#include <QString>
+#include <QVector>
+#include <array>
+#include "filechunks.h"
+
+// A file of cracked passwords
+struct PasswordSource {
+    QString file;
+    // Potfiles and outfiles have "hash:password" lines, wordlists one password per line
+    bool withHash = true;
+};
+
+struct PasswordAnalysis {
+    // Classes of the characters a password has
+    enum CharacterClass
+    {
+        Lower   = 1,
+        Upper   = 2,
+        Digit   = 4,
+        Special = 8,
+        // Everything ?s does not cover, e.g. UTF-8
+        Other   = 16,
+        ClassCount = 32
+    };
+
+    quint64 passwords = 0;
+    // Passwords by length, the last entry counts everything from maxLength on
+    QVector<quint64> lengths;
+    // Passwords by the combination of character classes they have
+    std::array<quint64, ClassCount> classes {};
+    // Occurrences of every byte
+    std::array<quint64, 256> characters {};
+    // Passwords by their mask, e.g. "?u?l?l?l?d?d"
+    QHash<QString, quint64> masks;
+    QString error;
+};
+
+// Streams cracked passwords through all cores and counts what masks, lengths and characters they have,
+// like statsgen from the PACK tools
+class PasswordAnalyzer
+{
+public:
+    static constexpr int maxLength = 64;
+    // Longer passwords are counted, but brute-forcing them is hopeless, they get no mask
+    static constexpr int maxMaskLength = 24;
+
+    // The password of a line, hashcat writes passwords with unprintable characters as $HEX[...]
+    static QByteArray password(const char *line, qsizetype length, bool withHash);
+    static int characterClass(unsigned char c);
+    // Readable name of a combination of classes, e.g. "lower + digit"
+    static QString className(int classes);
+
+    static void analyze(QPromise<PasswordAnalysis> &promise, const QList<PasswordSource> &sources);
+
+private:
+    struct ChunkResult;
+
+    static ChunkResult analyzeChunk(const FileChunks::Chunk &chunk, bool withHash);
+    static void mergeChunk(ChunkResult &result, const ChunkResult &chunk);
+};
+
+#endif // PASSWORDANALYZER_H
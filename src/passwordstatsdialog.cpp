@@ -0,0 +1,318 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "passwordstatsdialog.h"
+#include "ui_passwordstatsdialog.h"
+#include "helperutils.h"
+#include "maskscheduler.h"
+#include <QDir>
+#include <QFileDialog>
+#include <QHeaderView>
+#include <QLocale>
+#include <QMessageBox>
+#include <QtConcurrent>
+#include <algorithm>
+
+PasswordStatsDialog::PasswordStatsDialog(QWidget *parent)
+    : QDialog(parent)
+    , ui(new Ui::PasswordStatsDialog)
+{
+    ui->setupUi(this);
+    ui->progressBar->hide();
+    ui->treeWidget_sources->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    ui->treeWidget_sources->header()->setSectionResizeMode(1, QHeaderView::ResizeToContents);
+
+    connect(ui->pushButton_add_outfiles, &QPushButton::clicked, this, &PasswordStatsDialog::addOutfilesClicked);
+    connect(ui->pushButton_add_passwords, &QPushButton::clicked, this, &PasswordStatsDialog::addPasswordListsClicked);
+    connect(ui->pushButton_remove, &QPushButton::clicked, this, &PasswordStatsDialog::removeClicked);
+    connect(ui->pushButton_analyze, &QPushButton::clicked, this, &PasswordStatsDialog::analyzeClicked);
+    connect(ui->pushButton_generate, &QPushButton::clicked, this, &PasswordStatsDialog::generateClicked);
+    connect(ui->pushButton_use_mask, &QPushButton::clicked, this, &PasswordStatsDialog::useMaskClicked);
+    connect(ui->pushButton_close, &QPushButton::clicked, this, &PasswordStatsDialog::close);
+    connect(ui->tableWidget_masks, &QTableWidget::itemDoubleClicked, this, &PasswordStatsDialog::useMaskClicked);
+    connect(ui->treeWidget_sources, &QTreeWidget::itemSelectionChanged, this, [this] {
+        ui->pushButton_remove->setEnabled(!ui->treeWidget_sources->selectedItems().isEmpty());
+    });
+    connect(ui->tableWidget_masks, &QTableWidget::itemSelectionChanged, this, [this] {
+        ui->pushButton_use_mask->setEnabled(!ui->tableWidget_masks->selectedItems().isEmpty());
+    });
+    connect(ui->spinBox_min_length, &QSpinBox::valueChanged, ui->spinBox_max_length, [this](int value) {
+        ui->spinBox_max_length->setMinimum(value);
+    });
+
+    connect(&watcher, &QFutureWatcher<PasswordAnalysis>::progressValueChanged, ui->progressBar, &QProgressBar::setValue);
+    connect(&watcher, &QFutureWatcher<PasswordAnalysis>::finished, this, &PasswordStatsDialog::analyzeFinished);
+}
+
+PasswordStatsDialog::~PasswordStatsDialog()
+{
+    watcher.cancel();
+    watcher.waitForFinished();
+    delete ui;
+}
+
+void PasswordStatsDialog::addSource(const QString &file, bool withHash)
+{
+    if (file.isEmpty() || !ui->treeWidget_sources->findItems(file, Qt::MatchExactly).isEmpty()) {
+        return;
+    }
+
+    auto *item = new QTreeWidgetItem(ui->treeWidget_sources, { file, withHash ? tr("hash:password") : tr("password") });
+    item->setData(0, Qt::UserRole, withHash);
+}
+
+void PasswordStatsDialog::setSpeed(qint64 speed, const QString &source)
+{
+    this->speed = speed;
+    speedSource = source;
+}
+
+void PasswordStatsDialog::addOutfilesClicked()
+{
+    const QStringList files = QFileDialog::getOpenFileNames(this, tr("Add outfiles"));
+    for (const QString &file : files) {
+        addSource(QDir::toNativeSeparators(file), true);
+    }
+}
+
+void PasswordStatsDialog::addPasswordListsClicked()
+{
+    const QStringList files = QFileDialog::getOpenFileNames(this, tr("Add password lists"));
+    for (const QString &file : files) {
+        addSource(QDir::toNativeSeparators(file), false);
+    }
+}
+
+void PasswordStatsDialog::removeClicked()
+{
+    qDeleteAll(ui->treeWidget_sources->selectedItems());
+}
+
+QList<PasswordSource> PasswordStatsDialog::sources() const
+{
+    QList<PasswordSource> result;
+    for (int i = 0; i < ui->treeWidget_sources->topLevelItemCount(); ++i) {
+        const QTreeWidgetItem *item = ui->treeWidget_sources->topLevelItem(i);
+        result.append({ item->text(0), item->data(0, Qt::UserRole).toBool() });
+    }
+    return result;
+}
+
+void PasswordStatsDialog::analyzeClicked()
+{
+    if (watcher.isRunning()) {
+        watcher.cancel();
+        return;
+    }
+
+    const QList<PasswordSource> files = sources();
+    if (files.isEmpty()) {
+        QMessageBox::information(this, tr("Password statistics"), tr("Add the potfile, outfiles or lists of cracked passwords first."));
+        return;
+    }
+
+    ui->pushButton_analyze->setText(tr("Cancel"));
+    ui->pushButton_generate->setEnabled(false);
+    ui->progressBar->setValue(0);
+    ui->progressBar->show();
+    watcher.setFuture(QtConcurrent::run(&PasswordAnalyzer::analyze, files));
+}
+
+void PasswordStatsDialog::analyzeFinished()
+{
+    ui->pushButton_analyze->setText(tr("Analyze"));
+    ui->progressBar->hide();
+
+    if (watcher.isCanceled() || watcher.future().resultCount() == 0) {
+        return;
+    }
+
+    analysis = watcher.result();
+    if (!analysis.error.isEmpty()) {
+        QMessageBox::warning(this, tr("Password statistics"), analysis.error);
+        return;
+    }
+
+    showAnalysis();
+    ui->pushButton_generate->setEnabled(analysis.passwords > 0);
+}
+
+void PasswordStatsDialog::showAnalysis()
+{
+    QLocale locale;
+    const double total = static_cast<double>(qMax<quint64>(analysis.passwords, 1));
+    const auto share = [total](quint64 count) {
+        return QString("%1%").arg(100.0 * static_cast<double>(count) / total, 0, 'f', 2);
+    };
+
+    ui->label_summary->setText(tr("%1 passwords, %2 distinct masks up to %3 characters")
+                                   .arg(locale.toString(analysis.passwords), locale.toString(analysis.masks.size()))
+                                   .arg(PasswordAnalyzer::maxMaskLength));
+
+    // Masks, most common first
+    QList<QPair<QString, quint64>> masks;
+    masks.reserve(analysis.masks.size());
+    for (auto it = analysis.masks.constBegin(); it != analysis.masks.constEnd(); ++it) {
+        masks.append({ it.key(), it.value() });
+    }
+    const auto listed = masks.begin() + qMin<qsizetype>(masks.size(), maxListedMasks);
+    std::partial_sort(masks.begin(), listed, masks.end(), [](const auto &a, const auto &b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    masks.erase(listed, masks.end());
+
+    QList<QStringList> rows;
+    for (const auto &mask : std::as_const(masks)) {
+        rows << QStringList { mask.first, locale.toString(mask.second), share(mask.second), MaskParser::parse(mask.first).keyspace.toString() };
+    }
+    setRows(ui->tableWidget_masks, rows);
+
+    rows.clear();
+    for (int length = 1; length < analysis.lengths.size(); ++length) {
+        const quint64 count = analysis.lengths.at(length);
+        if (count > 0) {
+            const QString label = length == PasswordAnalyzer::maxLength ? QString("%1+").arg(length) : QString::number(length);
+            rows << QStringList { label, locale.toString(count), share(count) };
+        }
+    }
+    setRows(ui->tableWidget_lengths, rows);
+
+    QList<int> classes;
+    for (int i = 1; i < PasswordAnalysis::ClassCount; ++i) {
+        if (analysis.classes[i] > 0) {
+            classes << i;
+        }
+    }
+    std::sort(classes.begin(), classes.end(), [this](int a, int b) { return analysis.classes[a] > analysis.classes[b]; });
+    rows.clear();
+    for (int i : std::as_const(classes)) {
+        rows << QStringList { PasswordAnalyzer::className(i), locale.toString(analysis.classes[i]), share(analysis.classes[i]) };
+    }
+    setRows(ui->tableWidget_charsets, rows);
+
+    // Shares of all characters, not of passwords
+    quint64 characters = 0;
+    QList<int> bytes;
+    for (int c = 0; c < 256; ++c) {
+        if (analysis.characters[c] > 0) {
+            bytes << c;
+            characters += analysis.characters[c];
+        }
+    }
+    std::sort(bytes.begin(), bytes.end(), [this](int a, int b) { return analysis.characters[a] > analysis.characters[b]; });
+    rows.clear();
+    for (int c : std::as_const(bytes)) {
+        const QString character = PasswordAnalyzer::characterClass(c) == PasswordAnalysis::Other ? QString("\\x%1").arg(c, 2, 16, QChar('0'))
+                                : c == ' ' ? tr("Space") : QString(QChar(c));
+        rows << QStringList { character, locale.toString(analysis.characters[c]),
+                              QString("%1%").arg(100.0 * static_cast<double>(analysis.characters[c]) / static_cast<double>(characters), 0, 'f', 2) };
+    }
+    setRows(ui->tableWidget_characters, rows);
+}
+
+void PasswordStatsDialog::setRows(QTableWidget *table, const QList<QStringList> &rows)
+{
+    table->clearContents();
+    table->setRowCount(rows.size());
+    for (int row = 0; row < rows.size(); ++row) {
+        for (int column = 0; column < rows.at(row).size(); ++column) {
+            auto *item = new QTableWidgetItem(rows.at(row).at(column));
+            if (column > 0) {
+                item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            }
+            table->setItem(row, column, item);
+        }
+    }
+    table->resizeColumnsToContents();
+}
+
+QString PasswordStatsDialog::specialCharset() const
+{
+    const int count = ui->spinBox_specials->value();
+    if (count == 0) {
+        return QString();
+    }
+
+    QList<int> specials;
+    for (int c = 0; c < 256; ++c) {
+        if (PasswordAnalyzer::characterClass(c) == PasswordAnalysis::Special && analysis.characters[c] > 0) {
+            specials << c;
+        }
+    }
+    std::sort(specials.begin(), specials.end(), [this](int a, int b) { return analysis.characters[a] > analysis.characters[b]; });
+
+    // A question mark in a charset is written twice
+    QString charset;
+    for (int i = 0; i < qMin<qsizetype>(count, specials.size()); ++i) {
+        charset += specials.at(i) == '?' ? QString("??") : QString(QChar(specials.at(i)));
+    }
+    return charset;
+}
+
+QString PasswordStatsDialog::applySpecials(const QString &mask) const
+{
+    return specialCharset().isEmpty() ? mask : QString(mask).replace("?s", "?1");
+}
+
+// Masks are ordered by the passwords they matched per candidate and cut at the budget or the coverage
+void PasswordStatsDialog::generateClicked()
+{
+    const QString specials = specialCharset();
+    const QStringList customCharsets = specials.isEmpty() ? QStringList() : QStringList { specials };
+
+    QHash<QString, quint64> counts;
+    for (auto it = analysis.masks.constBegin(); it != analysis.masks.constEnd(); ++it) {
+        const int length = it.key().size() / 2;
+        if (length >= ui->spinBox_min_length->value() && length <= ui->spinBox_max_length->value()) {
+            counts[applySpecials(it.key())] += it.value();
+        }
+    }
+
+    MaskCost cost;
+    cost.speed = speed;
+    cost.budgetSeconds = ui->spinBox_budget->value() * 60;
+    const QList<ScheduledMask> schedule = MaskScheduler::scheduleCounts(counts, analysis.passwords, cost, customCharsets,
+                                                                        ui->spinBox_coverage->value() / 100.0);
+
+    int used = 0;
+    quint64 covered = 0;
+    for (const ScheduledMask &mask : schedule) {
+        if (!mask.isCut()) {
+            ++used;
+            covered += mask.hits;
+        }
+    }
+    if (used == 0) {
+        ui->label_generated->setText(tr("No masks of these lengths were found."));
+        return;
+    }
+
+    QString text = tr("%n mask(s) matching %1% of the passwords", nullptr, used)
+                       .arg(100.0 * static_cast<double>(covered) / static_cast<double>(analysis.passwords), 0, 'f', 1);
+    const double seconds = MaskScheduler::totalSeconds(schedule);
+    if (seconds >= 0) {
+        text += tr(", about %1 at %2 (%3)").arg(HelperUtils::formatDuration(static_cast<qint64>(seconds)), HelperUtils::formatSpeed(speed), speedSource);
+    } else if (cost.budgetSeconds > 0) {
+        text += tr(". The speed of the hash mode is unknown, run a benchmark for the time budget.");
+    }
+    ui->label_generated->setText(text);
+
+    emit masksGenerated(MaskScheduler::toHcmask(schedule, false));
+}
+
+void PasswordStatsDialog::useMaskClicked()
+{
+    const QList<QTableWidgetItem *> selected = ui->tableWidget_masks->selectedItems();
+    if (selected.isEmpty()) {
+        return;
+    }
+
+    const QString mask = ui->tableWidget_masks->item(selected.first()->row(), 0)->text();
+    QStringList customCharsets(4);
+    if (mask.contains("?s")) {
+        customCharsets[0] = specialCharset();
+    }
+    emit maskChosen(customCharsets.at(0).isEmpty() ? mask : applySpecials(mask), customCharsets);
+}
@@ -0,0 +1,68 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef PASSWORDSTATSDIALOG_H
+#define PASSWORDSTATSDIALOG_H
+
+#include <QDialog>
+#include <QFutureWatcher>
+#include "passwordanalyzer.h"
+
+namespace Ui {
+    class PasswordStatsDialog;
+}
+
+class QTableWidget;
+
+// Learns masks, lengths and charsets from cracked passwords and turns them into masks for a brute-force attack
+class PasswordStatsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit PasswordStatsDialog(QWidget *parent = nullptr);
+    ~PasswordStatsDialog();
+
+    // Files that are already in the list are skipped
+    void addSource(const QString &file, bool withHash);
+    // Speed of the hash mode, for the time budget
+    void setSpeed(qint64 speed, const QString &source);
+
+signals:
+    // Four custom charsets, unused ones are empty
+    void maskChosen(const QString &mask, const QStringList &customCharsets);
+    // The generated masks in .hcmask format
+    void masksGenerated(const QString &hcmask);
+
+private slots:
+    void addOutfilesClicked();
+    void addPasswordListsClicked();
+    void removeClicked();
+    void analyzeClicked();
+    void analyzeFinished();
+    void generateClicked();
+    void useMaskClicked();
+
+private:
+    Ui::PasswordStatsDialog *ui;
+    QFutureWatcher<PasswordAnalysis> watcher;
+    PasswordAnalysis analysis;
+
+    qint64 speed = 0;
+    QString speedSource;
+
+    // Only the most common masks are listed, all of them are used for generating
+    static constexpr int maxListedMasks = 1000;
+
+    QList<PasswordSource> sources() const;
+    void showAnalysis();
+    // The most frequent special characters as a custom charset, empty if every ?s is used
+    QString specialCharset() const;
+    // ?s becomes ?1 if only the most frequent special characters are used
+    QString applySpecials(const QString &mask) const;
+    static void setRows(QTableWidget *table, const QList<QStringList> &rows);
+};
+
+#endif // PASSWORDSTATSDIALOG_H
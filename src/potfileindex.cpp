@@ -0,0 +1,248 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "potfileindex.h"
+#include "filechunks.h"
+#include "hyperloglog.h"
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+struct PotfileIndex::Header {
+    char magic[8];
+    // Potfile bytes covered by the index, always the end of a line
+    quint64 offset;
+    // Fingerprint of the first bytes of the potfile, tells if it was rewritten instead of appended to
+    quint64 head;
+    quint64 count;
+};
+
+// The fingerprints depend on HyperLogLog::hash(), a new hash function needs a new version
+static constexpr char indexMagic[8] = { 'H', 'C', 'G', 'P', 'O', 'T', '0', '1' };
+static constexpr qint64 headLength = 4096;
+static constexpr qint64 tailBlockSize = 64 * 1024;
+
+// Position after the last line break between begin and end, begin if there is none. hashcat might be
+// writing the last line right now, it is picked up by the next update.
+static qint64 completeLinesEnd(QFile &file, qint64 begin, qint64 end)
+{
+    QByteArray block;
+    while (end > begin) {
+        const qint64 blockBegin = qMax(begin, end - tailBlockSize);
+        if (!file.seek(blockBegin)) {
+            return -1;
+        }
+        block = file.read(end - blockBegin);
+        if (block.size() != end - blockBegin) {
+            return -1;
+        }
+
+        const qsizetype newline = block.lastIndexOf('\n');
+        if (newline >= 0) {
+            return blockBegin + newline + 1;
+        }
+        end = blockBegin;
+    }
+    return begin;
+}
+
+namespace {
+
+struct IndexedChunk {
+    // Sorted and without duplicates
+    std::vector<quint64> fingerprints;
+    bool failed = false;
+};
+
+IndexedChunk indexChunk(const FileChunks::Chunk &chunk)
+{
+    IndexedChunk result;
+
+    result.failed = !FileChunks::forEachLine(chunk, [&result](const char *line, qsizetype length) {
+        // hashcat writes plains that contain the separator as $HEX[...], the last ':' ends the hash
+        qsizetype colon = length - 1;
+        while (colon > 0 && line[colon] != ':') {
+            --colon;
+        }
+        if (colon > 0) {
+            result.fingerprints.push_back(HyperLogLog::hash(line, colon));
+        }
+    });
+
+    std::sort(result.fingerprints.begin(), result.fingerprints.end());
+    result.fingerprints.erase(std::unique(result.fingerprints.begin(), result.fingerprints.end()), result.fingerprints.end());
+    return result;
+}
+
+} // namespace
+
+QString PotfileIndex::defaultPotfile(const QString &hashcatPath)
+{
+    QStringList candidates;
+
+    // Release archives from hashcat.net keep everything next to the executable
+    if (!hashcatPath.isEmpty()) {
+        candidates << QFileInfo(hashcatPath).absoluteDir().filePath("hashcat.potfile");
+    }
+
+    // Installed builds use the XDG data directory, older ones ~/.hashcat
+    const QString dataHome = qEnvironmentVariable("XDG_DATA_HOME", QDir::home().filePath(".local/share"));
+    candidates << QDir(dataHome).filePath("hashcat/hashcat.potfile");
+    candidates << QDir::home().filePath(".hashcat/hashcat.potfile");
+
+    for (const QString &candidate : std::as_const(candidates)) {
+        if (QFileInfo(candidate).isFile()) {
+            return candidate;
+        }
+    }
+    return QString();
+}
+
+bool PotfileIndex::update(const QString &potfile, QString *error)
+{
+    fingerprints.clear();
+
+    auto fail = [this, error](const QString &message) {
+        fingerprints.clear();
+        if (error) {
+            *error = message;
+        }
+        return false;
+    };
+
+    const QFileInfo info(potfile);
+    if (!info.isFile()) {
+        return true;
+    }
+    const qint64 potfileSize = info.size();
+
+    /* ---------- Load the index, a truncated or rewritten potfile is indexed again ---------- */
+
+    const QString indexPath = indexFile(potfile);
+    Header header {};
+    bool valid = false;
+
+    QFile in(indexPath);
+    if (in.open(QIODevice::ReadOnly)) {
+        valid = in.read(reinterpret_cast<char *>(&header), sizeof(header)) == sizeof(header)
+                && std::memcmp(header.magic, indexMagic, sizeof(indexMagic)) == 0
+                && static_cast<qint64>(header.offset) <= potfileSize
+                && in.size() == static_cast<qint64>(sizeof(Header) + header.count * sizeof(quint64))
+                && header.head == headFingerprint(potfile, qMin<qint64>(static_cast<qint64>(header.offset), headLength));
+        if (valid) {
+            const qint64 bytes = static_cast<qint64>(header.count * sizeof(quint64));
+            fingerprints.resize(header.count);
+            valid = in.read(reinterpret_cast<char *>(fingerprints.data()), bytes) == bytes;
+        }
+        in.close();
+    }
+
+    if (!valid) {
+        fingerprints.clear();
+        header = Header {};
+    }
+
+    /* ---------- Read only the lines appended since ---------- */
+
+    QFile pot(potfile);
+    if (!pot.open(QIODevice::ReadOnly)) {
+        return fail(QCoreApplication::translate("PotfileIndex", "Could not read %1: %2").arg(potfile, pot.errorString()));
+    }
+    const qint64 begin = static_cast<qint64>(header.offset);
+    const qint64 end = completeLinesEnd(pot, begin, potfileSize);
+    pot.close();
+
+    if (end < 0) {
+        return fail(QCoreApplication::translate("PotfileIndex", "Could not read %1.").arg(potfile));
+    }
+    if (end == begin) {
+        return true;
+    }
+
+    const QList<FileChunks::Chunk> chunks = FileChunks::split(potfile, end, FileChunks::defaultChunkSize, begin);
+    const IndexedChunk added = QtConcurrent::blockingMappedReduced<IndexedChunk>(chunks, &indexChunk,
+        [](IndexedChunk &result, const IndexedChunk &chunk) {
+            result.failed |= chunk.failed;
+            const auto middle = static_cast<std::ptrdiff_t>(result.fingerprints.size());
+            result.fingerprints.insert(result.fingerprints.end(), chunk.fingerprints.begin(), chunk.fingerprints.end());
+            std::inplace_merge(result.fingerprints.begin(), result.fingerprints.begin() + middle, result.fingerprints.end());
+        },
+        QtConcurrent::UnorderedReduce);
+
+    if (added.failed) {
+        return fail(QCoreApplication::translate("PotfileIndex", "Could not read %1.").arg(potfile));
+    }
+
+    // Both are sorted, chunks may share hashes and hashes might have been cracked again
+    std::vector<quint64> merged;
+    merged.reserve(fingerprints.size() + added.fingerprints.size());
+    std::set_union(fingerprints.begin(), fingerprints.end(), added.fingerprints.begin(), added.fingerprints.end(),
+                   std::back_inserter(merged));
+    merged.erase(std::unique(merged.begin(), merged.end()), merged.end());
+    fingerprints.swap(merged);
+
+    /* ---------- Save for the next update ---------- */
+
+    std::memcpy(header.magic, indexMagic, sizeof(indexMagic));
+    header.offset = static_cast<quint64>(end);
+    header.head = headFingerprint(potfile, qMin(end, headLength));
+    header.count = fingerprints.size();
+
+    // Another update might be saving the same index, the last one to commit wins and both are complete
+    QSaveFile out(indexPath);
+    const qint64 bytes = static_cast<qint64>(fingerprints.size() * sizeof(quint64));
+    if (!out.open(QIODevice::WriteOnly)
+        || out.write(reinterpret_cast<const char *>(&header), sizeof(header)) != sizeof(header)
+        || out.write(reinterpret_cast<const char *>(fingerprints.data()), bytes) != bytes
+        || !out.commit()) {
+        // The index in memory is still good, the next update reads the potfile again
+        qWarning("Could not write %s: %s", qPrintable(indexPath), qPrintable(out.errorString()));
+    }
+
+    return true;
+}
+
+bool PotfileIndex::isEmpty() const
+{
+    return fingerprints.empty();
+}
+
+quint64 PotfileIndex::size() const
+{
+    return fingerprints.size();
+}
+
+bool PotfileIndex::contains(const char *hash, qsizetype length) const
+{
+    return !fingerprints.empty() && std::binary_search(fingerprints.begin(), fingerprints.end(), HyperLogLog::hash(hash, length));
+}
+
+QString PotfileIndex::indexFile(const QString &potfile)
+{
+    const QString dirPath = QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).filePath("potfile");
+    QDir().mkpath(dirPath);
+
+    const QByteArray path = QFileInfo(potfile).absoluteFilePath().toUtf8();
+    const QString key = QString::fromLatin1(QCryptographicHash::hash(path, QCryptographicHash::Sha1).toHex().left(16));
+    return QDir(dirPath).filePath(key + ".index");
+}
+
+quint64 PotfileIndex::headFingerprint(const QString &potfile, qint64 length)
+{
+    QFile f(potfile);
+    if (!f.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    const QByteArray head = f.read(length);
+    return HyperLogLog::hash(head.constData(), head.size());
+}
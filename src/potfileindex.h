@@ -0,0 +1,38 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef POTFILEINDEX_H
+#define POTFILEINDEX_H
+
+#include <QString>
+#include <vector>
+
+// Sorted fingerprints of the cracked hashes in a hashcat potfile. The index is kept on disk
+// and only the lines appended to the potfile since the last update are read.
+class PotfileIndex
+{
+public:
+    // hashcat.potfile next to the executable or in hashcat's profile directory, empty if there is none
+    static QString defaultPotfile(const QString &hashcatPath);
+
+    // Load the index of potfile and bring it up to date, returns false and sets error on failure.
+    // A potfile that does not exist yet is an empty index.
+    bool update(const QString &potfile, QString *error = nullptr);
+
+    bool isEmpty() const;
+    quint64 size() const;
+    // hash must be in hashcat's notation, hex fields lowercase, without username or plain
+    bool contains(const char *hash, qsizetype length) const;
+
+private:
+    struct Header;
+
+    std::vector<quint64> fingerprints;
+
+    static QString indexFile(const QString &potfile);
+    static quint64 headFingerprint(const QString &potfile, qint64 length);
+};
+
+#endif // POTFILEINDEX_H
@@ -0,0 +1,213 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "processsampler.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QThread>
+
+#if defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+struct ProcessSampler::State {
+    QElapsedTimer clock;
+    qint64 previousMs = -1;
+    quint64 previousTicks = 0;
+    qint64 previousRead = 0;
+    qint64 previousWritten = 0;
+    // CPU time of every thread at the previous sample, threads that ended are dropped
+    QHash<int, quint64> threadTicks;
+};
+
+namespace {
+
+qint64 clockTicksPerSecond()
+{
+#if defined(Q_OS_LINUX)
+    static const qint64 ticks = sysconf(_SC_CLK_TCK);
+    return ticks > 0 ? ticks : 100;
+#else
+    return 100;
+#endif
+}
+
+qint64 pageSize()
+{
+#if defined(Q_OS_LINUX)
+    static const qint64 size = sysconf(_SC_PAGESIZE);
+    return size > 0 ? size : 4096;
+#else
+    return 4096;
+#endif
+}
+
+// CPU time in clock ticks from a stat file of proc(5), for a process or one of its threads
+bool readStat(const QString &file, quint64 *ticks, int *threads = nullptr, qint64 *residentPages = nullptr)
+{
+    QFile f(file);
+    if (!f.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    // The command name in parentheses may contain spaces, the fields after it start with field 3
+    const QByteArray data = f.readAll();
+    const qsizetype end = data.lastIndexOf(')');
+    if (end < 0) {
+        return false;
+    }
+    const QList<QByteArray> fields = data.mid(end + 2).split(' ');
+    if (fields.size() < 22) {
+        return false;
+    }
+
+    // utime and stime are fields 14 and 15, num_threads is 20, rss is 24
+    *ticks = fields.at(11).toULongLong() + fields.at(12).toULongLong();
+    if (threads) {
+        *threads = fields.at(17).toInt();
+    }
+    if (residentPages) {
+        *residentPages = fields.at(21).toLongLong();
+    }
+    return true;
+}
+
+// First number after "key:" in a file like /proc/<pid>/status, -1 if it is missing
+qint64 readField(const QString &file, const QByteArray &key)
+{
+    QFile f(file);
+    if (!f.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+
+    const QList<QByteArray> lines = f.readAll().split('\n');
+    for (const QByteArray &line : lines) {
+        if (line.startsWith(key)) {
+            return line.mid(key.size()).simplified().split(' ').constFirst().toLongLong();
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
+ProcessSampler::ProcessSampler(qint64 pid, int intervalMs)
+    : pid(pid)
+    , intervalMs(intervalMs)
+{
+    thread.reset(QThread::create([this] { run(); }));
+    thread->start(QThread::LowPriority);
+}
+
+ProcessSampler::~ProcessSampler()
+{
+    {
+        QMutexLocker locker(&mutex);
+        stopping = true;
+        wake.wakeAll();
+    }
+    thread->wait();
+}
+
+bool ProcessSampler::isSupported()
+{
+#if defined(Q_OS_LINUX)
+    return QFileInfo::exists("/proc/self/stat");
+#else
+    return false;
+#endif
+}
+
+bool ProcessSampler::takeSample(ProcessSample &sample)
+{
+    // Only the latest sample is shown, older ones are skipped
+    bool taken = false;
+    while (samples.pop(sample)) {
+        taken = true;
+    }
+    return taken;
+}
+
+void ProcessSampler::run()
+{
+    State state;
+    state.clock.start();
+
+    QMutexLocker locker(&mutex);
+    while (!stopping) {
+        locker.unlock();
+        ProcessSample next;
+        if (sample(state, next)) {
+            samples.push(next);
+        }
+        locker.relock();
+
+        if (!stopping) {
+            wake.wait(&mutex, static_cast<unsigned long>(intervalMs));
+        }
+    }
+}
+
+// Rates need two samples, the first one only sets the baseline
+bool ProcessSampler::sample(State &state, ProcessSample &sample) const
+{
+    const QString base = QString("/proc/%1").arg(pid);
+
+    quint64 ticks = 0;
+    qint64 residentPages = 0;
+    if (!readStat(base + "/stat", &ticks, &sample.threads, &residentPages)) {
+        return false;
+    }
+    const qint64 now = state.clock.elapsed();
+    const double seconds = state.previousMs >= 0 ? static_cast<double>(now - state.previousMs) / 1000.0 : 0;
+    const auto percent = [seconds](quint64 delta) {
+        return 100.0 * static_cast<double>(delta) / static_cast<double>(clockTicksPerSecond()) / seconds;
+    };
+
+    QHash<int, quint64> threadTicks;
+    threadTicks.reserve(state.threadTicks.size());
+    const QStringList tasks = QDir(base + "/task").entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString &task : tasks) {
+        quint64 taskTicks = 0;
+        if (!readStat(base + "/task/" + task + "/stat", &taskTicks)) {
+            continue;
+        }
+
+        const int id = task.toInt();
+        threadTicks.insert(id, taskTicks);
+        const auto previous = state.threadTicks.constFind(id);
+        if (seconds > 0 && previous != state.threadTicks.constEnd() && taskTicks >= previous.value()) {
+            sample.busiestThreadPercent = qMax(sample.busiestThreadPercent, percent(taskTicks - previous.value()));
+        }
+    }
+
+    sample.residentBytes = residentPages * pageSize();
+    sample.swapBytes = qMax<qint64>(readField(base + "/status", "VmSwap:"), 0) * 1024;
+
+    // Readable for processes of the same user only
+    const qint64 read = readField(base + "/io", "rchar:");
+    const qint64 written = readField(base + "/io", "wchar:");
+
+    const bool complete = seconds > 0;
+    if (complete) {
+        sample.cpuPercent = percent(ticks - qMin(ticks, state.previousTicks));
+        if (read >= state.previousRead && state.previousRead >= 0) {
+            sample.readBytesPerSecond = static_cast<qint64>(static_cast<double>(read - state.previousRead) / seconds);
+        }
+        if (written >= state.previousWritten && state.previousWritten >= 0) {
+            sample.writeBytesPerSecond = static_cast<qint64>(static_cast<double>(written - state.previousWritten) / seconds);
+        }
+    }
+
+    state.previousMs = now;
+    state.previousTicks = ticks;
+    state.previousRead = read;
+    state.previousWritten = written;
+    state.threadTicks.swap(threadTicks);
+    return complete;
+}
@@ -0,0 +1,62 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef PROCESSSAMPLER_H
+#define PROCESSSAMPLER_H
+
+#include <QMutex>
+#include <QWaitCondition>
+#include <memory>
+#include "ringbuffer.h"
+
+class QThread;
+
+// Host-side resource use of a process at one point in time
+struct ProcessSample {
+    // 100 per fully used core
+    double cpuPercent = 0;
+    // A single thread at 100 % limits the process, e.g. the thread reading the wordlist
+    double busiestThreadPercent = 0;
+    int threads = 0;
+    qint64 residentBytes = 0;
+    qint64 swapBytes = 0;
+    // Bytes the process read and wrote, including what came from the page cache
+    qint64 readBytesPerSecond = 0;
+    qint64 writeBytesPerSecond = 0;
+};
+
+// Samples CPU time, memory and I/O of a process from /proc/<pid> on its own thread. The samples
+// are handed to the GUI thread through a ring buffer, so neither thread waits for the other.
+class ProcessSampler
+{
+public:
+    // Starts sampling right away
+    explicit ProcessSampler(qint64 pid, int intervalMs = 2000);
+    ~ProcessSampler();
+
+    // /proc is only available on Linux
+    static bool isSupported();
+
+    // GUI thread only, false if there is no new sample
+    bool takeSample(ProcessSample &sample);
+
+private:
+    struct State;
+
+    const qint64 pid;
+    const int intervalMs;
+
+    RingBuffer<ProcessSample, 64> samples;
+    std::unique_ptr<QThread> thread;
+    // Only wakes the thread early to stop it, samples don't go through the lock
+    QMutex mutex;
+    QWaitCondition wake;
+    bool stopping = false;
+
+    void run();
+    bool sample(State &state, ProcessSample &sample) const;
+};
+
+#endif // PROCESSSAMPLER_H
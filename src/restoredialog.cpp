@@ -0,0 +1,145 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "restoredialog.h"
+#include "ui_restoredialog.h"
+#include <QDir>
+#include <QLocale>
+#include <QMessageBox>
+
+RestoreDialog::RestoreDialog(QWidget *parent)
+    : QDialog(parent)
+    , ui(new Ui::RestoreDialog)
+{
+    ui->setupUi(this);
+
+    connect(ui->pushButton_restore, &QPushButton::clicked, this, &RestoreDialog::restoreClicked);
+    connect(ui->pushButton_delete, &QPushButton::clicked, this, &RestoreDialog::deleteClicked);
+    connect(ui->pushButton_refresh, &QPushButton::clicked, this, &RestoreDialog::refresh);
+    connect(ui->pushButton_close, &QPushButton::clicked, this, &RestoreDialog::close);
+    connect(ui->treeWidget_sessions, &QTreeWidget::itemDoubleClicked, this, &RestoreDialog::restoreClicked);
+    connect(ui->treeWidget_sessions, &QTreeWidget::itemSelectionChanged, this, [this] {
+        const bool selected = !ui->treeWidget_sessions->selectedItems().isEmpty();
+        ui->pushButton_restore->setEnabled(selected);
+        ui->pushButton_delete->setEnabled(selected);
+    });
+
+    refresh();
+}
+
+RestoreDialog::~RestoreDialog()
+{
+    delete ui;
+}
+
+void RestoreDialog::refresh()
+{
+    const QStringList directories = SessionIndex::directories();
+    if (directories.isEmpty()) {
+        ui->label_directories->setText(tr("Configure the path to the hashcat executable in the settings to find its restore files."));
+    } else {
+        QStringList native;
+        for (const QString &directory : directories) {
+            native << QDir::toNativeSeparators(directory);
+        }
+        ui->label_directories->setText(tr("Restore files in %1").arg(native.join(", ")));
+    }
+
+    sessions = SessionIndex::scan();
+    ui->treeWidget_sessions->clear();
+
+    QLocale locale;
+    for (int i = 0; i < sessions.size(); ++i) {
+        const RestoreSession &session = sessions.at(i);
+
+        QStringList progress;
+        if (!session.isValid()) {
+            progress << session.error;
+        } else {
+            const double done = session.progress();
+            if (done >= 0) {
+                progress << QString("%1%").arg(100.0 * done, 0, 'f', 1);
+            } else {
+                progress << tr("position %1").arg(locale.toString(session.position));
+            }
+            if (session.wordlistPosition > 0) {
+                progress << tr("wordlist %1").arg(session.wordlistPosition + 1);
+            }
+            if (session.maskPosition > 0) {
+                progress << tr("mask %1").arg(session.maskPosition + 1);
+            }
+            if (session.isActive()) {
+                progress << tr("may still be running");
+            }
+        }
+
+        auto *item = new QTreeWidgetItem(ui->treeWidget_sessions, {
+            session.session,
+            locale.toString(session.modified, QLocale::ShortFormat),
+            progress.join(", "),
+            session.arguments.join(" "),
+        });
+        item->setData(0, Qt::UserRole, i);
+        item->setToolTip(0, QDir::toNativeSeparators(session.file));
+        item->setToolTip(3, session.arguments.join(" "));
+    }
+
+    for (int column = 0; column < ui->treeWidget_sessions->columnCount() - 1; ++column) {
+        ui->treeWidget_sessions->resizeColumnToContents(column);
+    }
+}
+
+QList<RestoreSession> RestoreDialog::selectedSessions() const
+{
+    QList<RestoreSession> result;
+    const QList<QTreeWidgetItem *> items = ui->treeWidget_sessions->selectedItems();
+    for (const QTreeWidgetItem *item : items) {
+        result << sessions.at(item->data(0, Qt::UserRole).toInt());
+    }
+    return result;
+}
+
+// hashcat refuses to restore a session that is still running, no need to check here
+void RestoreDialog::restoreClicked()
+{
+    QStringList invalid;
+    for (const RestoreSession &session : selectedSessions()) {
+        if (session.isValid()) {
+            emit restoreRequested(session);
+        } else {
+            invalid << session.error;
+        }
+    }
+
+    if (!invalid.isEmpty()) {
+        QMessageBox::warning(this, tr("Interrupted sessions"), invalid.join('\n'));
+    }
+}
+
+void RestoreDialog::deleteClicked()
+{
+    const QList<RestoreSession> selected = selectedSessions();
+    if (selected.isEmpty()) {
+        return;
+    }
+
+    const QString question = tr("Delete the restore files of %n session(s)? They can't be continued afterwards.", nullptr, static_cast<int>(selected.size()));
+    if (QMessageBox::question(this, tr("Interrupted sessions"), question) != QMessageBox::Yes) {
+        return;
+    }
+
+    QStringList errors;
+    for (const RestoreSession &session : selected) {
+        QString error;
+        if (!SessionIndex::remove(session, &error)) {
+            errors << error;
+        }
+    }
+    if (!errors.isEmpty()) {
+        QMessageBox::warning(this, tr("Interrupted sessions"), errors.join('\n'));
+    }
+
+    refresh();
+}
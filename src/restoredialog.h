@@ -0,0 +1,42 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef RESTOREDIALOG_H
+#define RESTOREDIALOG_H
+
+#include <QDialog>
+#include "sessionindex.h"
+
+namespace Ui {
+    class RestoreDialog;
+}
+
+// Lists the sessions hashcat left .restore files for and continues them where they stopped
+class RestoreDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit RestoreDialog(QWidget *parent = nullptr);
+    ~RestoreDialog();
+
+public slots:
+    void refresh();
+
+signals:
+    void restoreRequested(const RestoreSession &session);
+
+private slots:
+    void restoreClicked();
+    void deleteClicked();
+
+private:
+    Ui::RestoreDialog *ui;
+    QList<RestoreSession> sessions;
+
+    QList<RestoreSession> selectedSessions() const;
+};
+
+#endif // RESTOREDIALOG_H
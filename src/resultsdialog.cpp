@@ -0,0 +1,102 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "resultsdialog.h"
+#include "ui_resultsdialog.h"
+#include <QApplication>
+#include <QClipboard>
+#include <QDir>
+#include <QFileInfo>
+#include <QHeaderView>
+#include <QLocale>
+#include <algorithm>
+
+ResultsDialog::ResultsDialog(QWidget *parent)
+    : QDialog(parent)
+    , ui(new Ui::ResultsDialog)
+    , model(new CrackedResultModel(this))
+    , tailer(new OutfileTailer(this))
+{
+    ui->setupUi(this);
+
+    // Fixed row heights and no measuring of contents keep the view fast with millions of rows
+    ui->tableView_results->setModel(model);
+    ui->tableView_results->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    ui->tableView_results->verticalHeader()->setDefaultSectionSize(ui->tableView_results->fontMetrics().height() + 6);
+    ui->tableView_results->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+    ui->tableView_results->horizontalHeader()->setDefaultSectionSize(200);
+
+    connect(tailer, &OutfileTailer::linesRead, this, &ResultsDialog::linesRead);
+    connect(tailer, &OutfileTailer::restarted, model, &CrackedResultModel::clear);
+    connect(ui->pushButton_copy, &QPushButton::clicked, this, &ResultsDialog::copyClicked);
+    connect(ui->pushButton_close, &QPushButton::clicked, this, &ResultsDialog::close);
+
+    // The rate drops without new results, so it is refreshed regularly
+    statusTimer.setInterval(1000);
+    connect(&statusTimer, &QTimer::timeout, this, &ResultsDialog::updateStatus);
+    statusTimer.start();
+
+    updateStatus();
+}
+
+ResultsDialog::~ResultsDialog()
+{
+    delete ui;
+}
+
+void ResultsDialog::setOutfile(const QString &outfile, const QString &format)
+{
+    // Reading the file again would only produce the same rows
+    if (outfile == tailer->file() && format == outfileFormat) {
+        return;
+    }
+
+    outfileFormat = format;
+    ui->label_outfile->setText(QDir::toNativeSeparators(outfile));
+    model->setFormat(format);
+    tailer->setFile(outfile);
+    updateStatus();
+}
+
+void ResultsDialog::linesRead(const QByteArray &lines, bool appended)
+{
+    model->appendLines(lines, appended);
+
+    if (appended && ui->checkBox_follow->isChecked()) {
+        ui->tableView_results->scrollToBottom();
+    }
+    updateStatus();
+}
+
+void ResultsDialog::copyClicked()
+{
+    QModelIndexList rows = ui->tableView_results->selectionModel()->selectedRows();
+    std::sort(rows.begin(), rows.end());
+
+    QStringList lines;
+    for (const QModelIndex &index : std::as_const(rows)) {
+        lines << QString::fromUtf8(model->line(index.row()));
+    }
+    if (!lines.isEmpty()) {
+        QApplication::clipboard()->setText(lines.join('\n'));
+    }
+}
+
+void ResultsDialog::updateStatus()
+{
+    QLocale locale;
+
+    if (tailer->file().isEmpty()) {
+        ui->label_status->setText(tr("No outfile, enable \"Write recovered hashes to file\" to follow the results."));
+        return;
+    }
+    if (!QFileInfo::exists(tailer->file())) {
+        ui->label_status->setText(tr("Waiting for hashcat to write the first result..."));
+        return;
+    }
+
+    ui->label_status->setText(tr("%1 results, %2 cracks per minute")
+                                  .arg(locale.toString(model->rowCount()), locale.toString(model->cracksPerMinute())));
+}
@@ -0,0 +1,43 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef RESULTSDIALOG_H
+#define RESULTSDIALOG_H
+
+#include <QDialog>
+#include <QTimer>
+#include "crackedresultmodel.h"
+#include "outfiletailer.h"
+
+namespace Ui {
+    class ResultsDialog;
+}
+
+// Shows the results hashcat writes to the outfile while it is cracking
+class ResultsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit ResultsDialog(QWidget *parent = nullptr);
+    ~ResultsDialog();
+
+    // format is the text of --outfile-format
+    void setOutfile(const QString &outfile, const QString &format);
+
+private slots:
+    void linesRead(const QByteArray &lines, bool appended);
+    void copyClicked();
+    void updateStatus();
+
+private:
+    Ui::ResultsDialog *ui;
+    CrackedResultModel *model;
+    OutfileTailer *tailer;
+    QString outfileFormat;
+    QTimer statusTimer;
+};
+
+#endif // RESULTSDIALOG_H
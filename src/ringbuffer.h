@@ -0,0 +1,55 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Fixed-size queue between one producer thread and one consumer thread. Neither side locks or
+// allocates, a producer that is ahead of the consumer by Capacity values drops the new ones.
+template <typename T, std::size_t Capacity>
+class RingBuffer
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // Producer thread only, false if the buffer is full
+    bool push(const T &value)
+    {
+        const std::size_t head = this->head.load(std::memory_order_relaxed);
+        if (head - tail.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+
+        slots[head & (Capacity - 1)] = value;
+        this->head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer thread only, false if the buffer is empty
+    bool pop(T &value)
+    {
+        const std::size_t tail = this->tail.load(std::memory_order_relaxed);
+        if (head.load(std::memory_order_acquire) == tail) {
+            return false;
+        }
+
+        value = slots[tail & (Capacity - 1)];
+        this->tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::array<T, Capacity> slots {};
+    // Counters only grow, their difference is the number of values in the buffer.
+    // Each one is written by one side only and gets its own cache line.
+    alignas(64) std::atomic<std::size_t> head { 0 };
+    alignas(64) std::atomic<std::size_t> tail { 0 };
+};
+
+#endif // RINGBUFFER_H
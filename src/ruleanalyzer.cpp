@@ -0,0 +1,337 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "ruleanalyzer.h"
+#include "hyperloglog.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSet>
+#include <QtConcurrent>
+
+struct RuleAnalyzer::ChunkResult {
+    quint64 lines = 0;
+    quint64 rules = 0;
+    quint64 invalid = 0;
+    // Line numbers are relative to the chunk
+    QList<QPair<quint64, QString>> samples;
+    // Hashes of the rules, a collision only miscounts a duplicate
+    QSet<quint64> functions;
+    QSet<quint64> canonical;
+    bool failed = false;
+};
+
+namespace {
+
+QString tr(const char *text)
+{
+    return QCoreApplication::translate("RuleAnalyzer", text);
+}
+
+// Arguments of a function: N is a position 0-9 or A-Z, X any character. Returns nullptr for unknown
+// functions. The functions that reject or memorize words only run on the CPU.
+const char *functionArguments(char function, bool *gpu)
+{
+    *gpu = true;
+
+    switch (function) {
+    case ':': case 'l': case 'u': case 'c': case 'C': case 't': case 'r': case 'd': case 'f':
+    case '{': case '}': case '[': case ']': case 'q': case 'k': case 'K': case 'E':
+        return "";
+    case 'T': case 'p': case 'D': case '\'': case 'z': case 'Z': case 'L': case 'R':
+    case '+': case '-': case '.': case ',': case 'y': case 'Y':
+        return "N";
+    case '$': case '^': case '@': case 'e':
+        return "X";
+    case 'x': case 'O': case '*':
+        return "NN";
+    case 'i': case 'o': case '3':
+        return "NX";
+    case 's':
+        return "XX";
+    }
+
+    *gpu = false;
+
+    switch (function) {
+    case 'Q': case '4': case '6': case 'M':
+        return "";
+    case '<': case '>': case '_':
+        return "N";
+    case '!': case '/': case '(': case ')':
+        return "X";
+    case '=': case '%':
+        return "NX";
+    case 'X':
+        return "NNN";
+    }
+
+    return nullptr;
+}
+
+bool isPosition(char c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z');
+}
+
+// Functions that only change the case of letters
+bool changesCase(const QByteArray &function)
+{
+    return QByteArray("lucCtTE").contains(function.at(0));
+}
+
+// Functions that set the case of every letter, whatever it was before
+bool setsCase(const QByteArray &function)
+{
+    return QByteArray("lucCE").contains(function.at(0));
+}
+
+// Functions that undo the previous one, words at the maximum length aside
+bool undoes(const QByteArray &previous, const QByteArray &function)
+{
+    switch (function.at(0)) {
+    case 't': case 'T': case 'r': case 'k': case 'K':
+        return previous == function;
+    case '{':
+        return previous == "}";
+    case '}':
+        return previous == "{";
+    case ']':
+        return previous.at(0) == '$';
+    case '[':
+        return previous.at(0) == '^';
+    }
+    return false;
+}
+
+} // namespace
+
+bool RuleAnalyzer::isComment(const char *line, qsizetype length)
+{
+    return length == 0 || line[0] == '#';
+}
+
+bool RuleAnalyzer::parseRule(const char *rule, qsizetype length, QByteArray *functions, QByteArray *canonical, QString *error)
+{
+    functions->clear();
+    canonical->clear();
+
+    // Reduced as it is parsed, a function that cancels the last one removes it
+    QList<QByteArray> reduced;
+    int count = 0;
+
+    qsizetype i = 0;
+    while (i < length) {
+        const char c = rule[i];
+        // Spaces only separate functions, arguments may still be spaces
+        if (c == ' ') {
+            ++i;
+            continue;
+        }
+
+        bool gpu = true;
+        const char *arguments = functionArguments(c, &gpu);
+        if (!arguments) {
+            *error = tr("Unknown function '%1'").arg(QChar::fromLatin1(c));
+            return false;
+        }
+        if (!gpu) {
+            *error = tr("'%1' is not supported on the GPU, hashcat only takes it with -j and -k").arg(QChar::fromLatin1(c));
+            return false;
+        }
+
+        const qsizetype argumentCount = static_cast<qsizetype>(qstrlen(arguments));
+        if (i + argumentCount >= length) {
+            *error = tr("'%1' is missing an argument").arg(QChar::fromLatin1(c));
+            return false;
+        }
+        for (qsizetype a = 0; a < argumentCount; ++a) {
+            if (arguments[a] == 'N' && !isPosition(rule[i + 1 + a])) {
+                *error = tr("'%1' takes a position 0-9 or A-Z, not '%2'").arg(QChar::fromLatin1(c), QChar::fromLatin1(rule[i + 1 + a]));
+                return false;
+            }
+        }
+
+        const QByteArray function(rule + i, argumentCount + 1);
+        i += argumentCount + 1;
+
+        if (++count > maxFunctions) {
+            *error = tr("More than %1 functions").arg(maxFunctions);
+            return false;
+        }
+        functions->append(function);
+
+        if (c == ':') {
+            continue;
+        }
+        if (setsCase(function)) {
+            while (!reduced.isEmpty() && changesCase(reduced.constLast())) {
+                reduced.removeLast();
+            }
+        } else if (!reduced.isEmpty() && undoes(reduced.constLast(), function)) {
+            reduced.removeLast();
+            continue;
+        }
+        reduced.append(function);
+    }
+
+    // Every function has a fixed length, joined they are still unambiguous
+    for (const QByteArray &function : std::as_const(reduced)) {
+        canonical->append(function);
+    }
+    return true;
+}
+
+RuleFileStats RuleAnalyzer::analyze(const QString &file)
+{
+    RuleFileStats stats;
+    stats.file = file;
+
+    const QFileInfo info(file);
+    if (!info.isFile()) {
+        stats.error = tr("%1 does not exist.").arg(file);
+        return stats;
+    }
+    stats.size = info.size();
+    stats.lastModified = info.lastModified().toMSecsSinceEpoch();
+
+    // Ordered, so the line numbers of the samples can be made absolute
+    const QList<FileChunks::Chunk> chunks = FileChunks::split(file, stats.size, chunkSize);
+    const ChunkResult total = QtConcurrent::blockingMappedReduced<ChunkResult>(
+        chunks, &RuleAnalyzer::analyzeChunk,
+        [](ChunkResult &result, const ChunkResult &chunk) {
+            for (const auto &sample : chunk.samples) {
+                if (result.samples.size() < maxSamples) {
+                    result.samples.append({ result.lines + sample.first, sample.second });
+                }
+            }
+            result.lines += chunk.lines;
+            result.rules += chunk.rules;
+            result.invalid += chunk.invalid;
+            result.functions.unite(chunk.functions);
+            result.canonical.unite(chunk.canonical);
+            result.failed |= chunk.failed;
+        },
+        QtConcurrent::OrderedReduce);
+
+    if (total.failed) {
+        stats.error = tr("Could not read %1.").arg(file);
+        return stats;
+    }
+
+    stats.rules = total.rules;
+    stats.invalid = total.invalid;
+    stats.duplicates = total.rules - static_cast<quint64>(total.functions.size());
+    stats.equivalent = static_cast<quint64>(total.functions.size() - total.canonical.size());
+    stats.samples = total.samples;
+    return stats;
+}
+
+RuleAnalyzer::ChunkResult RuleAnalyzer::analyzeChunk(const FileChunks::Chunk &chunk)
+{
+    ChunkResult result;
+    QByteArray functions;
+    QByteArray canonical;
+    QString error;
+
+    result.failed = !FileChunks::forEachLine(chunk, [&](const char *line, qsizetype length) {
+        ++result.lines;
+        if (isComment(line, length)) {
+            return;
+        }
+
+        if (!parseRule(line, length, &functions, &canonical, &error)) {
+            ++result.invalid;
+            if (result.samples.size() < maxSamples) {
+                result.samples.append({ result.lines, error });
+            }
+            return;
+        }
+
+        ++result.rules;
+        result.functions.insert(HyperLogLog::hash(functions.constData(), functions.size()));
+        result.canonical.insert(HyperLogLog::hash(canonical.constData(), canonical.size()));
+    });
+
+    return result;
+}
+
+RuleFileStats RuleAnalyzer::optimize(const QString &input, const QString &output)
+{
+    RuleFileStats stats;
+    stats.file = output;
+
+    QFile in(input);
+    if (!in.open(QIODevice::ReadOnly)) {
+        stats.error = tr("Could not read %1.").arg(input);
+        return stats;
+    }
+
+    // Written to a temporary file that only replaces output once all rules are in it,
+    // so output may be the input itself
+    QSaveFile out(output);
+    if (!out.open(QIODevice::WriteOnly)) {
+        stats.error = tr("Could not write %1.").arg(output);
+        return stats;
+    }
+
+    // Kept exactly, the file is written from them
+    QSet<QByteArray> seenFunctions;
+    QSet<QByteArray> seenCanonical;
+    QByteArray functions;
+    QByteArray canonical;
+    QString error;
+    quint64 lineNumber = 0;
+
+    while (!in.atEnd()) {
+        QByteArray line = in.readLine();
+        ++lineNumber;
+        while (line.endsWith('\n') || line.endsWith('\r')) {
+            line.chop(1);
+        }
+
+        if (!isComment(line.constData(), line.size())) {
+            if (!parseRule(line.constData(), line.size(), &functions, &canonical, &error)) {
+                ++stats.invalid;
+                if (stats.samples.size() < maxSamples) {
+                    stats.samples.append({ lineNumber, error });
+                }
+                continue;
+            }
+
+            ++stats.rules;
+            if (seenFunctions.contains(functions)) {
+                ++stats.duplicates;
+                continue;
+            }
+            seenFunctions.insert(functions);
+            if (seenCanonical.contains(canonical)) {
+                ++stats.equivalent;
+                continue;
+            }
+            seenCanonical.insert(canonical);
+        }
+
+        line += '\n';
+        if (out.write(line) != line.size()) {
+            out.cancelWriting();
+            stats.error = tr("Could not write %1.").arg(output);
+            return stats;
+        }
+    }
+
+    // Windows can't replace a file that is still open
+    in.close();
+    if (!out.commit()) {
+        stats.error = tr("Could not write %1.").arg(output);
+        return stats;
+    }
+
+    const QFileInfo info(output);
+    stats.size = info.size();
+    stats.lastModified = info.lastModified().toMSecsSinceEpoch();
+    return stats;
+}
@@ -0,0 +1,66 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef RULEANALYZER_H
+#define RULEANALYZER_H
+
+#include <QByteArray>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include "filechunks.h"
+
+struct RuleFileStats {
+    QString file;
+    qint64 size = -1;
+    qint64 lastModified = 0;
+
+    // Rules hashcat loads, duplicates included
+    quint64 rules = 0;
+    // Skipped by hashcat with a warning
+    quint64 invalid = 0;
+    // The same functions as an earlier rule, spaces aside
+    quint64 duplicates = 0;
+    // Other functions with the same effect as an earlier rule, e.g. "t t" and ":"
+    quint64 equivalent = 0;
+    // Line numbers and errors of the first invalid rules
+    QList<QPair<quint64, QString>> samples;
+    QString error;
+
+    quint64 unique() const { return rules - duplicates - equivalent; }
+};
+
+// Checks hashcat rules locally against the functions the GPU kernels support. Rules with the same
+// effect are found by reducing them to a canonical form: no-ops are dropped, functions that undo each
+// other cancel out and case changes are dropped if a later function sets the case of every letter.
+class RuleAnalyzer
+{
+public:
+    // hashcat's limit for rules that run on the GPU
+    static constexpr int maxFunctions = 31;
+    static constexpr int maxSamples = 5;
+
+    // Empty lines and lines starting with # are skipped by hashcat
+    static bool isComment(const char *line, qsizetype length);
+    // Returns false for invalid rules, with the reason in error. functions is the rule without
+    // spaces, canonical is the same for rules with the same effect and empty for no-ops.
+    static bool parseRule(const char *rule, qsizetype length, QByteArray *functions, QByteArray *canonical, QString *error);
+
+    // Chunks of the file are parsed in parallel
+    static RuleFileStats analyze(const QString &file);
+    // Writes the rules of input to output without invalid rules and duplicates, the first of
+    // equivalent rules is kept. Comments are kept as well. output may be the same file as input.
+    static RuleFileStats optimize(const QString &input, const QString &output);
+
+private:
+    struct ChunkResult;
+
+    // Rules files are small, small chunks still keep every core busy
+    static constexpr qint64 chunkSize = 1024 * 1024;
+
+    static ChunkResult analyzeChunk(const FileChunks::Chunk &chunk);
+};
+
+#endif // RULEANALYZER_H
@@ -0,0 +1,267 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "rulesfilemodel.h"
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QLocale>
+#include <QtConcurrent>
+#include <limits>
+
+RulesFileModel::RulesFileModel(QObject *parent)
+    : FileListModel(parent)
+{
+}
+
+int RulesFileModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : entries.size();
+}
+
+int RulesFileModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant RulesFileModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= entries.size()) {
+        return QVariant();
+    }
+
+    const RulesFile &r = entries.at(index.row());
+    static const RuleFileStats unanalyzed;
+    const auto it = cache.constFind(r.value);
+    const RuleFileStats &stats = it != cache.constEnd() ? it.value() : unanalyzed;
+
+    if (index.column() == ColumnPath) {
+        switch (role) {
+        case Qt::DisplayRole:
+        case Qt::EditRole:
+            return r.value;
+        case Qt::ToolTipRole:
+            return stats.error.isEmpty() ? r.value : stats.error;
+        case Qt::CheckStateRole:
+            return r.enabled ? Qt::Checked : Qt::Unchecked;
+        }
+        return QVariant();
+    }
+
+    if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignRight | Qt::AlignVCenter);
+    }
+    if ((role != Qt::DisplayRole && role != Qt::ToolTipRole) || stats.size < 0) {
+        return QVariant();
+    }
+
+    QLocale locale;
+
+    switch (index.column()) {
+    case ColumnRules:
+        return locale.toString(stats.rules);
+    case ColumnInvalid:
+        if (role == Qt::ToolTipRole) {
+            QStringList samples;
+            for (const auto &sample : stats.samples) {
+                samples << tr("Line %1: %2").arg(sample.first).arg(sample.second);
+            }
+            return samples.join('\n');
+        }
+        return locale.toString(stats.invalid);
+    case ColumnDuplicates:
+        if (role == Qt::ToolTipRole) {
+            return tr("%1 identical, %2 with the same effect as an earlier rule")
+                .arg(locale.toString(stats.duplicates), locale.toString(stats.equivalent));
+        }
+        return locale.toString(stats.duplicates + stats.equivalent);
+    }
+
+    return QVariant();
+}
+
+QVariant RulesFileModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return FileListModel::headerData(section, orientation, role);
+    }
+
+    switch (section) {
+    case ColumnPath:
+        return tr("Rules file");
+    case ColumnRules:
+        return tr("Rules");
+    case ColumnInvalid:
+        return tr("Invalid");
+    case ColumnDuplicates:
+        return tr("Duplicates");
+    }
+
+    return QVariant();
+}
+
+bool RulesFileModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (!index.isValid() || role != Qt::CheckStateRole || index.column() != ColumnPath || index.row() >= entries.size()) {
+        return false;
+    }
+
+    RulesFile &r = entries[index.row()];
+    const bool state = value.toInt() == Qt::Checked;
+    if (r.enabled != state) {
+        r.enabled = state;
+        emit dataChanged(index, index, { Qt::CheckStateRole });
+    }
+    return true;
+}
+
+Qt::ItemFlags RulesFileModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid()) {
+        return Qt::ItemIsDropEnabled;
+    }
+    if (index.column() == ColumnPath) {
+        return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsUserCheckable;
+    }
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
+
+void RulesFileModel::addDroppedPaths(const QStringList &paths)
+{
+    QStringList files;
+    for (const QString &path : paths) {
+        if (QFileInfo(path).isFile()) {
+            files << path;
+        }
+    }
+
+    addFiles(files);
+}
+
+void RulesFileModel::addFiles(const QStringList &files, bool enabled)
+{
+    QList<RulesFile> added;
+    QStringList paths;
+    for (const QString &file : files) {
+        if (!file.isEmpty()) {
+            added.append({ enabled, file });
+            paths << file;
+        }
+    }
+
+    if (added.isEmpty()) {
+        return;
+    }
+
+    beginInsertRows(QModelIndex(), entries.size(), entries.size() + added.size() - 1);
+    entries.append(added);
+    endInsertRows();
+
+    analyze(paths);
+}
+
+void RulesFileModel::removeRulesFiles(QList<int> rows)
+{
+    removeListRows(entries, std::move(rows));
+}
+
+void RulesFileModel::moveRulesFile(int row, int delta)
+{
+    moveListRow(entries, row, delta);
+}
+
+void RulesFileModel::replaceFile(const QString &file, const QString &replacement)
+{
+    for (int row = 0; row < entries.size(); ++row) {
+        if (entries.at(row).value == file) {
+            entries[row].value = replacement;
+            emit dataChanged(index(row, ColumnPath), index(row, ColumnCount - 1), { Qt::DisplayRole, Qt::EditRole });
+        }
+    }
+    analyze({ replacement });
+}
+
+const QList<RulesFileModel::RulesFile> &RulesFileModel::rulesFiles() const
+{
+    return entries;
+}
+
+void RulesFileModel::setRulesFiles(const QList<RulesFile> &rulesFiles)
+{
+    beginResetModel();
+    entries.clear();
+    for (const RulesFile &r : rulesFiles) {
+        if (!r.value.isEmpty()) {
+            entries.append(r);
+        }
+    }
+    endResetModel();
+
+    QStringList files;
+    for (const RulesFile &r : std::as_const(entries)) {
+        files << r.value;
+    }
+    analyze(files);
+}
+
+RuleFileStats RulesFileModel::stats(const QString &file) const
+{
+    return cache.value(file);
+}
+
+bool RulesFileModel::isAnalyzing() const
+{
+    for (const RulesFile &r : entries) {
+        if (r.enabled && analyzing.contains(r.value)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+Keyspace RulesFileModel::candidatesPerWord(bool unique) const
+{
+    Keyspace candidates(1);
+    for (const RulesFile &r : entries) {
+        if (!r.enabled) {
+            continue;
+        }
+        const RuleFileStats stats = cache.value(r.value);
+        const quint64 rules = unique ? stats.unique() : stats.rules;
+        candidates.multiply(static_cast<quint32>(qMin<quint64>(rules, std::numeric_limits<quint32>::max())));
+    }
+    return candidates;
+}
+
+// Unchanged files are not analyzed again, every file is parsed by its own task
+void RulesFileModel::analyze(const QStringList &files)
+{
+    for (const QString &file : files) {
+        if (analyzing.contains(file)) {
+            continue;
+        }
+
+        const QFileInfo info(file);
+        auto it = cache.constFind(file);
+        if (it != cache.constEnd() && it->size == info.size() && it->lastModified == info.lastModified().toMSecsSinceEpoch()) {
+            continue;
+        }
+
+        analyzing.insert(file);
+        auto *watcher = new QFutureWatcher<RuleFileStats>(this);
+        connect(watcher, &QFutureWatcher<RuleFileStats>::finished, this, [this, watcher, file] {
+            watcher->deleteLater();
+            analyzing.remove(file);
+            cache.insert(file, watcher->result());
+
+            for (int row = 0; row < entries.size(); ++row) {
+                if (entries.at(row).value == file) {
+                    emit dataChanged(index(row, ColumnPath), index(row, ColumnCount - 1), { Qt::DisplayRole, Qt::ToolTipRole });
+                }
+            }
+            emit analyzed(file);
+        });
+        watcher->setFuture(QtConcurrent::run(&RuleAnalyzer::analyze, file));
+    }
+}
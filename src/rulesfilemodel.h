@@ -0,0 +1,77 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef RULESFILEMODEL_H
+#define RULESFILEMODEL_H
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QStringList>
+#include "attackspec.h"
+#include "listmodel.h"
+#include "maskparser.h"
+#include "ruleanalyzer.h"
+
+// The stacked rules files of an attack. Every file is analyzed in the background as it is added,
+// the same file may be stacked more than once.
+class RulesFileModel : public FileListModel
+{
+    Q_OBJECT
+
+public:
+    enum Column
+    {
+        ColumnPath,
+        ColumnRules,
+        ColumnInvalid,
+        ColumnDuplicates,
+        ColumnCount
+    };
+
+    using RulesFile = AttackSpec::Option;
+
+    explicit RulesFileModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+    void addFiles(const QStringList &files, bool enabled = true);
+    void removeRulesFiles(QList<int> rows);
+    void moveRulesFile(int row, int delta);
+    // Every row with file gets replacement instead, e.g. after duplicates were removed
+    void replaceFile(const QString &file, const QString &replacement);
+
+    const QList<RulesFile> &rulesFiles() const;
+    void setRulesFiles(const QList<RulesFile> &rulesFiles);
+
+    // Invalid until the file was analyzed
+    RuleFileStats stats(const QString &file) const;
+    // True while one of the enabled files is not analyzed yet
+    bool isAnalyzing() const;
+    // Rules hashcat applies to every word, the product of the rules of the enabled files.
+    // With unique the duplicates are left out.
+    Keyspace candidatesPerWord(bool unique = false) const;
+
+signals:
+    void analyzed(const QString &file);
+
+protected:
+    // Dropped folders are skipped, rules files are picked one by one
+    void addDroppedPaths(const QStringList &paths) override;
+
+private:
+    QList<RulesFile> entries;
+    QHash<QString, RuleFileStats> cache;
+    QSet<QString> analyzing;
+
+    void analyze(const QStringList &files);
+};
+
+#endif // RULESFILEMODEL_H
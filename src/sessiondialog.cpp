@@ -0,0 +1,491 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "sessiondialog.h"
+#include "ui_sessiondialog.h"
+#include "helperutils.h"
+#include "hyperloglog.h"
+#include "keyspaceslicer.h"
+#include "sessionindex.h"
+#include "settingsmanager.h"
+#include <QCloseEvent>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QLocale>
+#include <QMessageBox>
+
+// Seconds between two status updates from hashcat
+static constexpr int statusTimerSeconds = 2;
+// A thread this busy while the devices wait for work is the bottleneck
+static constexpr double saturatedThreadPercent = 95;
+static constexpr int idleUtilizationPercent = 90;
+// Results read from a part file per status update, so a slice that cracks a lot can't stall the window
+static constexpr qint64 maxResultsRead = 8 * 1024 * 1024;
+
+SessionDialog::SessionDialog(QWidget *parent)
+    : QDialog(parent)
+    , ui(new Ui::SessionDialog)
+{
+    ui->setupUi(this);
+
+    // Only the tail of the output is kept, the process may run for days
+    ui->plainTextEdit_output->setMaximumBlockCount(1000);
+
+    connect(ui->pushButton_stop, &QPushButton::clicked, this, &SessionDialog::stopClicked);
+    connect(ui->pushButton_close, &QPushButton::clicked, this, &SessionDialog::close);
+
+    // Host resources are read from /proc
+    ui->groupBox_resources->setVisible(ProcessSampler::isSupported());
+    resourceTimer.setInterval(1000);
+    connect(&resourceTimer, &QTimer::timeout, this, &SessionDialog::updateResources);
+}
+
+SessionDialog::~SessionDialog()
+{
+    delete ui;
+}
+
+void SessionDialog::start(const QStringList &arguments)
+{
+    startProcesses({arguments});
+}
+
+void SessionDialog::startSliced(const QStringList &arguments, const QStringList &keyspaceArguments,
+                                const QStringList &deviceGroups, const QList<double> &weights, const QString &cpuAffinity,
+                                quint64 skip, quint64 limit, const QString &outfile)
+{
+    ui->label_status_value->setText(tr("Calculating keyspace..."));
+    ui->pushButton_stop->setEnabled(true);
+
+    QStringList args = keyspaceArguments;
+    args << HelperUtils::getParameter(HelperUtils::Parameter::Keyspace);
+    ui->plainTextEdit_output->appendPlainText("hashcat " + args.join(" "));
+
+    keyspaceRunner = HashcatRunner::run(args, this);
+    connect(keyspaceRunner, &HashcatRunner::finished, this,
+            [this, arguments, deviceGroups, weights, cpuAffinity, skip, limit, outfile](const HashcatResult &result) {
+        const quint64 keyspace = KeyspaceSlicer::parseKeyspace(result.standardOutput);
+        keyspaceRunner.clear();
+
+        if (result.exitStatus != QProcess::NormalExit || result.exitCode != 0 || keyspace == 0 || skip >= keyspace) {
+            ui->pushButton_stop->setEnabled(false);
+            if (keyspace > 0) {
+                ui->label_status_value->setText(tr("Skip is beyond the keyspace of %1").arg(keyspace));
+            } else {
+                ui->label_status_value->setText(tr("Failed to calculate the keyspace"));
+                ui->plainTextEdit_output->appendPlainText(result.standardError);
+            }
+
+            if (closeWhenFinished) {
+                close();
+            }
+            return;
+        }
+
+        const quint64 rangeLimit = (limit == 0 || limit > keyspace - skip) ? keyspace - skip : limit;
+        const QList<KeyspaceSlice> slices = KeyspaceSlicer::split(skip, rangeLimit, deviceGroups, weights, cpuAffinity);
+        // Every slice gets its own .restore file, named after the session of the attack
+        QString session = HelperUtils::parameterValue(arguments, HelperUtils::Parameter::Session);
+        if (session.isEmpty()) {
+            session = SessionIndex::newSession();
+        }
+
+        // hashcat runs in its own directory, a relative outfile ends up there
+        const QDir hashcatDir = QFileInfo(SettingsManager::instance().getKey<QString>("hashcatPath")).absoluteDir();
+        this->outfile = outfile.isEmpty() ? QString() : hashcatDir.absoluteFilePath(outfile);
+        QList<QStringList> argumentSets;
+        QStringList partFiles;
+
+        for (int i = 0; i < slices.size(); ++i) {
+            const QString partFile = this->outfile.isEmpty() ? QString() : QString("%1.part%2").arg(this->outfile).arg(i + 1);
+            argumentSets << KeyspaceSlicer::sliceArguments(arguments, slices.at(i), QString("%1-%2").arg(session).arg(i + 1), partFile);
+            partFiles << partFile;
+        }
+
+        ui->plainTextEdit_output->appendPlainText(tr("Keyspace %1 split into %2 slices").arg(keyspace).arg(slices.size()));
+        startProcesses(argumentSets, partFiles);
+    });
+}
+
+void SessionDialog::startProcesses(const QList<QStringList> &argumentSets, const QStringList &partFiles)
+{
+    ui->pushButton_stop->setEnabled(true);
+    ui->label_status_value->setText(tr("Starting..."));
+
+    for (int i = 0; i < argumentSets.size(); ++i) {
+        QStringList args = argumentSets.at(i);
+        args << HelperUtils::getParameter(HelperUtils::Parameter::Status)
+             << HelperUtils::getParameter(HelperUtils::Parameter::StatusJson)
+             << HelperUtils::getParameter(HelperUtils::Parameter::StatusTimer) << QString::number(statusTimerSeconds);
+
+        const int index = processes.size();
+        Process process;
+        process.runner = new HashcatRunner(this);
+        process.outfile = partFiles.value(i);
+        processes.append(process);
+
+        HashcatRunner *runner = process.runner;
+        runner->setCaptureLimit(64 * 1024);
+        connect(runner, &HashcatRunner::standardOutputLine, this, [this, index](const QByteArray &line) { outputLineReceived(index, line); });
+        connect(runner, &HashcatRunner::standardErrorLine, this, [this, index](const QByteArray &line) { outputLineReceived(index, line); });
+        connect(runner, &HashcatRunner::finished, this, [this, index](const HashcatResult &result) { processFinished(index, result); });
+        if (ProcessSampler::isSupported()) {
+            connect(runner, &HashcatRunner::started, this, [this, index] {
+                Process &process = processes[index];
+                process.sampler.reset(new ProcessSampler(process.runner->processId(), statusTimerSeconds * 1000));
+                resourceTimer.start();
+            });
+        }
+
+        ui->plainTextEdit_output->appendPlainText("hashcat " + args.join(" "));
+        runner->start(args);
+    }
+}
+
+bool SessionDialog::isRunning() const
+{
+    if (keyspaceRunner) {
+        return true;
+    }
+
+    for (const Process &process : processes) {
+        if (!process.finished) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SessionDialog::stopClicked()
+{
+    ui->pushButton_stop->setEnabled(false);
+    ui->label_status_value->setText(tr("Stopping..."));
+
+    if (keyspaceRunner) {
+        keyspaceRunner->cancel();
+    }
+
+    for (const Process &process : std::as_const(processes)) {
+        process.runner->cancel();
+    }
+}
+
+void SessionDialog::closeEvent(QCloseEvent *event)
+{
+    if (!isRunning()) {
+        event->accept();
+        return;
+    }
+
+    QMessageBox::StandardButton answer = QMessageBox::question(this, tr("Session running"),
+                                                               tr("hashcat is still running. Stop the session?"));
+    if (answer == QMessageBox::Yes) {
+        // Close once hashcat had the chance to shut down cleanly
+        closeWhenFinished = true;
+        stopClicked();
+    }
+    event->ignore();
+}
+
+void SessionDialog::outputLineReceived(int index, const QByteArray &line)
+{
+    HashcatStatus status;
+    if (HashcatStatus::fromJson(line, status)) {
+        Process &process = processes[index];
+
+        // Hashes already in the potfile are reported as recovered by every process
+        if (!process.hasStatus) {
+            process.initialRecovered = status.recoveredDone;
+            process.hasStatus = true;
+        }
+        process.status = status;
+
+        // Kept per device, the table rows change when a slice finishes
+        for (const HashcatDeviceStatus &device : std::as_const(status.devices)) {
+            DeviceHistory &history = deviceHistories[QString("%1:%2").arg(index).arg(device.id)];
+            history.speed.append(static_cast<double>(device.speed));
+            history.temperature.append(qMax(device.temperature, 0));
+            history.utilization.append(qMax(device.utilization, 0));
+        }
+        updateStatus();
+        collectResults(index, false);
+    } else if (!line.isEmpty()) {
+        const QString prefix = processes.size() > 1 ? QString("[%1] ").arg(index + 1) : QString();
+        ui->plainTextEdit_output->appendPlainText(prefix + QString::fromUtf8(line));
+    }
+}
+
+void SessionDialog::updateStatus()
+{
+    quint64 progressDone = 0, progressTotal = 0;
+    quint64 initialRecovered = 0, newlyRecovered = 0, recoveredTotal = 0;
+    quint64 rejected = 0;
+    qint64 speed = 0, estimatedStop = 0;
+    int reporting = 0;
+    QList<HashcatDeviceStatus> devices;
+    QStringList deviceKeys;
+    QString statusText;
+
+    for (int i = 0; i < processes.size(); ++i) {
+        const Process &process = processes.at(i);
+        if (!process.hasStatus) {
+            continue;
+        }
+
+        const HashcatStatus &status = process.status;
+        progressDone += status.progressDone;
+        progressTotal += status.progressTotal;
+        initialRecovered = qMax(initialRecovered, process.initialRecovered);
+        newlyRecovered += status.recoveredDone - qMin(status.recoveredDone, process.initialRecovered);
+        recoveredTotal = qMax(recoveredTotal, status.recoveredTotal);
+        rejected += status.rejected;
+
+        if (!process.finished) {
+            speed += status.totalSpeed();
+            ++reporting;
+            estimatedStop = qMax(estimatedStop, status.estimatedStop);
+            devices << status.devices;
+            for (const HashcatDeviceStatus &device : status.devices) {
+                deviceKeys << QString("%1:%2").arg(i).arg(device.id);
+            }
+            if (statusText.isEmpty()) {
+                statusText = status.statusText();
+            }
+        }
+    }
+
+    const double percent = progressTotal > 0 ? 100.0 * static_cast<double>(progressDone) / static_cast<double>(progressTotal) : 0.0;
+
+    ui->label_status_value->setText(statusText);
+    ui->progressBar->setValue(static_cast<int>(percent * 100));
+    ui->progressBar->setFormat(QString("%1 / %2 (%3%)").arg(progressDone).arg(progressTotal).arg(percent, 0, 'f', 2));
+
+    ui->label_speed_value->setText(HelperUtils::formatSpeed(speed));
+    // Only a complete picture is a usable measurement
+    if (speed > 0 && reporting == processes.size()) {
+        emit speedMeasured(speed);
+    }
+    ui->label_recovered_value->setText(QString("%1 / %2").arg(initialRecovered + newlyRecovered).arg(recoveredTotal));
+    ui->label_rejected_value->setText(QString::number(rejected));
+
+    if (estimatedStop > 0) {
+        qint64 left = estimatedStop - QDateTime::currentSecsSinceEpoch();
+        ui->label_eta_value->setText(HelperUtils::formatDuration(qMax<qint64>(left, 0)));
+    } else {
+        ui->label_eta_value->setText("-");
+    }
+
+    // Per device values with their history
+    ui->tableWidget_devices->setRowCount(devices.size());
+    for (int row = 0; row < devices.size(); ++row) {
+        const HashcatDeviceStatus &device = devices.at(row);
+        const DeviceHistory &history = deviceHistories[deviceKeys.at(row)];
+
+        QTableWidgetItem *item = ui->tableWidget_devices->item(row, 0);
+        if (!item) {
+            item = new QTableWidgetItem();
+            ui->tableWidget_devices->setItem(row, 0, item);
+        }
+        item->setText(QString("#%1 %2").arg(device.id).arg(device.name));
+
+        const QList<QPair<QString, const SampleHistory *>> columns = {
+            { HelperUtils::formatSpeed(device.speed), &history.speed },
+            { device.temperature >= 0 ? QString("%1 °C").arg(device.temperature) : QString("-"), &history.temperature },
+            { device.utilization >= 0 ? QString("%1 %").arg(device.utilization) : QString("-"), &history.utilization },
+        };
+        for (int column = 0; column < columns.size(); ++column) {
+            auto *sparkline = qobject_cast<Sparkline *>(ui->tableWidget_devices->cellWidget(row, column + 1));
+            if (!sparkline) {
+                sparkline = new Sparkline();
+                // Temperature and utilization are percent-like, their scale stays put
+                if (column > 0) {
+                    sparkline->setRange(0, 100);
+                }
+                ui->tableWidget_devices->setCellWidget(row, column + 1, sparkline);
+            }
+            sparkline->setHistory(*columns.at(column).second);
+            sparkline->setText(columns.at(column).first);
+        }
+    }
+}
+
+// Adds the latest samples of all running processes to the charts
+void SessionDialog::updateResources()
+{
+    bool sampling = false;
+    bool updated = false;
+    for (Process &process : processes) {
+        if (process.sampler) {
+            sampling = true;
+            if (process.sampler->takeSample(process.sample)) {
+                process.hasSample = true;
+                updated = true;
+            }
+        }
+    }
+    if (!sampling) {
+        resourceTimer.stop();
+        return;
+    }
+    if (!updated) {
+        return;
+    }
+
+    ProcessSample total;
+    for (const Process &process : std::as_const(processes)) {
+        if (!process.sampler || !process.hasSample) {
+            continue;
+        }
+        const ProcessSample &sample = process.sample;
+        total.cpuPercent += sample.cpuPercent;
+        total.busiestThreadPercent = qMax(total.busiestThreadPercent, sample.busiestThreadPercent);
+        total.threads += sample.threads;
+        total.residentBytes += sample.residentBytes;
+        total.swapBytes += sample.swapBytes;
+        total.readBytesPerSecond += sample.readBytesPerSecond;
+        total.writeBytesPerSecond += sample.writeBytesPerSecond;
+    }
+
+    QLocale locale;
+    ui->sparkline_cpu->append(total.cpuPercent);
+    ui->sparkline_cpu->setText(tr("%1 %, busiest thread %2 %, %n thread(s)", nullptr, total.threads)
+                                   .arg(qRound(total.cpuPercent)).arg(qRound(total.busiestThreadPercent)));
+    ui->sparkline_memory->append(static_cast<double>(total.residentBytes));
+    ui->sparkline_memory->setText(total.swapBytes > 0 ? tr("%1, %2 swapped out").arg(locale.formattedDataSize(total.residentBytes),
+                                                                                       locale.formattedDataSize(total.swapBytes))
+                                                      : locale.formattedDataSize(total.residentBytes));
+    ui->sparkline_io->append(static_cast<double>(total.readBytesPerSecond));
+    ui->sparkline_io->setText(tr("%1/s, %2/s written").arg(locale.formattedDataSize(total.readBytesPerSecond),
+                                                           locale.formattedDataSize(total.writeBytesPerSecond)));
+
+    // Devices waiting for work, a saturated thread feeding them is the bottleneck
+    int utilization = 0;
+    int reporting = 0;
+    for (const Process &process : std::as_const(processes)) {
+        if (process.finished || !process.hasStatus) {
+            continue;
+        }
+        for (const HashcatDeviceStatus &device : process.status.devices) {
+            if (device.utilization >= 0) {
+                utilization += device.utilization;
+                ++reporting;
+            }
+        }
+    }
+
+    QStringList hints;
+    if (total.busiestThreadPercent >= saturatedThreadPercent && reporting > 0 && utilization / reporting < idleUtilizationPercent) {
+        hints << tr("A single hashcat thread uses a whole core while the devices are not fully used. "
+                    "Reading the wordlist or applying rules on the host may be the bottleneck.");
+    }
+    if (total.swapBytes > 0) {
+        hints << tr("Part of hashcat's memory is swapped out, fewer hashes per run keep it in memory.");
+    }
+    ui->label_resources_hint->setText(hints.join(' '));
+}
+
+void SessionDialog::processFinished(int index, const HashcatResult &result)
+{
+    processes[index].finished = true;
+    processes[index].sampler.reset();
+    collectResults(index, true);
+
+    QString text;
+    // hashcat exit codes: 0 cracked, 1 exhausted, 2 aborted, 3 aborted by checkpoint, 4 aborted by runtime
+    if (result.exitStatus == QProcess::NormalExit && result.exitCode >= 0 && result.exitCode <= 4) {
+        text = tr("Finished (exit code %1)").arg(result.exitCode);
+    } else if (result.exitStatus == QProcess::NormalExit) {
+        text = tr("Failed (exit code %1)").arg(result.exitCode);
+    } else {
+        text = tr("Failed: %1").arg(result.standardError.trimmed().section('\n', -1));
+    }
+
+    if (processes.size() > 1) {
+        ui->plainTextEdit_output->appendPlainText(QString("[%1] %2").arg(index + 1).arg(text));
+    }
+
+    if (isRunning()) {
+        updateStatus();
+        return;
+    }
+
+    ui->pushButton_stop->setEnabled(false);
+    updateStatus();
+    mergeOutfiles();
+    ui->label_status_value->setText(processes.size() > 1 ? tr("Finished") : text);
+
+    if (closeWhenFinished) {
+        close();
+    }
+}
+
+// Appends what a slice found since the last call to the session outfile, which the results window follows
+void SessionDialog::collectResults(int index, bool drain)
+{
+    Process &process = processes[index];
+    if (outfile.isEmpty() || process.outfile.isEmpty()) {
+        return;
+    }
+
+    QFile part(process.outfile);
+    if (!part.open(QIODevice::ReadOnly) || part.size() <= process.outfileOffset || !part.seek(process.outfileOffset)) {
+        return;
+    }
+
+    QFile out(outfile);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        ui->plainTextEdit_output->appendPlainText(tr("Could not open %1 for writing.").arg(outfile));
+        return;
+    }
+
+    while (!part.atEnd()) {
+        QByteArray data = part.read(maxResultsRead);
+
+        // A running slice may be halfway through a line, the rest is read with its next status
+        if (!drain || !part.atEnd()) {
+            const qsizetype end = data.lastIndexOf('\n') + 1;
+            if (end == 0) {
+                break;
+            }
+            data.truncate(end);
+        }
+        process.outfileOffset += data.size();
+        part.seek(process.outfileOffset);
+
+        const QList<QByteArray> lines = data.split('\n');
+        for (const QByteArray &line : lines) {
+            // Two different results with the same 64 bit fingerprint are too unlikely to matter
+            const quint64 fingerprint = HyperLogLog::hash(line.constData(), line.size());
+            if (line.trimmed().isEmpty() || mergedResults.contains(fingerprint)) {
+                continue;
+            }
+            mergedResults.insert(fingerprint);
+            out.write(line + '\n');
+        }
+
+        if (!drain) {
+            break;
+        }
+    }
+}
+
+// Takes the rest of the part files of all slices into the session outfile and removes them
+void SessionDialog::mergeOutfiles()
+{
+    if (outfile.isEmpty()) {
+        return;
+    }
+
+    for (int i = 0; i < processes.size(); ++i) {
+        collectResults(i, true);
+        if (!processes.at(i).outfile.isEmpty()) {
+            QFile::remove(processes.at(i).outfile);
+        }
+    }
+
+    ui->plainTextEdit_output->appendPlainText(tr("%1 results merged into %2").arg(mergedResults.size()).arg(outfile));
+}
@@ -0,0 +1,94 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef SESSIONDIALOG_H
+#define SESSIONDIALOG_H
+
+#include <QDialog>
+#include <QHash>
+#include <QPointer>
+#include <QSet>
+#include <QSharedPointer>
+#include <QTimer>
+#include "hashcatrunner.h"
+#include "hashcatstatus.h"
+#include "processsampler.h"
+#include "sparkline.h"
+
+namespace Ui {
+    class SessionDialog;
+}
+
+class SessionDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit SessionDialog(QWidget *parent = nullptr);
+    ~SessionDialog();
+
+    void start(const QStringList &arguments);
+
+    // Runs one process per device group, each on its own part of the keyspace.
+    // limit == 0 means up to the end of the keyspace.
+    void startSliced(const QStringList &arguments, const QStringList &keyspaceArguments,
+                     const QStringList &deviceGroups, const QList<double> &weights, const QString &cpuAffinity,
+                     quint64 skip, quint64 limit, const QString &outfile);
+
+signals:
+    // Combined speed of all running processes
+    void speedMeasured(qint64 speed);
+
+protected:
+    void closeEvent(QCloseEvent *event) override;
+
+private slots:
+    void stopClicked();
+
+private:
+    struct Process {
+        HashcatRunner *runner = nullptr;
+        HashcatStatus status;
+        bool hasStatus = false;
+        bool finished = false;
+        quint64 initialRecovered = 0;
+        // Part file that is merged into the session outfile
+        QString outfile;
+        // Bytes of the part file already merged
+        qint64 outfileOffset = 0;
+        // Null where /proc is not available
+        QSharedPointer<ProcessSampler> sampler;
+        ProcessSample sample;
+        bool hasSample = false;
+    };
+
+    // Values hashcat reported for one device of one process
+    struct DeviceHistory {
+        SampleHistory speed;
+        SampleHistory temperature;
+        SampleHistory utilization;
+    };
+
+    Ui::SessionDialog *ui;
+    QList<Process> processes;
+    QPointer<HashcatRunner> keyspaceRunner;
+    QString outfile;
+    // Fingerprints of the results merged so far, a result several slices found is written once
+    QSet<quint64> mergedResults;
+    bool closeWhenFinished = false;
+    QHash<QString, DeviceHistory> deviceHistories;
+    QTimer resourceTimer;
+
+    bool isRunning() const;
+    void startProcesses(const QList<QStringList> &argumentSets, const QStringList &partFiles = {});
+    void outputLineReceived(int index, const QByteArray &line);
+    void processFinished(int index, const HashcatResult &result);
+    void updateStatus();
+    void updateResources();
+    void collectResults(int index, bool drain);
+    void mergeOutfiles();
+};
+
+#endif // SESSIONDIALOG_H
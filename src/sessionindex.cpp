@@ -0,0 +1,243 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "sessionindex.h"
+#include "helperutils.h"
+#include "settingsmanager.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRandomGenerator>
+#include <QSet>
+#include <QStandardPaths>
+#include <QVariantMap>
+#include <QtEndian>
+#include <algorithm>
+
+namespace {
+
+QString tr(const char *text)
+{
+    return QCoreApplication::translate("SessionIndex", text);
+}
+
+// Offsets in restore_data_t: int version, char cwd[256], u32 dicts_pos, u32 masks_pos, u64 words_cur, u32 argc
+constexpr qsizetype versionOffset = 0;
+constexpr qsizetype cwdOffset = 4;
+constexpr qsizetype cwdSize = 256;
+constexpr qsizetype dictsPosOffset = 260;
+constexpr qsizetype masksPosOffset = 264;
+constexpr qsizetype wordsCurOffset = 272;
+constexpr qsizetype argcOffset = 280;
+
+// hashcat writes a checkpoint every 60 seconds by default
+constexpr qint64 checkpointSeconds = 60;
+
+} // namespace
+
+bool RestoreSession::isActive() const
+{
+    return modified.secsTo(QDateTime::currentDateTime()) < 2 * checkpointSeconds;
+}
+
+double RestoreSession::progress() const
+{
+    using Parameter = HelperUtils::Parameter;
+
+    // The position starts over with every wordlist and mask, the keyspace only covers the first
+    if (wordlistPosition > 0 || maskPosition > 0) {
+        return -1;
+    }
+
+    const quint64 skip = HelperUtils::parameterValue(arguments, Parameter::Skip).toULongLong();
+    const quint64 limit = HelperUtils::parameterValue(arguments, Parameter::Limit).toULongLong();
+    const quint64 total = limit > 0 ? limit : (keyspace > skip ? keyspace - skip : 0);
+    if (total == 0 || position < skip) {
+        return -1;
+    }
+    return qMin(1.0, static_cast<double>(position - skip) / static_cast<double>(total));
+}
+
+QString SessionIndex::newSession()
+{
+    // Two launches within a second still get different names
+    const QString suffix = QString::number(QRandomGenerator::global()->bounded(0x10000), 16).rightJustified(4, '0');
+    return QString("hashcat-gui-%1-%2").arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss"), suffix);
+}
+
+void SessionIndex::remember(const QString &session, quint64 keyspace)
+{
+    auto &settings = SettingsManager::instance();
+    QVariantMap index = settings.getKey<QVariantMap>(indexKey);
+
+    QVariantMap entry;
+    // As text, 64-bit values don't survive every settings format
+    entry["keyspace"] = QString::number(keyspace);
+    entry["started"] = QDateTime::currentSecsSinceEpoch();
+    index.insert(session, entry);
+
+    settings.setKey(indexKey, index);
+}
+
+QStringList SessionIndex::directories()
+{
+    QStringList candidates;
+
+    // Portable builds write next to the binary
+    const QString hashcatPath = SettingsManager::instance().getKey<QString>("hashcatPath");
+    if (!hashcatPath.isEmpty()) {
+        candidates << QFileInfo(hashcatPath).absolutePath();
+    }
+
+#if !defined(Q_OS_WIN)
+    // Installed builds write to the profile directory
+    candidates << QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + "/hashcat/sessions";
+    candidates << QDir::homePath() + "/.hashcat/sessions";
+#endif
+
+    QStringList result;
+    for (const QString &directory : std::as_const(candidates)) {
+        const QString canonical = QFileInfo(directory).canonicalFilePath();
+        if (!canonical.isEmpty() && !result.contains(canonical)) {
+            result << canonical;
+        }
+    }
+    return result;
+}
+
+QList<RestoreSession> SessionIndex::scan()
+{
+    auto &settings = SettingsManager::instance();
+    QVariantMap index = settings.getKey<QVariantMap>(indexKey);
+
+    QList<RestoreSession> sessions;
+    QSet<QString> found;
+
+    for (const QString &directory : directories()) {
+        const QFileInfoList files = QDir(directory).entryInfoList({ "*.restore" }, QDir::Files);
+        for (const QFileInfo &file : files) {
+            RestoreSession session = read(file.absoluteFilePath());
+
+            // Slices of a split keyspace are named after the session with their number appended
+            QString name = session.session;
+            if (!index.contains(name) && name.contains('-')) {
+                name.truncate(name.lastIndexOf('-'));
+            }
+            const QVariantMap entry = index.value(name).toMap();
+            if (!entry.isEmpty()) {
+                session.startedByGui = true;
+                session.keyspace = entry.value("keyspace").toString().toULongLong();
+            }
+
+            found.insert(name);
+            sessions << session;
+        }
+    }
+
+    // Finished sessions leave no .restore file behind, their entries are dropped once they are old enough
+    // to have written a checkpoint
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    bool changed = false;
+    for (auto it = index.begin(); it != index.end();) {
+        if (!found.contains(it.key()) && now - it.value().toMap().value("started").toLongLong() > indexExpirySeconds) {
+            it = index.erase(it);
+            changed = true;
+        } else {
+            ++it;
+        }
+    }
+    if (changed) {
+        settings.setKey(indexKey, index);
+    }
+
+    std::sort(sessions.begin(), sessions.end(), [](const RestoreSession &a, const RestoreSession &b) {
+        return a.modified > b.modified;
+    });
+    return sessions;
+}
+
+RestoreSession SessionIndex::read(const QString &file)
+{
+    RestoreSession session;
+    const QFileInfo info(file);
+    session.file = info.absoluteFilePath();
+    session.session = info.completeBaseName();
+    session.modified = info.lastModified();
+
+    QFile f(file);
+    if (!f.open(QIODevice::ReadOnly)) {
+        session.error = tr("Could not open %1.").arg(file);
+        return session;
+    }
+
+    const QByteArray data = f.readAll();
+    const char *header = data.constData();
+    const quint32 argc = data.size() < headerSize ? 0 : qFromLittleEndian<quint32>(header + argcOffset);
+    if (argc == 0 || argc > maxArguments) {
+        session.error = tr("%1 is not a hashcat restore file.").arg(file);
+        return session;
+    }
+
+    session.version = qFromLittleEndian<quint32>(header + versionOffset);
+    session.workingDirectory = QString::fromLocal8Bit(header + cwdOffset, qstrnlen(header + cwdOffset, cwdSize));
+    session.wordlistPosition = qFromLittleEndian<quint32>(header + dictsPosOffset);
+    session.maskPosition = qFromLittleEndian<quint32>(header + masksPosOffset);
+    session.position = qFromLittleEndian<quint64>(header + wordsCurOffset);
+
+    const QList<QByteArray> lines = data.mid(headerSize).split('\n');
+    if (static_cast<quint32>(lines.size()) < argc) {
+        session.error = tr("The command line in %1 is incomplete.").arg(file);
+        return session;
+    }
+
+    // The first argument is the hashcat binary
+    for (quint32 i = 1; i < argc; ++i) {
+        session.arguments << QString::fromLocal8Bit(lines.at(i));
+    }
+    return session;
+}
+
+RestoreSession SessionIndex::find(const QString &session)
+{
+    for (const QString &directory : directories()) {
+        const QString file = QDir(directory).filePath(session + ".restore");
+        if (QFileInfo(file).isFile()) {
+            return read(file);
+        }
+    }
+
+    RestoreSession missing;
+    missing.session = session;
+    missing.error = tr("Session %1 has no restore file.").arg(session);
+    return missing;
+}
+
+QStringList SessionIndex::restoreArguments(const RestoreSession &session)
+{
+    using Parameter = HelperUtils::Parameter;
+
+    // hashcat takes everything else from the restore file
+    return { HelperUtils::getParameter(Parameter::Session), session.session,
+             HelperUtils::getParameter(Parameter::Restore),
+             HelperUtils::getParameter(Parameter::RestoreFilePath), session.file };
+}
+
+bool SessionIndex::remove(const RestoreSession &session, QString *error)
+{
+    if (QFile::exists(session.file) && !QFile::remove(session.file)) {
+        if (error) {
+            *error = tr("Could not delete %1.").arg(session.file);
+        }
+        return false;
+    }
+
+    auto &settings = SettingsManager::instance();
+    QVariantMap index = settings.getKey<QVariantMap>(indexKey);
+    if (index.remove(session.session) > 0) {
+        settings.setKey(indexKey, index);
+    }
+    return true;
+}
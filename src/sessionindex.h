@@ -0,0 +1,77 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef SESSIONINDEX_H
+#define SESSIONINDEX_H
+
+#include <QDateTime>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+// A .restore file hashcat writes while it runs and deletes once the attack is done,
+// a file that is left over belongs to an interrupted session
+struct RestoreSession {
+    QString session;
+    QString file;
+    // Time of the last checkpoint
+    QDateTime modified;
+
+    quint32 version = 0;
+    // Working directory hashcat changes to when restoring
+    QString workingDirectory;
+    // Wordlist and mask (.hcmask line) the attack was at, counted from 0
+    quint32 wordlistPosition = 0;
+    quint32 maskPosition = 0;
+    // Keyspace position of the checkpoint, a restore continues from there
+    quint64 position = 0;
+    // Command line of the session, without the hashcat binary
+    QStringList arguments;
+
+    // From the index, 0 if the session was started elsewhere or its keyspace was not known
+    quint64 keyspace = 0;
+    bool startedByGui = false;
+    QString error;
+
+    bool isValid() const { return error.isEmpty(); }
+    // hashcat writes a checkpoint every minute, a session that wrote one recently may still run
+    bool isActive() const;
+    // Share of the keyspace between --skip and --limit that is done, -1 if unknown
+    double progress() const;
+};
+
+// Gives every launch its own --session so runs don't overwrite each other's .restore files,
+// and finds the sessions that can be restored
+class SessionIndex
+{
+public:
+    // Unique name for a new session, e.g. "hashcat-gui-20240101-120000-3f2a"
+    static QString newSession();
+    // Keyspace of the attack in hashcat's units, for the progress of its checkpoints
+    static void remember(const QString &session, quint64 keyspace);
+
+    // Directories hashcat writes .restore files to, the hashcat directory first
+    static QStringList directories();
+    // Interrupted sessions, the latest checkpoint first
+    static QList<RestoreSession> scan();
+    static RestoreSession read(const QString &file);
+    // The .restore file of a session, invalid if it has none
+    static RestoreSession find(const QString &session);
+
+    // Arguments that continue the session from its last checkpoint
+    static QStringList restoreArguments(const RestoreSession &session);
+    // Deletes the .restore file, the session can't be restored afterwards
+    static bool remove(const RestoreSession &session, QString *error = nullptr);
+
+private:
+    static constexpr const char *indexKey = "sessions";
+    // Layout of hashcat's restore_data_t on 64-bit systems, the arguments follow line by line
+    static constexpr qsizetype headerSize = 296;
+    static constexpr int maxArguments = 1024;
+    // Sessions that never wrote a checkpoint are dropped from the index after this time
+    static constexpr qint64 indexExpirySeconds = 24 * 60 * 60;
+};
+
+#endif // SESSIONINDEX_H
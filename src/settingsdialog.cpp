@@ -42,6 +42,9 @@ void SettingsDialog::readSettings()
 
     // use short parameters
     ui->checkBox_use_short_parameters->setChecked(settings.getKey<bool>("useShortParameters"));
+
+    // run hashcat embedded with live status
+    ui->checkBox_run_embedded->setChecked(settings.getKey<bool>("runEmbedded"));
 }
 
 // Configure path to hashcat binary
@@ -70,6 +73,7 @@ void SettingsDialog::saveClicked()
     settings.setKey("hashcatPath", ui->lineEdit_hc_path->text());
     settings.setKey("terminal", ui->comboBox_terminal->currentText());
     settings.setKey("useShortParameters", ui->checkBox_use_short_parameters->isChecked());
+    settings.setKey("runEmbedded", ui->checkBox_run_embedded->isChecked());
 
     // accept() signals our parent that settings might have changed
     accept();
@@ -0,0 +1,118 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "sparkline.h"
+#include <QPainter>
+#include <QPainterPath>
+
+void SampleHistory::append(double value)
+{
+    values[next] = value;
+    next = (next + 1) % capacity;
+    count = qMin(count + 1, capacity);
+}
+
+double SampleHistory::at(int index) const
+{
+    return values[(next - count + index + capacity) % capacity];
+}
+
+Sparkline::Sparkline(QWidget *parent)
+    : QWidget(parent)
+{
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+}
+
+void Sparkline::append(double value)
+{
+    history.append(value);
+    update();
+}
+
+void Sparkline::setHistory(const SampleHistory &history)
+{
+    this->history = history;
+    update();
+}
+
+void Sparkline::setText(const QString &text)
+{
+    if (this->text != text) {
+        this->text = text;
+        update();
+    }
+}
+
+void Sparkline::setRange(double minimum, double maximum)
+{
+    this->minimum = minimum;
+    this->maximum = maximum;
+    fixedRange = true;
+    update();
+}
+
+QSize Sparkline::sizeHint() const
+{
+    return QSize(240, fontMetrics().height() + 8);
+}
+
+QSize Sparkline::minimumSizeHint() const
+{
+    return QSize(80, fontMetrics().height() + 4);
+}
+
+void Sparkline::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    const QRectF area = QRectF(rect()).adjusted(1, 2, -1, -2);
+
+    if (history.size() > 1) {
+        double low = minimum;
+        double high = maximum;
+        if (!fixedRange) {
+            low = high = history.at(0);
+            for (int i = 1; i < history.size(); ++i) {
+                low = qMin(low, history.at(i));
+                high = qMax(high, history.at(i));
+            }
+            // Rates start at zero so a drop shows as a drop, not as noise around the average
+            low = qMin(low, 0.0);
+        }
+        const double span = high > low ? high - low : 1.0;
+
+        // The time axis is fixed, the line grows to the right until the history is full and scrolls then
+        const double step = area.width() / (SampleHistory::capacity - 1);
+        const double x0 = area.right() - step * (history.size() - 1);
+
+        QPainterPath line;
+        for (int i = 0; i < history.size(); ++i) {
+            const double value = qBound(low, history.at(i), high);
+            const QPointF point(x0 + step * i, area.bottom() - (value - low) / span * area.height());
+            if (i == 0) {
+                line.moveTo(point);
+            } else {
+                line.lineTo(point);
+            }
+        }
+
+        QPainterPath fill = line;
+        fill.lineTo(area.right(), area.bottom());
+        fill.lineTo(x0, area.bottom());
+        fill.closeSubpath();
+
+        QColor color = palette().color(QPalette::Highlight);
+        painter.setRenderHint(QPainter::Antialiasing);
+        color.setAlpha(60);
+        painter.fillPath(fill, color);
+        color.setAlpha(200);
+        painter.setPen(QPen(color, 1.5));
+        painter.drawPath(line);
+    }
+
+    if (!text.isEmpty()) {
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(rect().adjusted(4, 0, -4, 0), Qt::AlignLeft | Qt::AlignVCenter, text);
+    }
+}
@@ -0,0 +1,58 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef SPARKLINE_H
+#define SPARKLINE_H
+
+#include <QWidget>
+#include <array>
+
+// The latest values of a time series. New values overwrite the oldest ones, so the memory
+// stays the same however long a session runs.
+class SampleHistory
+{
+public:
+    static constexpr int capacity = 600;
+
+    void append(double value);
+    int size() const { return count; }
+    // 0 is the oldest value
+    double at(int index) const;
+
+private:
+    std::array<double, capacity> values {};
+    int next = 0;
+    int count = 0;
+};
+
+// Small line chart of a SampleHistory with the current value as text
+class Sparkline : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit Sparkline(QWidget *parent = nullptr);
+
+    void append(double value);
+    void setHistory(const SampleHistory &history);
+    void setText(const QString &text);
+    // Fixed bounds, e.g. 0 to 100 for percentages, otherwise the chart follows the values
+    void setRange(double minimum, double maximum);
+
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    SampleHistory history;
+    QString text;
+    double minimum = 0;
+    double maximum = 0;
+    bool fixedRange = false;
+};
+
+#endif // SPARKLINE_H
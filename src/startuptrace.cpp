@@ -0,0 +1,135 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "startuptrace.h"
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QSaveFile>
+#include <QString>
+#include <QThread>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+struct Event {
+    const char *name;
+    qint64 begin;
+    // -1 for a mark
+    qint64 duration;
+    quintptr thread;
+};
+
+struct Trace {
+    QMutex mutex;
+    QElapsedTimer clock;
+    QString file;
+    std::vector<Event> events;
+    bool enabled = false;
+    bool finished = false;
+};
+
+Trace &trace()
+{
+    static Trace instance;
+    return instance;
+}
+
+qint64 now()
+{
+    return trace().clock.nsecsElapsed() / 1000;
+}
+
+void record(const char *name, qint64 begin, qint64 duration)
+{
+    Trace &t = trace();
+    QMutexLocker locker(&t.mutex);
+    if (!t.finished) {
+        t.events.push_back({ name, begin, duration, reinterpret_cast<quintptr>(QThread::currentThreadId()) });
+    }
+}
+
+} // namespace
+
+StartupTrace::Scope::Scope(const char *name)
+    : name(name)
+    , begin(isEnabled() ? now() : 0)
+{
+}
+
+StartupTrace::Scope::~Scope()
+{
+    if (isEnabled()) {
+        record(name, begin, now() - begin);
+    }
+}
+
+void StartupTrace::init(int argc, char *argv[])
+{
+    Trace &t = trace();
+    t.file = qEnvironmentVariable("HASHCAT_GUI_TRACE");
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--trace-startup") == 0) {
+            t.file = QString::fromLocal8Bit(argv[i + 1]);
+        }
+    }
+
+    t.enabled = !t.file.isEmpty();
+    t.clock.start();
+}
+
+bool StartupTrace::isEnabled()
+{
+    return trace().enabled;
+}
+
+void StartupTrace::mark(const char *name)
+{
+    if (isEnabled()) {
+        record(name, now(), -1);
+    }
+}
+
+void StartupTrace::finish()
+{
+    Trace &t = trace();
+    QMutexLocker locker(&t.mutex);
+    if (!t.enabled || t.finished) {
+        return;
+    }
+    t.finished = true;
+
+    // Complete events ("X") for phases, instant events ("i") for marks, times in microseconds
+    QJsonArray events;
+    for (const Event &event : t.events) {
+        QJsonObject entry {
+            { "name", QString::fromLatin1(event.name) },
+            { "ts", event.begin },
+            { "pid", 1 },
+            { "tid", static_cast<qint64>(event.thread) },
+        };
+        if (event.duration < 0) {
+            entry["ph"] = "i";
+            entry["s"] = "g";
+        } else {
+            entry["ph"] = "X";
+            entry["dur"] = event.duration;
+        }
+        events.append(entry);
+    }
+
+    QSaveFile f(t.file);
+    if (!f.open(QIODevice::WriteOnly)) {
+        qWarning("Could not write startup trace to %s", qPrintable(t.file));
+        return;
+    }
+    f.write(QJsonDocument(QJsonObject { { "traceEvents", events }, { "displayTimeUnit", "ms" } }).toJson(QJsonDocument::Compact));
+    if (!f.commit()) {
+        qWarning("Could not write startup trace to %s", qPrintable(t.file));
+    }
+}
@@ -0,0 +1,40 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+#include <QtGlobal>
+
+// Timing of the startup phases. Enabled by "--trace-startup <file>" or the HASHCAT_GUI_TRACE
+// environment variable, the phases are written to the file in the Chrome trace event format
+// (chrome://tracing, ui.perfetto.dev) when the application quits.
+class StartupTrace
+{
+public:
+    // Records the time from construction to destruction as one phase, from any thread
+    class Scope
+    {
+    public:
+        explicit Scope(const char *name);
+        ~Scope();
+
+    private:
+        const char *name;
+        qint64 begin;
+    };
+
+    // Call first thing in main(), starts the clock if tracing is enabled
+    static void init(int argc, char *argv[]);
+    static bool isEnabled();
+
+    // A point in time without a duration, e.g. when the window became interactive
+    static void mark(const char *name);
+
+    // Writes the trace file, only the first call does anything
+    static void finish();
+};
+
+#endif // STARTUPTRACE_H
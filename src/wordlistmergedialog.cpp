@@ -0,0 +1,126 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "wordlistmergedialog.h"
+#include "ui_wordlistmergedialog.h"
+#include "settingsmanager.h"
+#include <QDir>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QLocale>
+#include <QMessageBox>
+#include <QtConcurrent>
+
+WordlistMergeDialog::WordlistMergeDialog(const QStringList &inputs, QWidget *parent)
+    : QDialog(parent)
+    , ui(new Ui::WordlistMergeDialog)
+    , inputs(inputs)
+    , watcher(new QFutureWatcher<WordlistMergeResult>(this))
+{
+    ui->setupUi(this);
+
+    auto &settings = SettingsManager::instance();
+
+    ui->label_inputs->setText(tr("Merge %n checked wordlist(s) into one file without duplicates.", nullptr, inputs.size()));
+    ui->label_inputs->setToolTip(inputs.join('\n'));
+    if (!inputs.isEmpty()) {
+        ui->lineEdit_output->setText(QDir::toNativeSeparators(QFileInfo(inputs.first()).dir().filePath("merged.txt")));
+    }
+    ui->spinBox_memory->setValue(settings.getKey<int>("mergeMemoryLimit", 1024));
+    ui->checkBox_keep_order->setChecked(settings.getKey<bool>("mergeKeepOrder", false));
+
+    connect(ui->pushButton_output, &QPushButton::clicked, this, &WordlistMergeDialog::outputClicked);
+    connect(ui->pushButton_merge, &QPushButton::clicked, this, &WordlistMergeDialog::mergeClicked);
+    connect(ui->pushButton_cancel, &QPushButton::clicked, watcher, &QFutureWatcher<WordlistMergeResult>::cancel);
+    connect(ui->pushButton_close, &QPushButton::clicked, this, &WordlistMergeDialog::close);
+    connect(watcher, &QFutureWatcher<WordlistMergeResult>::progressValueChanged, ui->progressBar, &QProgressBar::setValue);
+    connect(watcher, &QFutureWatcher<WordlistMergeResult>::finished, this, &WordlistMergeDialog::mergeFinished);
+
+    updateButtons();
+}
+
+WordlistMergeDialog::~WordlistMergeDialog()
+{
+    // The temporary files are removed when the worker returns
+    watcher->cancel();
+    watcher->waitForFinished();
+    delete ui;
+}
+
+void WordlistMergeDialog::outputClicked()
+{
+    QString output = QFileDialog::getSaveFileName(this, tr("Merged wordlist"), ui->lineEdit_output->text());
+    if (!output.isEmpty()) {
+        ui->lineEdit_output->setText(QDir::toNativeSeparators(output));
+    }
+}
+
+void WordlistMergeDialog::mergeClicked()
+{
+    const QString output = ui->lineEdit_output->text().trimmed();
+    if (output.isEmpty()) {
+        QMessageBox::information(this, tr("Merge wordlists"), tr("Choose a file for the merged wordlist."));
+        return;
+    }
+    if (QFileInfo::exists(output)) {
+        QMessageBox::StandardButton answer = QMessageBox::question(this, tr("Merge wordlists"), tr("%1 already exists. Overwrite it?").arg(output));
+        if (answer != QMessageBox::Yes) {
+            return;
+        }
+    }
+
+    auto &settings = SettingsManager::instance();
+    settings.setKey("mergeMemoryLimit", ui->spinBox_memory->value());
+    settings.setKey("mergeKeepOrder", ui->checkBox_keep_order->isChecked());
+
+    WordlistMergeOptions options;
+    options.inputs = inputs;
+    options.output = output;
+    options.memoryLimit = static_cast<qint64>(ui->spinBox_memory->value()) * 1024 * 1024;
+    options.keepOrder = ui->checkBox_keep_order->isChecked();
+
+    ui->label_result->clear();
+    ui->progressBar->setValue(0);
+    watcher->setFuture(QtConcurrent::run(&WordlistMerger::run, options));
+    updateButtons();
+}
+
+void WordlistMergeDialog::mergeFinished()
+{
+    updateButtons();
+
+    if (watcher->isCanceled() || watcher->future().resultCount() == 0) {
+        ui->progressBar->setValue(0);
+        ui->label_result->setText(tr("Cancelled."));
+        return;
+    }
+
+    const WordlistMergeResult result = watcher->result();
+    if (!result.error.isEmpty()) {
+        ui->progressBar->setValue(0);
+        ui->label_result->clear();
+        QMessageBox::warning(this, tr("Merge wordlists"), result.error);
+        return;
+    }
+
+    QLocale locale;
+    const double ratio = result.lines > 0 ? 100.0 * static_cast<double>(result.duplicates()) / static_cast<double>(result.lines) : 0.0;
+    ui->label_result->setText(tr("%1 lines written, %2 duplicates removed (%3%).")
+                                  .arg(locale.toString(result.unique), locale.toString(result.duplicates()))
+                                  .arg(ratio, 0, 'f', 1));
+
+    emit merged(ui->lineEdit_output->text().trimmed(), inputs);
+}
+
+void WordlistMergeDialog::updateButtons()
+{
+    const bool running = watcher->isRunning();
+    ui->pushButton_merge->setEnabled(!running && !inputs.isEmpty());
+    ui->pushButton_cancel->setEnabled(running);
+    ui->lineEdit_output->setEnabled(!running);
+    ui->pushButton_output->setEnabled(!running);
+    ui->spinBox_memory->setEnabled(!running);
+    ui->checkBox_keep_order->setEnabled(!running);
+}
@@ -0,0 +1,42 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef WORDLISTMERGEDIALOG_H
+#define WORDLISTMERGEDIALOG_H
+
+#include <QDialog>
+#include <QFutureWatcher>
+#include "wordlistmerger.h"
+
+namespace Ui {
+    class WordlistMergeDialog;
+}
+
+class WordlistMergeDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit WordlistMergeDialog(const QStringList &inputs, QWidget *parent = nullptr);
+    ~WordlistMergeDialog();
+
+signals:
+    // Emitted after the merged file was written
+    void merged(const QString &output, const QStringList &inputs);
+
+private slots:
+    void outputClicked();
+    void mergeClicked();
+    void mergeFinished();
+
+private:
+    Ui::WordlistMergeDialog *ui;
+    QStringList inputs;
+    QFutureWatcher<WordlistMergeResult> *watcher;
+
+    void updateButtons();
+};
+
+#endif // WORDLISTMERGEDIALOG_H
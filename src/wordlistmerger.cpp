@@ -0,0 +1,642 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "wordlistmerger.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <vector>
+
+// Block size for reading wordlists and for buffered run I/O
+static constexpr qint64 readBlockSize = 4 * 1024 * 1024;
+static constexpr qint64 ioBufferSize = 256 * 1024;
+// Runs merged at once, more runs are merged in several passes
+static constexpr int maxFanIn = 64;
+// Record offsets are 32 bit
+static constexpr qint64 maxRunBytes = 1024 * 1024 * 1024;
+static constexpr qint64 minRunBytes = 4 * 1024 * 1024;
+
+namespace {
+
+enum class Order
+{
+    Line,
+    Index
+};
+
+// Line in a run, index is its position in the concatenated input
+struct Record {
+    quint64 index;
+    quint32 offset;
+    quint32 length;
+};
+
+struct Run {
+    QByteArray arena;
+    std::vector<Record> records;
+};
+
+int compareLines(const char *a, qsizetype aLength, const char *b, qsizetype bLength)
+{
+    const int c = std::memcmp(a, b, static_cast<size_t>(qMin(aLength, bLength)));
+    if (c != 0) {
+        return c;
+    }
+    return aLength < bLength ? -1 : (aLength > bLength ? 1 : 0);
+}
+
+// Runs are only read back by this process, so native byte order is fine
+class RunWriter
+{
+public:
+    bool open(const QString &path)
+    {
+        file.setFileName(path);
+        return file.open(QIODevice::WriteOnly | QIODevice::Unbuffered);
+    }
+
+    void write(quint64 index, const char *data, quint32 length)
+    {
+        buffer.append(reinterpret_cast<const char *>(&index), sizeof(index));
+        buffer.append(reinterpret_cast<const char *>(&length), sizeof(length));
+        buffer.append(data, length);
+        if (buffer.size() >= ioBufferSize) {
+            flush();
+        }
+    }
+
+    bool close()
+    {
+        flush();
+        file.close();
+        return ok && file.error() == QFileDevice::NoError;
+    }
+
+    QString errorString() const { return file.errorString(); }
+
+private:
+    QFile file;
+    QByteArray buffer;
+    bool ok = true;
+
+    void flush()
+    {
+        if (!buffer.isEmpty() && file.write(buffer) != buffer.size()) {
+            ok = false;
+        }
+        buffer.resize(0);
+    }
+};
+
+class RunReader
+{
+public:
+    quint64 index = 0;
+    QByteArray line;
+    bool failed = false;
+
+    bool open(const QString &path)
+    {
+        file.setFileName(path);
+        return file.open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    }
+
+    // Returns false at the end of the run or on errors
+    bool next()
+    {
+        quint32 length = 0;
+        if (!read(reinterpret_cast<char *>(&index), sizeof(index))) {
+            return false;
+        }
+        if (!read(reinterpret_cast<char *>(&length), sizeof(length))) {
+            failed = true;
+            return false;
+        }
+        line.resize(length);
+        if (!read(line.data(), length)) {
+            failed = true;
+            return false;
+        }
+        return true;
+    }
+
+    QString errorString() const { return file.errorString(); }
+
+private:
+    QFile file;
+    QByteArray buffer;
+    qsizetype pos = 0;
+
+    bool read(char *dst, qint64 size)
+    {
+        while (size > 0) {
+            if (pos == buffer.size()) {
+                buffer.resize(ioBufferSize);
+                const qint64 n = file.read(buffer.data(), ioBufferSize);
+                buffer.resize(qMax<qint64>(n, 0));
+                pos = 0;
+                if (n <= 0) {
+                    return false;
+                }
+            }
+
+            const qint64 n = qMin<qint64>(size, buffer.size() - pos);
+            std::memcpy(dst, buffer.constData() + pos, static_cast<size_t>(n));
+            pos += n;
+            dst += n;
+            size -= n;
+        }
+        return true;
+    }
+};
+
+// Sorts a run and writes it to disk, runs sorted by line keep only the first of equal lines
+QString spill(Run &run, Order order, const QString &path)
+{
+    const char *arena = run.arena.constData();
+
+    if (order == Order::Line) {
+        std::sort(run.records.begin(), run.records.end(), [arena](const Record &a, const Record &b) {
+            const int c = compareLines(arena + a.offset, a.length, arena + b.offset, b.length);
+            return c != 0 ? c < 0 : a.index < b.index;
+        });
+    } else {
+        std::sort(run.records.begin(), run.records.end(), [](const Record &a, const Record &b) {
+            return a.index < b.index;
+        });
+    }
+
+    RunWriter writer;
+    if (!writer.open(path)) {
+        return writer.errorString();
+    }
+
+    const Record *previous = nullptr;
+    for (const Record &r : run.records) {
+        if (order == Order::Line && previous
+            && compareLines(arena + previous->offset, previous->length, arena + r.offset, r.length) == 0) {
+            continue;
+        }
+        writer.write(r.index, arena + r.offset, r.length);
+        previous = &r;
+    }
+
+    return writer.close() ? QString() : writer.errorString();
+}
+
+// Collects records into runs of a fixed memory budget and sorts full runs on the thread pool
+class RunBuilder
+{
+public:
+    QStringList runs;
+    QString error;
+
+    RunBuilder(Order order, const QString &prefix, qint64 runBytes, int maxPending)
+        : order(order)
+        , prefix(prefix)
+        , runBytes(runBytes)
+        , maxPending(maxPending)
+    {
+    }
+
+    ~RunBuilder()
+    {
+        // The runs live in a temporary directory that is removed after this
+        for (QFuture<QString> &f : pending) {
+            f.waitForFinished();
+        }
+    }
+
+    bool add(quint64 index, const char *data, qsizetype length)
+    {
+        if (!reserve(length)) {
+            if (!current.records.empty() && !flush()) {
+                return false;
+            }
+            // A single line larger than the whole budget still gets a run of its own
+            if (!reserve(length)) {
+                current.arena.reserve(length);
+                current.records.reserve(1);
+            }
+        }
+
+        current.records.push_back({ index, static_cast<quint32>(current.arena.size()), static_cast<quint32>(length) });
+        current.arena.append(data, length);
+        return true;
+    }
+
+    // Spills the last run and waits for all of them
+    bool finish()
+    {
+        if (!current.records.empty() && !flush()) {
+            return false;
+        }
+        while (!pending.isEmpty()) {
+            if (!collect()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    Order order;
+    QString prefix;
+    qint64 runBytes;
+    int maxPending;
+    Run current;
+    QList<QFuture<QString>> pending;
+
+    // Containers double their capacity when they grow, which could take a run to twice its budget.
+    // The arena and the records grow here instead, as far as the budget allows. False if the run is full.
+    bool reserve(qsizetype length)
+    {
+        const qint64 arenaSize = current.arena.size() + length;
+        const qint64 recordCount = static_cast<qint64>(current.records.size()) + 1;
+        qint64 arenaCapacity = current.arena.capacity();
+        qint64 recordCapacity = static_cast<qint64>(current.records.capacity());
+        if (arenaSize <= arenaCapacity && recordCount <= recordCapacity) {
+            return true;
+        }
+
+        const auto bytes = [](qint64 arena, qint64 records) {
+            return arena + records * static_cast<qint64>(sizeof(Record));
+        };
+        if (bytes(qMax(arenaSize, arenaCapacity), qMax(recordCount, recordCapacity)) > runBytes) {
+            return false;
+        }
+
+        // Grow what is full geometrically, then give back what exceeds the budget
+        if (arenaSize > arenaCapacity) {
+            arenaCapacity = qMax(arenaSize, qMax<qint64>(arenaCapacity * 2, 64 * 1024));
+            const qint64 excess = qMax<qint64>(bytes(arenaCapacity, qMax(recordCount, recordCapacity)) - runBytes, 0);
+            current.arena.reserve(qMax(arenaSize, arenaCapacity - excess));
+        }
+        if (recordCount > recordCapacity) {
+            recordCapacity = qMax(recordCount, qMax<qint64>(recordCapacity * 2, 4096));
+            const qint64 excess = qMax<qint64>(bytes(current.arena.capacity(), recordCapacity) - runBytes, 0);
+            recordCapacity = qMax(recordCount, recordCapacity - (excess + static_cast<qint64>(sizeof(Record)) - 1) / static_cast<qint64>(sizeof(Record)));
+            current.records.reserve(static_cast<size_t>(recordCapacity));
+        }
+        return true;
+    }
+
+    bool flush()
+    {
+        // Every pending run holds its memory, wait before starting another one
+        if (pending.size() >= maxPending && !collect()) {
+            return false;
+        }
+
+        const QString path = QString("%1-%2").arg(prefix).arg(runs.size());
+        runs << path;
+        pending << QtConcurrent::run([run = std::move(current), order = order, path]() mutable {
+            return spill(run, order, path);
+        });
+        current = Run();
+        return true;
+    }
+
+    bool collect()
+    {
+        const QString e = pending.takeFirst().result();
+        if (!e.isEmpty()) {
+            error = e;
+            return false;
+        }
+        return true;
+    }
+};
+
+using Sink = std::function<bool(quint64 index, const QByteArray &line)>;
+
+// K-way merge of sorted runs, when merging by line only the first of equal lines reaches the sink.
+// Returns false if the sink stopped the merge or a run could not be read.
+bool mergeRuns(const QStringList &runs, Order order, const Sink &sink, QString *error)
+{
+    std::vector<std::unique_ptr<RunReader>> readers;
+    auto greater = [order](const RunReader *a, const RunReader *b) {
+        if (order == Order::Line) {
+            const int c = compareLines(a->line.constData(), a->line.size(), b->line.constData(), b->line.size());
+            if (c != 0) {
+                return c > 0;
+            }
+        }
+        return a->index > b->index;
+    };
+    std::priority_queue<RunReader *, std::vector<RunReader *>, decltype(greater)> heap(greater);
+
+    for (const QString &run : runs) {
+        auto reader = std::make_unique<RunReader>();
+        if (!reader->open(run)) {
+            *error = reader->errorString();
+            return false;
+        }
+        if (reader->next()) {
+            heap.push(reader.get());
+        } else if (reader->failed) {
+            *error = reader->errorString();
+            return false;
+        }
+        readers.push_back(std::move(reader));
+    }
+
+    QByteArray previous;
+    bool hasPrevious = false;
+
+    while (!heap.empty()) {
+        RunReader *top = heap.top();
+        heap.pop();
+
+        const bool duplicate = order == Order::Line && hasPrevious && top->line == previous;
+        if (!duplicate) {
+            if (!sink(top->index, top->line)) {
+                return false;
+            }
+            if (order == Order::Line) {
+                // Copy instead of sharing, the reader reuses its line buffer
+                previous.resize(top->line.size());
+                std::memcpy(previous.data(), top->line.constData(), static_cast<size_t>(top->line.size()));
+                hasPrevious = true;
+            }
+        }
+
+        if (top->next()) {
+            heap.push(top);
+        } else if (top->failed) {
+            *error = top->errorString();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Merges groups of runs into bigger ones until a single pass can merge the rest
+bool reduceRuns(QStringList &runs, Order order, const QString &prefix, const std::function<bool()> &isCanceled, QString *error)
+{
+    int pass = 0;
+
+    while (runs.size() > maxFanIn) {
+        QStringList merged;
+
+        for (int i = 0; i < runs.size(); i += maxFanIn) {
+            const QStringList group = runs.mid(i, maxFanIn);
+            const QString path = QString("%1-pass%2-%3").arg(prefix).arg(pass).arg(merged.size());
+
+            RunWriter writer;
+            if (!writer.open(path)) {
+                *error = writer.errorString();
+                return false;
+            }
+
+            quint64 count = 0;
+            const bool ok = mergeRuns(group, order, [&](quint64 index, const QByteArray &line) {
+                writer.write(index, line.constData(), static_cast<quint32>(line.size()));
+                return (++count & 0xFFFF) != 0 || !isCanceled();
+            }, error);
+
+            if (!writer.close() && error->isEmpty()) {
+                *error = writer.errorString();
+            }
+            if (!ok || !error->isEmpty()) {
+                return false;
+            }
+
+            for (const QString &run : group) {
+                QFile::remove(run);
+            }
+            merged << path;
+        }
+
+        runs = merged;
+        ++pass;
+    }
+
+    return true;
+}
+
+} // namespace
+
+WordlistMergeResult WordlistMerger::merge(const WordlistMergeOptions &options, const Progress &progress)
+{
+    WordlistMergeResult result;
+
+    auto fail = [&result](const QString &error) {
+        result.error = error;
+        return result;
+    };
+
+    // Progress is split into the read phase and one or two merge phases
+    const int readEnd = options.keepOrder ? 400 : 500;
+    const int mergeEnd = options.keepOrder ? 700 : 1000;
+    int lastProgress = 0;
+    bool canceled = false;
+    auto report = [&](int begin, int end, quint64 done, quint64 total) {
+        const int value = total > 0 ? begin + static_cast<int>((end - begin) * (static_cast<double>(done) / static_cast<double>(total))) : end;
+        lastProgress = qMin(value, end);
+        canceled |= !progress(lastProgress);
+    };
+    auto isCanceled = [&]() {
+        canceled |= !progress(lastProgress);
+        return canceled;
+    };
+
+    // Declared first so it is removed after the builders waited for their runs
+    const QString tempBase = options.tempPath.isEmpty() ? QDir::tempPath() : options.tempPath;
+    QTemporaryDir tempDir(QDir(tempBase).filePath("hashcat-gui-merge-XXXXXX"));
+    if (!tempDir.isValid()) {
+        return fail(QCoreApplication::translate("WordlistMerger", "Could not create a temporary directory in %1.").arg(tempBase));
+    }
+
+    // A worker sorts one run while the next one is filled, each of them holds its own budget
+    const int maxPending = qBound(1, QThread::idealThreadCount() - 1, 8);
+    const qint64 runBytes = qBound(minRunBytes, options.memoryLimit / (maxPending + 1), maxRunBytes);
+
+    /* ---------- Read the wordlists into sorted runs ---------- */
+
+    qint64 totalBytes = 0;
+    for (const QString &input : options.inputs) {
+        totalBytes += QFileInfo(input).size();
+    }
+
+    RunBuilder lineRuns(Order::Line, tempDir.filePath("lines"), runBytes, maxPending);
+    qint64 readBytes = 0;
+    QByteArray block;
+    QByteArray carry;
+
+    for (const QString &input : options.inputs) {
+        QFile f(input);
+        if (!f.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+            return fail(QCoreApplication::translate("WordlistMerger", "Could not open %1: %2").arg(input, f.errorString()));
+        }
+
+        carry.clear();
+        bool atEnd = false;
+
+        while (!atEnd) {
+            if (isCanceled()) {
+                return result;
+            }
+
+            block.resize(readBlockSize);
+            const qint64 n = f.read(block.data(), readBlockSize);
+            if (n < 0) {
+                return fail(QCoreApplication::translate("WordlistMerger", "Could not read %1: %2").arg(input, f.errorString()));
+            }
+            block.resize(n);
+            atEnd = n == 0;
+            readBytes += n;
+
+            // A line that spans two blocks is joined in carry first
+            if (!carry.isEmpty()) {
+                carry.append(block);
+                block.swap(carry);
+                carry.clear();
+            }
+
+            const char *p = block.constData();
+            const char *end = p + block.size();
+
+            while (p < end) {
+                const char *newline = static_cast<const char *>(std::memchr(p, '\n', end - p));
+                if (!newline && !atEnd) {
+                    carry.append(p, end - p);
+                    break;
+                }
+
+                const char *lineEnd = newline ? newline : end;
+                qsizetype length = lineEnd - p;
+                if (length > 0 && p[length - 1] == '\r') {
+                    --length;
+                }
+
+                if (!lineRuns.add(result.lines++, p, length)) {
+                    return fail(QCoreApplication::translate("WordlistMerger", "Could not write temporary files: %1").arg(lineRuns.error));
+                }
+                p = lineEnd + 1;
+            }
+
+            report(0, readEnd, static_cast<quint64>(readBytes), static_cast<quint64>(totalBytes));
+        }
+    }
+
+    if (!lineRuns.finish()) {
+        return fail(QCoreApplication::translate("WordlistMerger", "Could not write temporary files: %1").arg(lineRuns.error));
+    }
+
+    /* ---------- Merge the runs ---------- */
+
+    QString error;
+    if (!reduceRuns(lineRuns.runs, Order::Line, tempDir.filePath("lines"), isCanceled, &error)) {
+        return isCanceled() ? result : fail(QCoreApplication::translate("WordlistMerger", "Could not merge temporary files: %1").arg(error));
+    }
+
+    QSaveFile out(options.output);
+    if (!out.open(QIODevice::WriteOnly)) {
+        return fail(QCoreApplication::translate("WordlistMerger", "Could not write %1: %2").arg(options.output, out.errorString()));
+    }
+
+    QByteArray outBuffer;
+    bool writeFailed = false;
+    auto writeLine = [&](const QByteArray &line) {
+        outBuffer.append(line);
+        outBuffer.append('\n');
+        if (outBuffer.size() >= ioBufferSize) {
+            writeFailed |= out.write(outBuffer) != outBuffer.size();
+            outBuffer.resize(0);
+        }
+        return !writeFailed;
+    };
+
+    // Only unique lines reach the sinks, so the first merge phase ends a bit short of its share
+    quint64 merged = 0;
+    auto step = [&](int begin, int end, quint64 total) {
+        if ((++merged & 0xFFFF) != 0) {
+            return true;
+        }
+        report(begin, end, merged, total);
+        return !canceled;
+    };
+
+    // The first-seen order needs the unique lines sorted back by their index
+    RunBuilder indexRuns(Order::Index, tempDir.filePath("index"), runBytes, maxPending);
+
+    bool ok = mergeRuns(lineRuns.runs, Order::Line, [&](quint64 index, const QByteArray &line) {
+        ++result.unique;
+        if (options.keepOrder) {
+            if (!indexRuns.add(index, line.constData(), line.size())) {
+                error = indexRuns.error;
+                return false;
+            }
+        } else if (!writeLine(line)) {
+            return false;
+        }
+        return step(readEnd, mergeEnd, result.lines);
+    }, &error);
+
+    for (const QString &run : std::as_const(lineRuns.runs)) {
+        QFile::remove(run);
+    }
+
+    if (ok && options.keepOrder) {
+        ok = indexRuns.finish();
+        if (!ok) {
+            error = indexRuns.error;
+        } else {
+            ok = reduceRuns(indexRuns.runs, Order::Index, tempDir.filePath("index"), isCanceled, &error);
+        }
+
+        if (ok) {
+            merged = 0;
+            ok = mergeRuns(indexRuns.runs, Order::Index, [&](quint64, const QByteArray &line) {
+                return writeLine(line) && step(mergeEnd, 1000, result.unique);
+            }, &error);
+        }
+    }
+
+    if (ok && !outBuffer.isEmpty()) {
+        writeFailed |= out.write(outBuffer) != outBuffer.size();
+    }
+
+    if (isCanceled()) {
+        out.cancelWriting();
+        return result;
+    }
+    if (writeFailed || !ok || !out.commit()) {
+        out.cancelWriting();
+        if (writeFailed || error.isEmpty()) {
+            error = out.errorString();
+        }
+        return fail(QCoreApplication::translate("WordlistMerger", "Could not write %1: %2").arg(options.output, error));
+    }
+
+    progress(1000);
+    return result;
+}
+
+void WordlistMerger::run(QPromise<WordlistMergeResult> &promise, const WordlistMergeOptions &options)
+{
+    promise.setProgressRange(0, 1000);
+
+    const WordlistMergeResult result = merge(options, [&promise](int value) {
+        promise.setProgressValue(value);
+        return !promise.isCanceled();
+    });
+
+    if (!promise.isCanceled()) {
+        promise.addResult(result);
+    }
+}
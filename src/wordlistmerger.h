@@ -0,0 +1,46 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef WORDLISTMERGER_H
+#define WORDLISTMERGER_H
+
+#include <QPromise>
+#include <QString>
+#include <QStringList>
+#include <functional>
+
+struct WordlistMergeOptions {
+    QStringList inputs;
+    QString output;
+    // Upper bound for the lines kept in memory, the rest is spilled to temporary files
+    qint64 memoryLimit = 1024 * 1024 * 1024;
+    // Keep every line at the position it first appeared instead of sorting the output
+    bool keepOrder = false;
+    // Directory for the temporary files, the system default if empty
+    QString tempPath;
+};
+
+struct WordlistMergeResult {
+    quint64 lines = 0;
+    quint64 unique = 0;
+    QString error;
+
+    quint64 duplicates() const { return lines - unique; }
+};
+
+// Merges wordlists into one file without duplicates, using an external merge sort
+class WordlistMerger
+{
+public:
+    // Receives the progress from 0 to 1000, returning false cancels the merge
+    using Progress = std::function<bool(int value)>;
+
+    // The error is empty if the merge was canceled
+    static WordlistMergeResult merge(const WordlistMergeOptions &options, const Progress &progress);
+    // Meant for QtConcurrent::run(), honors cancellation
+    static void run(QPromise<WordlistMergeResult> &promise, const WordlistMergeOptions &options);
+};
+
+#endif // WORDLISTMERGER_H
@@ -0,0 +1,281 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "wordlistmodel.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QLocale>
+
+WordlistModel::WordlistModel(QObject *parent)
+    : FileListModel(parent)
+    , scanner(new WordlistScanner(this))
+{
+    connect(scanner, &WordlistScanner::scanned, this, &WordlistModel::statsScanned);
+}
+
+int WordlistModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : entries.size();
+}
+
+int WordlistModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant WordlistModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= entries.size()) {
+        return QVariant();
+    }
+
+    const Wordlist &w = entries.at(index.row());
+
+    if (index.column() == ColumnPath) {
+        switch (role) {
+        case Qt::DisplayRole:
+        case Qt::EditRole:
+        case Qt::ToolTipRole:
+            return w.path;
+        case Qt::CheckStateRole:
+            return w.checked ? Qt::Checked : Qt::Unchecked;
+        }
+        return QVariant();
+    }
+
+    if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignRight | Qt::AlignVCenter);
+    }
+    if (role != Qt::DisplayRole && role != Qt::ToolTipRole) {
+        return QVariant();
+    }
+
+    const WordlistStats &stats = scanner->stats(w.path);
+    if (stats.size < 0) {
+        return QVariant();
+    }
+
+    QLocale locale;
+
+    switch (index.column()) {
+    case ColumnSize:
+        return locale.formattedDataSize(stats.size);
+    case ColumnLines:
+        return locale.toString(stats.lines);
+    case ColumnUnique:
+        if (role == Qt::ToolTipRole) {
+            return tr("About %1 distinct lines").arg(locale.toString(stats.unique));
+        }
+        return QString("~%1%").arg(stats.uniqueRatio() * 100.0, 0, 'f', 1);
+    case ColumnLength:
+        if (role == Qt::ToolTipRole) {
+            // Length histogram, one line per length that occurs
+            QStringList histogram;
+            for (int length = 0; length < stats.lengths.size(); ++length) {
+                const quint64 count = stats.lengths.at(length);
+                if (count == 0) {
+                    continue;
+                }
+                const QString label = length == WordlistStats::maxLength ? QString("%1+").arg(length) : QString::number(length);
+                histogram << QString("%1: %2 (%3%)").arg(label, locale.toString(count))
+                                 .arg(100.0 * static_cast<double>(count) / static_cast<double>(stats.lines), 0, 'f', 1);
+            }
+            return histogram.join('\n');
+        }
+        return QString::number(stats.averageLength(), 'f', 1);
+    }
+
+    return QVariant();
+}
+
+QVariant WordlistModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return FileListModel::headerData(section, orientation, role);
+    }
+
+    switch (section) {
+    case ColumnPath:
+        return tr("Wordlist");
+    case ColumnSize:
+        return tr("Size");
+    case ColumnLines:
+        return tr("Lines");
+    case ColumnUnique:
+        return tr("Unique");
+    case ColumnLength:
+        return tr("Avg. length");
+    }
+
+    return QVariant();
+}
+
+void WordlistModel::statsScanned()
+{
+    // Rows are not looked up by path, the view only repaints what is visible
+    if (!entries.isEmpty()) {
+        emit dataChanged(index(0, ColumnSize), index(entries.size() - 1, ColumnCount - 1), { Qt::DisplayRole });
+    }
+}
+
+bool WordlistModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (!index.isValid() || role != Qt::CheckStateRole || index.column() != ColumnPath || index.row() >= entries.size()) {
+        return false;
+    }
+
+    Wordlist &w = entries[index.row()];
+    const bool state = value.toInt() == Qt::Checked;
+    if (w.checked != state) {
+        w.checked = state;
+        checkedRows += state ? 1 : -1;
+        emit dataChanged(index, index, { Qt::CheckStateRole });
+    }
+    return true;
+}
+
+Qt::ItemFlags WordlistModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid()) {
+        return Qt::ItemIsDropEnabled;
+    }
+    if (index.column() == ColumnPath) {
+        return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsUserCheckable;
+    }
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
+
+void WordlistModel::addDroppedPaths(const QStringList &paths)
+{
+    QStringList files;
+    for (const QString &path : paths) {
+        if (QFileInfo(path).isDir()) {
+            addDirectory(path);
+        } else {
+            files << path;
+        }
+    }
+
+    addFiles(files);
+}
+
+int WordlistModel::addFiles(const QStringList &files, bool checked)
+{
+    QList<Wordlist> added;
+
+    for (const QString &file : files) {
+        if (file.isEmpty() || paths.contains(file)) {
+            continue;
+        }
+        paths.insert(file);
+        added.append({ file, checked });
+    }
+
+    if (added.isEmpty()) {
+        return 0;
+    }
+
+    // One insert for the whole batch, views and listeners update once
+    beginInsertRows(QModelIndex(), entries.size(), entries.size() + added.size() - 1);
+    entries.append(added);
+    if (checked) {
+        checkedRows += added.size();
+    }
+    endInsertRows();
+
+    QStringList scan;
+    for (const Wordlist &w : std::as_const(added)) {
+        scan << w.path;
+    }
+    scanner->scan(scan);
+
+    return added.size();
+}
+
+int WordlistModel::addDirectory(const QString &directory, bool recursive)
+{
+    QStringList files;
+    QDirIterator it(directory, QDir::Files | QDir::Readable,
+                    recursive ? QDirIterator::Subdirectories | QDirIterator::FollowSymlinks : QDirIterator::NoIteratorFlags);
+
+    while (it.hasNext()) {
+        files << QDir::toNativeSeparators(it.next());
+    }
+
+    // Directory order differs between platforms
+    files.sort();
+    return addFiles(files);
+}
+
+void WordlistModel::removeWordlists(QList<int> rows)
+{
+    removeListRows(entries, std::move(rows), [this](int first, int last) {
+        for (int row = first; row <= last; ++row) {
+            paths.remove(entries.at(row).path);
+            checkedRows -= entries.at(row).checked ? 1 : 0;
+        }
+    });
+}
+
+void WordlistModel::moveWordlist(int row, int delta)
+{
+    moveListRow(entries, row, delta);
+}
+
+void WordlistModel::clear()
+{
+    setWordlists({});
+}
+
+const QList<WordlistModel::Wordlist> &WordlistModel::wordlists() const
+{
+    return entries;
+}
+
+void WordlistModel::setWordlists(const QList<Wordlist> &wordlists)
+{
+    beginResetModel();
+    entries.clear();
+    paths.clear();
+    checkedRows = 0;
+
+    for (const Wordlist &w : wordlists) {
+        if (w.path.isEmpty() || paths.contains(w.path)) {
+            continue;
+        }
+        paths.insert(w.path);
+        entries.append(w);
+        checkedRows += w.checked ? 1 : 0;
+    }
+    endResetModel();
+
+    QStringList scan;
+    for (const Wordlist &w : std::as_const(entries)) {
+        scan << w.path;
+    }
+    scanner->scan(scan);
+}
+
+QStringList WordlistModel::checkedPaths() const
+{
+    QStringList result;
+    if (checkedRows == 0) {
+        return result;
+    }
+
+    result.reserve(checkedRows);
+    for (const Wordlist &w : entries) {
+        if (w.checked) {
+            result << w.path;
+        }
+    }
+    return result;
+}
+
+int WordlistModel::checkedCount() const
+{
+    return checkedRows;
+}
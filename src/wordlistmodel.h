@@ -0,0 +1,68 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef WORDLISTMODEL_H
+#define WORDLISTMODEL_H
+
+#include <QList>
+#include <QSet>
+#include <QStringList>
+#include "attackspec.h"
+#include "listmodel.h"
+#include "wordlistscanner.h"
+
+class WordlistModel : public FileListModel
+{
+    Q_OBJECT
+
+public:
+    enum Column
+    {
+        ColumnPath,
+        ColumnSize,
+        ColumnLines,
+        ColumnUnique,
+        ColumnLength,
+        ColumnCount
+    };
+
+    using Wordlist = AttackSpec::Wordlist;
+
+    explicit WordlistModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+    // Files already in the list are skipped, returns the number of added files
+    int addFiles(const QStringList &files, bool checked = true);
+    int addDirectory(const QString &directory, bool recursive = true);
+    void removeWordlists(QList<int> rows);
+    void moveWordlist(int row, int delta);
+    void clear();
+
+    const QList<Wordlist> &wordlists() const;
+    void setWordlists(const QList<Wordlist> &wordlists);
+    QStringList checkedPaths() const;
+    int checkedCount() const;
+
+protected:
+    // Dropped folders add the files in them
+    void addDroppedPaths(const QStringList &paths) override;
+
+private slots:
+    void statsScanned();
+
+private:
+    WordlistScanner *scanner;
+    QList<Wordlist> entries;
+    QSet<QString> paths;
+    int checkedRows = 0;
+};
+
+#endif // WORDLISTMODEL_H
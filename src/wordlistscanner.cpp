@@ -0,0 +1,257 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#include "wordlistscanner.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtConcurrent>
+
+struct WordlistScanner::ChunkResult {
+    quint64 lines = 0;
+    quint64 totalLength = 0;
+    QVector<quint64> lengths = QVector<quint64>(WordlistStats::maxLength + 1, 0);
+    HyperLogLog distinct;
+    bool failed = false;
+};
+
+double WordlistStats::averageLength() const
+{
+    return lines > 0 ? static_cast<double>(totalLength) / static_cast<double>(lines) : 0.0;
+}
+
+double WordlistStats::uniqueRatio() const
+{
+    return lines > 0 ? qMin(1.0, static_cast<double>(unique) / static_cast<double>(lines)) : 0.0;
+}
+
+WordlistScanner::WordlistScanner(QObject *parent)
+    : QObject(parent)
+    , watcher(new QFutureWatcher<ChunkResult>(this))
+{
+    connect(watcher, &QFutureWatcher<ChunkResult>::finished, this, &WordlistScanner::fileFinished);
+    load();
+}
+
+WordlistScanner::~WordlistScanner()
+{
+    cancel();
+    watcher->waitForFinished();
+    save();
+}
+
+void WordlistScanner::scan(const QStringList &files)
+{
+    for (const QString &file : files) {
+        if (!pending.contains(file) && file != currentFile) {
+            pending << file;
+        }
+    }
+
+    if (!watcher->isRunning()) {
+        QMetaObject::invokeMethod(this, &WordlistScanner::scanNext, Qt::QueuedConnection);
+    }
+}
+
+void WordlistScanner::cancel()
+{
+    pending.clear();
+    watcher->cancel();
+}
+
+bool WordlistScanner::isScanning() const
+{
+    return watcher->isRunning() || !pending.isEmpty();
+}
+
+const WordlistStats &WordlistScanner::stats(const QString &file) const
+{
+    static const WordlistStats unscanned;
+    const auto it = cache.constFind(file);
+    return it != cache.constEnd() ? it.value() : unscanned;
+}
+
+void WordlistScanner::scanNext()
+{
+    while (!watcher->isRunning() && !pending.isEmpty()) {
+        const QString file = pending.takeFirst();
+        const QFileInfo info(file);
+
+        if (!info.isFile()) {
+            emit failed(file);
+            continue;
+        }
+
+        // Unchanged files are not scanned again
+        const qint64 lastModified = info.lastModified().toMSecsSinceEpoch();
+        auto it = cache.constFind(file);
+        if (it != cache.constEnd() && it->size == info.size() && it->lastModified == lastModified) {
+            emit scanned(file, *it);
+            continue;
+        }
+
+        currentFile = file;
+        currentSize = info.size();
+        currentLastModified = lastModified;
+
+        // Every worker scans one chunk, lines belong to the chunk they start in
+        const QList<FileChunks::Chunk> chunks = FileChunks::split(file, currentSize);
+        watcher->setFuture(QtConcurrent::mappedReduced<ChunkResult>(chunks, &WordlistScanner::scanChunk, &WordlistScanner::mergeChunk,
+                                                                     QtConcurrent::UnorderedReduce));
+    }
+
+    if (!watcher->isRunning() && cacheDirty) {
+        save();
+    }
+}
+
+void WordlistScanner::fileFinished()
+{
+    const QString file = currentFile;
+    currentFile.clear();
+
+    if (watcher->isCanceled()) {
+        scanNext();
+        return;
+    }
+
+    const ChunkResult result = watcher->result();
+    if (result.failed) {
+        emit failed(file);
+    } else {
+        WordlistStats s;
+        s.size = currentSize;
+        s.lastModified = currentLastModified;
+        s.lines = result.lines;
+        s.unique = qMin<quint64>(result.distinct.estimate(), result.lines);
+        s.totalLength = result.totalLength;
+        s.lengths = result.lengths;
+
+        cache.insert(file, s);
+        cacheDirty = true;
+        emit scanned(file, s);
+    }
+
+    scanNext();
+}
+
+WordlistScanner::ChunkResult WordlistScanner::scanChunk(const FileChunks::Chunk &chunk)
+{
+    ChunkResult result;
+
+    result.failed = !FileChunks::forEachLine(chunk, [&result](const char *line, qsizetype length) {
+        ++result.lines;
+        result.totalLength += length;
+        ++result.lengths[qMin<qsizetype>(length, WordlistStats::maxLength)];
+        result.distinct.add(HyperLogLog::hash(line, length));
+    });
+
+    return result;
+}
+
+void WordlistScanner::mergeChunk(ChunkResult &result, const ChunkResult &chunk)
+{
+    result.failed |= chunk.failed;
+    result.lines += chunk.lines;
+    result.totalLength += chunk.totalLength;
+
+    for (int i = 0; i < result.lengths.size(); ++i) {
+        result.lengths[i] += chunk.lengths.at(i);
+    }
+
+    result.distinct.merge(chunk.distinct);
+}
+
+// Path to the persisted stats JSON
+QString WordlistScanner::cacheFile()
+{
+    const QString dirPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dirPath);
+    return QDir(dirPath).filePath("wordlist_stats.json");
+}
+
+void WordlistScanner::load()
+{
+    QFile f(cacheFile());
+    if (!f.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QJsonDocument doc = QJsonDocument::fromJson(f.readAll());
+    if (!doc.isObject()) {
+        return;
+    }
+
+    const QJsonObject files = doc.object().value("files").toObject();
+    for (auto it = files.constBegin(); it != files.constEnd(); ++it) {
+        const QJsonObject obj = it.value().toObject();
+        WordlistStats s;
+        s.size = obj.value("size").toInteger(-1);
+        s.lastModified = obj.value("lastModified").toInteger();
+        s.lines = obj.value("lines").toInteger();
+        s.unique = obj.value("unique").toInteger();
+        s.totalLength = obj.value("totalLength").toInteger();
+
+        const QJsonArray lengths = obj.value("lengths").toArray();
+        for (const QJsonValue &v : lengths) {
+            s.lengths << static_cast<quint64>(v.toInteger());
+        }
+        s.lengths.resize(WordlistStats::maxLength + 1);
+
+        cache.insert(it.key(), s);
+    }
+}
+
+void WordlistScanner::save()
+{
+    if (!cacheDirty) {
+        return;
+    }
+
+    QJsonObject files;
+    for (auto it = cache.constBegin(); it != cache.constEnd(); ++it) {
+        const WordlistStats &s = it.value();
+
+        // Stats of files that are gone are not worth keeping
+        if (!QFileInfo::exists(it.key())) {
+            continue;
+        }
+
+        QJsonArray lengths;
+        for (quint64 count : s.lengths) {
+            lengths.append(static_cast<qint64>(count));
+        }
+
+        QJsonObject obj;
+        obj["size"] = s.size;
+        obj["lastModified"] = s.lastModified;
+        obj["lines"] = static_cast<qint64>(s.lines);
+        obj["unique"] = static_cast<qint64>(s.unique);
+        obj["totalLength"] = static_cast<qint64>(s.totalLength);
+        obj["lengths"] = lengths;
+        files[it.key()] = obj;
+    }
+
+    QJsonObject root;
+    root["files"] = files;
+
+    QSaveFile f(cacheFile());
+    if (!f.open(QIODevice::WriteOnly)) {
+        qWarning("Could not write wordlist stats to %s", qPrintable(f.fileName()));
+        return;
+    }
+    f.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    // Stays dirty if the write failed, the next save tries again
+    if (!f.commit()) {
+        qWarning("Could not write wordlist stats to %s", qPrintable(f.fileName()));
+        return;
+    }
+    cacheDirty = false;
+}
@@ -0,0 +1,80 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: Rainer Größlinger
+ */
+
+#ifndef WORDLISTSCANNER_H
+#define WORDLISTSCANNER_H
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QList>
+#include <QStringList>
+#include <QVector>
+#include "filechunks.h"
+#include "hyperloglog.h"
+
+struct WordlistStats {
+    // Fingerprint of the scanned file
+    qint64 size = -1;
+    qint64 lastModified = 0;
+
+    quint64 lines = 0;
+    // HyperLogLog estimate of the distinct lines
+    quint64 unique = 0;
+    quint64 totalLength = 0;
+    // Lines per length, the last bucket holds all longer lines
+    QVector<quint64> lengths;
+
+    static constexpr int maxLength = 64;
+
+    double averageLength() const;
+    double uniqueRatio() const;
+};
+
+// Counts lines, distinct lines and line lengths of wordlists on all cores
+class WordlistScanner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit WordlistScanner(QObject *parent = nullptr);
+    ~WordlistScanner();
+
+    // Files with up-to-date cached stats are reported without scanning them again
+    void scan(const QStringList &files);
+    void cancel();
+    bool isScanning() const;
+
+    // Cached stats, size is -1 if the file was not scanned yet. Valid until the next scan finishes.
+    const WordlistStats &stats(const QString &file) const;
+
+signals:
+    void scanned(const QString &file, const WordlistStats &stats);
+    void failed(const QString &file);
+
+private slots:
+    void fileFinished();
+
+private:
+    struct ChunkResult;
+
+    QHash<QString, WordlistStats> cache;
+    QStringList pending;
+    QString currentFile;
+    qint64 currentSize = 0;
+    qint64 currentLastModified = 0;
+    QFutureWatcher<ChunkResult> *watcher;
+    bool cacheDirty = false;
+
+    void scanNext();
+    static ChunkResult scanChunk(const FileChunks::Chunk &chunk);
+    static void mergeChunk(ChunkResult &result, const ChunkResult &chunk);
+
+    static QString cacheFile();
+    void load();
+    void save();
+};
+
+#endif // WORDLISTSCANNER_H